@@ -0,0 +1,497 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "BatchCoordinator.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+
+namespace
+{
+// A hello is far shorter. A peer that has not sent one gets no more buffer than this.
+const qint64 k_MaxUnauthenticatedLineLength = 16 * 1024;
+
+// -----------------------------------------------------------------------------
+// Takes as long for every token of the same length, so that the time of a rejection
+// does not tell how much of a guess was right
+// -----------------------------------------------------------------------------
+bool tokensMatch(const QString& expected, const QString& received)
+{
+  QByteArray expectedBytes = expected.toUtf8();
+  QByteArray receivedBytes = received.toUtf8();
+  if(expectedBytes.size() != receivedBytes.size())
+  {
+    return false;
+  }
+
+  char difference = 0;
+  for(int i = 0; i < expectedBytes.size(); i++)
+  {
+    difference |= expectedBytes[i] ^ receivedBytes[i];
+  }
+  return difference == 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QByteArray toLine(const QJsonObject& message)
+{
+  return QJsonDocument(message).toJson(QJsonDocument::Compact) + "\n";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject typedMessage(const QString& type)
+{
+  QJsonObject message;
+  message["type"] = type;
+  return message;
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+BatchCoordinator::BatchCoordinator(QObject* parent)
+: QObject(parent)
+{
+  connect(&m_Server, &QTcpServer::newConnection, this, &BatchCoordinator::acceptConnections);
+  connect(&m_CheckTimer, &QTimer::timeout, this, &BatchCoordinator::checkWorkers);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+BatchCoordinator::~BatchCoordinator()
+{
+  m_Server.close();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchCoordinator::setJobs(const QVector<QJsonObject>& jobs)
+{
+  m_Jobs.clear();
+  m_Queue.clear();
+  m_FinishedCount = 0;
+  m_FailedCount = 0;
+  for(const QJsonObject& request : jobs)
+  {
+    Job job;
+    job.path = request["path"].toString();
+    job.overrides = request["overrides"].toObject();
+    m_Queue.push_back(m_Jobs.size());
+    m_Jobs.push_back(job);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchCoordinator::setHeartbeatTimeout(int timeoutMs)
+{
+  m_HeartbeatTimeout = qMax(1000, timeoutMs);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int BatchCoordinator::getHeartbeatTimeout() const
+{
+  return m_HeartbeatTimeout;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchCoordinator::setMaxAttempts(int maxAttempts)
+{
+  m_MaxAttempts = qMax(1, maxAttempts);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int BatchCoordinator::getMaxAttempts() const
+{
+  return m_MaxAttempts;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchCoordinator::setToken(const QString& token)
+{
+  m_Token = token;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool BatchCoordinator::listen(const QHostAddress& address, quint16 port)
+{
+  if(!m_Server.listen(address, port))
+  {
+    return false;
+  }
+  m_CheckTimer.start(qMax(500, m_HeartbeatTimeout / 6));
+
+  // An empty batch is finished right away
+  QTimer::singleShot(0, this, [this] { checkFinished(); });
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+quint16 BatchCoordinator::getPort() const
+{
+  return m_Server.serverPort();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString BatchCoordinator::getErrorString() const
+{
+  return m_Server.errorString();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchCoordinator::acceptConnections()
+{
+  while(m_Server.hasPendingConnections())
+  {
+    QTcpSocket* socket = m_Server.nextPendingConnection();
+    quint64 workerId = m_NextWorkerId++;
+
+    WorkerConnection worker;
+    worker.socket = socket;
+    worker.host = socket->peerAddress().toString();
+    worker.lastHeard.start();
+    m_Workers.insert(workerId, worker);
+
+    connect(socket, &QTcpSocket::readyRead, this, [this, workerId] { readWorker(workerId); });
+    connect(socket, &QTcpSocket::disconnected, this, [this, workerId] { dropWorker(workerId, "disconnected"); });
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchCoordinator::readWorker(quint64 workerId)
+{
+  if(!m_Workers.contains(workerId))
+  {
+    return;
+  }
+  QTcpSocket* socket = m_Workers[workerId].socket;
+  if(socket == nullptr)
+  {
+    return;
+  }
+  m_Workers[workerId].lastHeard.restart();
+
+  if(!m_Workers[workerId].authenticated && !socket->canReadLine() && socket->bytesAvailable() > k_MaxUnauthenticatedLineLength)
+  {
+    qDebug().noquote() << "Rejected" << m_Workers[workerId].host << "because it sent too much before the token";
+    dropWorker(workerId, "was rejected");
+    return;
+  }
+
+  while(socket->canReadLine())
+  {
+    QJsonObject message = QJsonDocument::fromJson(socket->readLine()).object();
+    QString type = message["type"].toString();
+    if(!m_Workers[workerId].authenticated)
+    {
+      // Nothing but a hello with the token is accepted from a worker that has not sent one
+      if(type != "hello" || !tokensMatch(m_Token, message["token"].toString()))
+      {
+        qDebug().noquote() << "Rejected" << m_Workers[workerId].host << "because it did not send the token";
+        dropWorker(workerId, "was rejected");
+        return;
+      }
+      m_Workers[workerId].authenticated = true;
+      m_Workers[workerId].host = message["host"].toString(m_Workers[workerId].host);
+      qDebug().noquote() << "Worker" << m_Workers[workerId].host << "joined with" << message["slots"].toInt() << "slot(s)";
+    }
+    else if(type == "hello")
+    {
+      m_Workers[workerId].host = message["host"].toString(m_Workers[workerId].host);
+      qDebug().noquote() << "Worker" << m_Workers[workerId].host << "joined with" << message["slots"].toInt() << "slot(s)";
+    }
+    else if(type == "request")
+    {
+      assignJob(workerId);
+    }
+    else if(type == "message")
+    {
+      int jobId = message["id"].toInt(-1);
+      if(jobId >= 0 && jobId < m_Jobs.size() && message["level"].toString() == "progress")
+      {
+        m_Jobs[jobId].progress = message["progress"].toInt();
+      }
+    }
+    else if(type == "result")
+    {
+      finishJob(workerId, message);
+    }
+
+    // The worker may have been dropped while its messages were handled
+    if(!m_Workers.contains(workerId))
+    {
+      return;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchCoordinator::assignJob(quint64 workerId)
+{
+  if(m_Queue.isEmpty())
+  {
+    // Jobs that are still running elsewhere may come back if their worker is lost
+    QJsonObject message = typedMessage(m_FinishedCount == m_Jobs.size() ? "done" : "wait");
+    message["retryMs"] = qMax(500, m_HeartbeatTimeout / 6);
+    send(workerId, message);
+    return;
+  }
+
+  int jobId = m_Queue.takeFirst();
+  Job& job = m_Jobs[jobId];
+  job.attempts++;
+  job.workerId = workerId;
+  job.progress = 0;
+  m_Workers[workerId].jobs.insert(jobId);
+
+  QJsonObject message = typedMessage("job");
+  message["id"] = jobId;
+  message["path"] = job.path;
+  message["overrides"] = job.overrides;
+  send(workerId, message);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchCoordinator::finishJob(quint64 workerId, const QJsonObject& message)
+{
+  int jobId = message["id"].toInt(-1);
+  if(jobId < 0 || jobId >= m_Jobs.size())
+  {
+    return;
+  }
+  m_Workers[workerId].jobs.remove(jobId);
+
+  // A result from a worker that was given up on and has come back is stale
+  Job& job = m_Jobs[jobId];
+  if(job.finished || job.workerId != workerId)
+  {
+    return;
+  }
+
+  job.finished = true;
+  m_FinishedCount++;
+  int errorCode = message["errorCode"].toInt();
+  QString status = (errorCode < 0) ? QString("FAILED (%1)").arg(errorCode) : QString("OK");
+  qDebug().noquote() << QString("[%1/%2] %3 on %4: %5 in %6 ms")
+                            .arg(m_FinishedCount)
+                            .arg(m_Jobs.size())
+                            .arg(QDir::toNativeSeparators(job.path))
+                            .arg(m_Workers[workerId].host)
+                            .arg(status)
+                            .arg(message["elapsedMs"].toInt());
+  if(errorCode < 0)
+  {
+    m_FailedCount++;
+    foreach(QJsonValue error, message["errors"].toArray())
+    {
+      qDebug().noquote() << "    " << error.toString();
+    }
+  }
+  foreach(QJsonValue output, message["outputs"].toArray())
+  {
+    qDebug().noquote() << "    ->" << QDir::toNativeSeparators(output.toString());
+  }
+
+  checkFinished();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchCoordinator::dropWorker(quint64 workerId, const QString& reason)
+{
+  if(!m_Workers.contains(workerId))
+  {
+    return;
+  }
+  WorkerConnection worker = m_Workers.take(workerId);
+
+  // Lost jobs go to the front of the queue so that they are not starved by the rest of the batch
+  foreach(int jobId, worker.jobs)
+  {
+    Job& job = m_Jobs[jobId];
+    if(job.finished || job.workerId != workerId)
+    {
+      continue;
+    }
+    job.workerId = 0;
+    if(job.attempts >= m_MaxAttempts)
+    {
+      failJob(jobId, QString("Lost the worker %1 times").arg(job.attempts));
+    }
+    else
+    {
+      qDebug().noquote() << "Requeued" << QDir::toNativeSeparators(job.path) << "after" << worker.host << reason;
+      m_Queue.push_front(jobId);
+    }
+  }
+
+  if(worker.socket != nullptr)
+  {
+    worker.socket->disconnect(this);
+    worker.socket->abort();
+    worker.socket->deleteLater();
+  }
+  checkFinished();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchCoordinator::failJob(int jobId, const QString& error)
+{
+  Job& job = m_Jobs[jobId];
+  job.finished = true;
+  m_FinishedCount++;
+  m_FailedCount++;
+  qDebug().noquote() << QString("[%1/%2] %3: FAILED").arg(m_FinishedCount).arg(m_Jobs.size()).arg(QDir::toNativeSeparators(job.path));
+  qDebug().noquote() << "    " << error;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchCoordinator::checkWorkers()
+{
+  QList<quint64> silentWorkers;
+  for(QMap<quint64, WorkerConnection>::const_iterator iter = m_Workers.constBegin(); iter != m_Workers.constEnd(); ++iter)
+  {
+    if(iter.value().lastHeard.hasExpired(m_HeartbeatTimeout))
+    {
+      silentWorkers.push_back(iter.key());
+    }
+  }
+  foreach(quint64 workerId, silentWorkers)
+  {
+    dropWorker(workerId, QString("missed its heartbeat"));
+  }
+
+  if(m_FinishedCount == m_Jobs.size())
+  {
+    return;
+  }
+
+  QStringList running;
+  for(const Job& job : m_Jobs)
+  {
+    if(!job.finished && job.workerId != 0)
+    {
+      running.push_back(QString("%1 %2%").arg(QFileInfo(job.path).fileName()).arg(job.progress));
+    }
+  }
+  QString status = QString("%1 queued, %2 running, %3 of %4 finished, %5 worker(s)")
+                       .arg(m_Queue.size())
+                       .arg(running.size())
+                       .arg(m_FinishedCount)
+                       .arg(m_Jobs.size())
+                       .arg(m_Workers.size());
+  if(!running.isEmpty())
+  {
+    status += ": " + running.join(", ");
+  }
+  if(status != m_LastStatus)
+  {
+    qDebug().noquote() << status;
+    m_LastStatus = status;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchCoordinator::checkFinished()
+{
+  if(m_FinishedCount < m_Jobs.size() || !m_CheckTimer.isActive())
+  {
+    return;
+  }
+  m_CheckTimer.stop();
+
+  for(QMap<quint64, WorkerConnection>::const_iterator iter = m_Workers.constBegin(); iter != m_Workers.constEnd(); ++iter)
+  {
+    send(iter.key(), typedMessage("done"));
+    if(iter.value().socket != nullptr)
+    {
+      iter.value().socket->flush();
+    }
+  }
+
+  qDebug().noquote() << QString("%1 of %2 pipelines failed").arg(m_FailedCount).arg(m_Jobs.size());
+  emit finished((m_FailedCount > 0) ? 1 : 0);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchCoordinator::send(quint64 workerId, const QJsonObject& message)
+{
+  if(m_Workers.contains(workerId) && m_Workers[workerId].socket != nullptr)
+  {
+    m_Workers[workerId].socket->write(toLine(message));
+  }
+}
@@ -0,0 +1,226 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonObject>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+/**
+ * @brief The BatchCoordinator class hands the pipeline files of a batch to BatchWorker
+ * processes that connect over TCP, possibly from other hosts. The files and their outputs
+ * must be on storage that every host sees under the same path.
+ *
+ * Every message is one line of compact JSON. A worker says "hello" with its host name and the
+ * shared token (setToken()); a worker whose first message is not a hello with the right token
+ * is disconnected before it is given a job or can report a result. It then sends a "request" whenever it has a free slot. The coordinator answers with a "job"
+ * (id, path, overrides), a "wait" while the remaining jobs are running elsewhere, or "done"
+ * once the batch is finished. The worker sends "message" lines with the progress of a job,
+ * a "heartbeat" every few seconds and a "result" with the error code, the time spent, the
+ * errors and the files the job wrote.
+ *
+ * The jobs of a worker that disconnects or stays silent for getHeartbeatTimeout() ms are
+ * queued again, at most getMaxAttempts() times per job.
+ */
+class BatchCoordinator : public QObject
+{
+  Q_OBJECT
+
+public:
+  BatchCoordinator(QObject* parent = nullptr);
+  ~BatchCoordinator() override;
+
+  /**
+   * @brief setJobs Sets the batch. Each job has a "path" and optional "overrides".
+   * @param jobs
+   */
+  void setJobs(const QVector<QJsonObject>& jobs);
+
+  /**
+   * @brief setHeartbeatTimeout Sets after how many ms of silence a worker counts as lost
+   * @param timeoutMs
+   */
+  void setHeartbeatTimeout(int timeoutMs);
+
+  /**
+   * @brief getHeartbeatTimeout
+   * @return
+   */
+  int getHeartbeatTimeout() const;
+
+  /**
+   * @brief setMaxAttempts Sets how often a job is handed out before it counts as failed
+   * because its workers were lost
+   * @param maxAttempts
+   */
+  void setMaxAttempts(int maxAttempts);
+
+  /**
+   * @brief getMaxAttempts
+   * @return
+   */
+  int getMaxAttempts() const;
+
+  /**
+   * @brief setToken Sets the secret that every worker must send in its hello
+   * @param token
+   */
+  void setToken(const QString& token);
+
+  /**
+   * @brief listen Starts accepting workers
+   * @param address
+   * @param port 0 picks a free port, see getPort()
+   * @return
+   */
+  bool listen(const QHostAddress& address, quint16 port);
+
+  /**
+   * @brief getPort Returns the port the coordinator listens on
+   * @return
+   */
+  quint16 getPort() const;
+
+  /**
+   * @brief getErrorString Returns why listen() failed
+   * @return
+   */
+  QString getErrorString() const;
+
+signals:
+  /**
+   * @brief finished Emitted once every job has a result
+   * @param exitCode 0 if every job succeeded and 1 otherwise
+   */
+  void finished(int exitCode);
+
+private slots:
+  void acceptConnections();
+  void checkWorkers();
+
+private:
+  struct Job
+  {
+    QString path;
+    QJsonObject overrides;
+    int attempts = 0;
+    quint64 workerId = 0;
+    int progress = 0;
+    bool finished = false;
+  };
+
+  struct WorkerConnection
+  {
+    QPointer<QTcpSocket> socket;
+    QString host;
+    bool authenticated = false;
+    QElapsedTimer lastHeard;
+    QSet<int> jobs;
+  };
+
+  QTcpServer m_Server;
+  QTimer m_CheckTimer;
+  QVector<Job> m_Jobs;
+  QList<int> m_Queue;
+  QMap<quint64, WorkerConnection> m_Workers;
+  quint64 m_NextWorkerId = 1;
+  QString m_Token;
+  int m_HeartbeatTimeout = 30000;
+  int m_MaxAttempts = 3;
+  int m_FinishedCount = 0;
+  int m_FailedCount = 0;
+  QString m_LastStatus;
+
+  /**
+   * @brief readWorker Handles the complete lines the worker has sent
+   * @param workerId
+   */
+  void readWorker(quint64 workerId);
+
+  /**
+   * @brief assignJob Answers a request of the worker
+   * @param workerId
+   */
+  void assignJob(quint64 workerId);
+
+  /**
+   * @brief finishJob Records the result a worker sent
+   * @param workerId
+   * @param message
+   */
+  void finishJob(quint64 workerId, const QJsonObject& message);
+
+  /**
+   * @brief dropWorker Disconnects the worker and queues its jobs again
+   * @param workerId
+   * @param reason
+   */
+  void dropWorker(quint64 workerId, const QString& reason);
+
+  /**
+   * @brief failJob Records a job that did not produce a result
+   * @param jobId
+   * @param error
+   */
+  void failJob(int jobId, const QString& error);
+
+  /**
+   * @brief checkFinished Tells the workers and emits finished() once every job has a result
+   */
+  void checkFinished();
+
+  /**
+   * @brief send
+   * @param workerId
+   * @param message
+   */
+  void send(quint64 workerId, const QJsonObject& message);
+
+  BatchCoordinator(const BatchCoordinator&) = delete; // Copy Constructor Not Implemented
+  void operator=(const BatchCoordinator&) = delete;   // Move assignment Not Implemented
+};
@@ -0,0 +1,299 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "BatchWorker.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+
+#include <QtNetwork/QHostInfo>
+
+#include "SIMPLib/Messages/PipelineMessage.h"
+
+#include "SIMPLView/HeadlessPipelineRunner.h"
+#include "SIMPLView/PipelineDaemon.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QByteArray toLine(const QJsonObject& message)
+{
+  return QJsonDocument(message).toJson(QJsonDocument::Compact) + "\n";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject typedMessage(const QString& type)
+{
+  QJsonObject message;
+  message["type"] = type;
+  return message;
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+BatchWorker::BatchWorker(QObject* parent)
+: QObject(parent)
+{
+  m_Pool.setMaxThreadCount(1);
+  m_HeartbeatTimer.setInterval(5000);
+
+  connect(&m_Socket, &QTcpSocket::readyRead, this, &BatchWorker::readCoordinator);
+  connect(&m_Socket, &QTcpSocket::disconnected, this, [this] {
+    m_HeartbeatTimer.stop();
+    if(!m_Done)
+    {
+      qDebug().noquote() << "Lost the connection to the coordinator";
+      emit finished(2);
+    }
+  });
+  connect(&m_HeartbeatTimer, &QTimer::timeout, this, [this] { sendMessage(typedMessage("heartbeat")); });
+  connect(this, &BatchWorker::jobMessage, this, &BatchWorker::sendMessage, Qt::QueuedConnection);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+BatchWorker::~BatchWorker()
+{
+  m_Pool.waitForDone();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchWorker::setSlots(int slotCount)
+{
+  m_Pool.setMaxThreadCount(qMax(1, slotCount));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int BatchWorker::getSlots() const
+{
+  return m_Pool.maxThreadCount();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchWorker::setHeartbeatInterval(int intervalMs)
+{
+  m_HeartbeatTimer.setInterval(qMax(100, intervalMs));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchWorker::setToken(const QString& token)
+{
+  m_Token = token;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool BatchWorker::connectToCoordinator(const QString& host, quint16 port)
+{
+  m_Socket.connectToHost(host, port);
+  if(!m_Socket.waitForConnected(5000))
+  {
+    return false;
+  }
+
+  QJsonObject hello = typedMessage("hello");
+  hello["host"] = QString("%1:%2").arg(QHostInfo::localHostName()).arg(QCoreApplication::applicationPid());
+  hello["slots"] = getSlots();
+  hello["token"] = m_Token;
+  sendMessage(hello);
+  for(int i = 0; i < getSlots(); i++)
+  {
+    requestJob();
+  }
+  m_HeartbeatTimer.start();
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString BatchWorker::getErrorString() const
+{
+  return m_Socket.errorString();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchWorker::requestJob()
+{
+  if(!m_Done)
+  {
+    sendMessage(typedMessage("request"));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchWorker::readCoordinator()
+{
+  while(m_Socket.canReadLine())
+  {
+    QJsonObject message = QJsonDocument::fromJson(m_Socket.readLine()).object();
+    QString type = message["type"].toString();
+    if(type == "job")
+    {
+      startJob(message);
+    }
+    else if(type == "wait")
+    {
+      // Nothing is queued right now, but a job of a lost worker may come back
+      QTimer::singleShot(message["retryMs"].toInt(1000), this, &BatchWorker::requestJob);
+    }
+    else if(type == "done" && !m_Done)
+    {
+      m_Done = true;
+      if(m_RunningJobs == 0)
+      {
+        m_Socket.disconnectFromHost();
+        emit finished(0);
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchWorker::startJob(const QJsonObject& job)
+{
+  QJsonValue id = job["id"];
+  QString filePath = job["path"].toString();
+  QJsonObject overrides = job["overrides"].toObject();
+  m_RunningJobs++;
+  qDebug().noquote() << "Running" << QDir::toNativeSeparators(filePath);
+
+  QtConcurrent::run(&m_Pool, [this, id, filePath, overrides] {
+    HeadlessPipelineRunner::Result result = HeadlessPipelineRunner::RunPipeline(filePath, overrides, [this, id](const PipelineMessage& pm) {
+      QJsonObject message = PipelineDaemon::MessageToJson(pm);
+      if(message["level"].toString() != "output")
+      {
+        message["id"] = id;
+        emit jobMessage(message);
+      }
+    });
+
+    QJsonObject message = typedMessage("result");
+    message["id"] = id;
+    message["errorCode"] = result.errorCode;
+    message["elapsedMs"] = result.elapsedMs;
+    message["errors"] = QJsonArray::fromStringList(result.errors);
+    message["outputs"] = QJsonArray::fromStringList(CollectOutputPaths(filePath, overrides));
+    emit jobMessage(message);
+  });
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BatchWorker::sendMessage(const QJsonObject& message)
+{
+  m_Socket.write(toLine(message));
+
+  if(message["type"].toString() != "result")
+  {
+    return;
+  }
+
+  // The slot of the job is free again
+  m_RunningJobs--;
+  if(!m_Done)
+  {
+    requestJob();
+  }
+  else if(m_RunningJobs == 0)
+  {
+    m_Socket.disconnectFromHost();
+    emit finished(0);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList BatchWorker::CollectOutputPaths(const QString& filePath, const QJsonObject& overrides)
+{
+  QStringList outputs;
+  if(QFileInfo(filePath).suffix().compare("json", Qt::CaseInsensitive) != 0)
+  {
+    return outputs;
+  }
+
+  QFile file(filePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return outputs;
+  }
+  QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+  HeadlessPipelineRunner::ApplyOverrides(root, overrides);
+
+  for(QJsonObject::const_iterator filter = root.constBegin(); filter != root.constEnd(); ++filter)
+  {
+    QJsonObject parameters = filter.value().toObject();
+    for(QJsonObject::const_iterator param = parameters.constBegin(); param != parameters.constEnd(); ++param)
+    {
+      QString path = param.value().toString();
+      if(param.key().contains("Output") && !path.isEmpty() && QFileInfo(path).isFile() && !outputs.contains(path))
+      {
+        outputs.push_back(path);
+      }
+    }
+  }
+  return outputs;
+}
@@ -0,0 +1,144 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+
+#include <QtNetwork/QTcpSocket>
+
+/**
+ * @brief The BatchWorker class connects to a BatchCoordinator and executes the jobs it hands
+ * out, getSlots() at a time. It asks for the next job as soon as a slot is free, so fast hosts
+ * take more of the batch than slow ones. See BatchCoordinator for the protocol. The jobs run on
+ * threads, so they execute one at a time unless HeadlessPipelineRunner::IsHdf5ThreadSafe().
+ *
+ * The plugins must have been loaded already.
+ */
+class BatchWorker : public QObject
+{
+  Q_OBJECT
+
+public:
+  BatchWorker(QObject* parent = nullptr);
+  ~BatchWorker() override;
+
+  /**
+   * @brief setSlots Sets how many jobs may run at the same time
+   * @param slotCount
+   */
+  void setSlots(int slotCount);
+
+  /**
+   * @brief getSlots
+   * @return
+   */
+  int getSlots() const;
+
+  /**
+   * @brief setHeartbeatInterval Sets how often the worker tells the coordinator it is alive
+   * @param intervalMs
+   */
+  void setHeartbeatInterval(int intervalMs);
+
+  /**
+   * @brief setToken Sets the secret the coordinator expects in the hello
+   * @param token
+   */
+  void setToken(const QString& token);
+
+  /**
+   * @brief connectToCoordinator Connects, says hello and asks for the first jobs
+   * @param host
+   * @param port
+   * @return False if the coordinator could not be reached
+   */
+  bool connectToCoordinator(const QString& host, quint16 port);
+
+  /**
+   * @brief getErrorString Returns why connectToCoordinator() failed
+   * @return
+   */
+  QString getErrorString() const;
+
+  /**
+   * @brief CollectOutputPaths Returns the files a .json pipeline writes that exist, found
+   * through the parameters whose name contains "Output"
+   * @param filePath
+   * @param overrides See HeadlessPipelineRunner::ApplyOverrides()
+   * @return
+   */
+  static QStringList CollectOutputPaths(const QString& filePath, const QJsonObject& overrides);
+
+signals:
+  /**
+   * @brief jobMessage Emitted from the pool's threads with a message for the coordinator
+   * @param message
+   */
+  void jobMessage(const QJsonObject& message);
+
+  /**
+   * @brief finished Emitted once the batch is done or the coordinator is gone
+   * @param exitCode 0 if the coordinator said the batch is done and 2 otherwise
+   */
+  void finished(int exitCode);
+
+private slots:
+  void readCoordinator();
+  void sendMessage(const QJsonObject& message);
+  void requestJob();
+
+private:
+  QTcpSocket m_Socket;
+  QString m_Token;
+  QThreadPool m_Pool;
+  QTimer m_HeartbeatTimer;
+  int m_RunningJobs = 0;
+  bool m_Done = false;
+
+  /**
+   * @brief startJob Runs a job the coordinator handed out on the pool
+   * @param job
+   */
+  void startJob(const QJsonObject& job);
+
+  BatchWorker(const BatchWorker&) = delete;      // Copy Constructor Not Implemented
+  void operator=(const BatchWorker&) = delete;   // Move assignment Not Implemented
+};
@@ -0,0 +1,229 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "DeferredTaskScheduler.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <QtCore/QTimer>
+
+#include "SIMPLView/StartupTrace.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 traceTime()
+{
+  return StartupTrace::IsEnabled() ? StartupTrace::Instance()->getElapsedMicroseconds() : 0;
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DeferredTaskScheduler::DeferredTaskScheduler(QObject* parent)
+: QObject(parent)
+{
+  connect(&m_BackgroundWatcher, &QFutureWatcher<void>::finished, this, &DeferredTaskScheduler::finishBackgroundTask);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DeferredTaskScheduler::~DeferredTaskScheduler()
+{
+  // A background part may still be reading something the main thread owns
+  m_BackgroundWatcher.waitForFinished();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DeferredTaskScheduler::addTask(const QString& name, Priority priority, const TaskFunction& task)
+{
+  addTask(name, priority, TaskFunction(), task);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DeferredTaskScheduler::addTask(const QString& name, Priority priority, const TaskFunction& backgroundTask, const TaskFunction& mainThreadTask)
+{
+  Task task;
+  task.name = name;
+  task.priority = priority;
+  task.backgroundTask = backgroundTask;
+  task.mainThreadTask = mainThreadTask;
+  task.queuedUs = traceTime();
+  m_Tasks.push_back(task);
+
+  scheduleNextTask();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DeferredTaskScheduler::start()
+{
+  if(m_Started)
+  {
+    return;
+  }
+  m_Started = true;
+
+  // The wait of a task is measured from the start, not from when it was added
+  qint64 now = traceTime();
+  for(Task& task : m_Tasks)
+  {
+    task.queuedUs = now;
+  }
+
+  scheduleNextTask();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool DeferredTaskScheduler::isStarted() const
+{
+  return m_Started;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool DeferredTaskScheduler::hasPendingTasks() const
+{
+  return m_Running || !m_Tasks.isEmpty();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DeferredTaskScheduler::scheduleNextTask()
+{
+  if(!m_Started || m_Scheduled || m_Running || m_Tasks.isEmpty())
+  {
+    return;
+  }
+
+  // A zero timer fires once the events that are already queued have been handled
+  m_Scheduled = true;
+  QTimer::singleShot(0, this, &DeferredTaskScheduler::runNextTask);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DeferredTaskScheduler::runNextTask()
+{
+  m_Scheduled = false;
+  if(m_Running || m_Tasks.isEmpty())
+  {
+    return;
+  }
+
+  int next = 0;
+  for(int i = 1; i < m_Tasks.size(); i++)
+  {
+    if(m_Tasks[i].priority < m_Tasks[next].priority)
+    {
+      next = i;
+    }
+  }
+  Task task = m_Tasks.takeAt(next);
+  m_Running = true;
+
+  if(task.backgroundTask)
+  {
+    m_CurrentTask = task;
+    m_BackgroundStartUs = traceTime();
+    m_BackgroundWatcher.setFuture(QtConcurrent::run(task.backgroundTask));
+    return;
+  }
+
+  runMainThreadPart(task);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DeferredTaskScheduler::finishBackgroundTask()
+{
+  recordTask("Deferred Task (Background)", m_CurrentTask, m_BackgroundStartUs);
+
+  Task task = m_CurrentTask;
+  m_CurrentTask = Task();
+  runMainThreadPart(task);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DeferredTaskScheduler::runMainThreadPart(const Task& task)
+{
+  if(task.mainThreadTask)
+  {
+    qint64 startUs = traceTime();
+    task.mainThreadTask();
+    recordTask("Deferred Task", task, startUs);
+  }
+
+  m_Running = false;
+  if(m_Tasks.isEmpty())
+  {
+    emit finished();
+    return;
+  }
+  scheduleNextTask();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DeferredTaskScheduler::recordTask(const char* spanName, const Task& task, qint64 startUs)
+{
+  if(!StartupTrace::IsEnabled())
+  {
+    return;
+  }
+
+  StartupTrace* trace = StartupTrace::Instance();
+  qint64 waitedMs = (startUs - task.queuedUs) / 1000;
+  QString detail = QString("%1 (waited %2 ms)").arg(task.name).arg(waitedMs);
+  trace->addSpan(spanName, detail, startUs, trace->getElapsedMicroseconds() - startUs);
+}
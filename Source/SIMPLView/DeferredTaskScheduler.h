@@ -0,0 +1,143 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+/**
+ * @brief The DeferredTaskScheduler class runs work that is not needed to show the first window
+ * once that window is on screen. Tasks run one at a time in order of priority, and in the
+ * order they were added within a priority. Each task gets its own pass of the event loop so
+ * that input and paint events are handled in between.
+ *
+ * A task may have a background part that runs on a worker thread before its main thread part,
+ * e.g. to read a file. The background part must not touch widgets or QObjects that live on the
+ * main thread.
+ *
+ * Each task is recorded in the startup trace with the time it waited and the time it ran.
+ */
+class DeferredTaskScheduler : public QObject
+{
+  Q_OBJECT
+
+public:
+  enum class Priority : int
+  {
+    High = 0,
+    Normal = 1,
+    Low = 2
+  };
+
+  using TaskFunction = std::function<void()>;
+
+  DeferredTaskScheduler(QObject* parent = nullptr);
+  ~DeferredTaskScheduler() override;
+
+  /**
+   * @brief addTask Adds a task that runs on the main thread
+   * @param name
+   * @param priority
+   * @param task
+   */
+  void addTask(const QString& name, Priority priority, const TaskFunction& task);
+
+  /**
+   * @brief addTask Adds a task whose background part runs on a worker thread and whose
+   * main thread part runs once the background part is done. Either part may be empty.
+   * @param name
+   * @param priority
+   * @param backgroundTask
+   * @param mainThreadTask
+   */
+  void addTask(const QString& name, Priority priority, const TaskFunction& backgroundTask, const TaskFunction& mainThreadTask);
+
+  /**
+   * @brief start Starts running the tasks. Tasks added after this run as well.
+   */
+  void start();
+
+  /**
+   * @brief isStarted
+   * @return
+   */
+  bool isStarted() const;
+
+  /**
+   * @brief hasPendingTasks Returns true if a task is still waiting or running
+   * @return
+   */
+  bool hasPendingTasks() const;
+
+signals:
+  /**
+   * @brief finished Emitted when the last pending task is done
+   */
+  void finished();
+
+private slots:
+  void runNextTask();
+  void finishBackgroundTask();
+
+private:
+  struct Task
+  {
+    QString name;
+    Priority priority = Priority::Normal;
+    TaskFunction backgroundTask;
+    TaskFunction mainThreadTask;
+    qint64 queuedUs = 0;
+  };
+
+  QList<Task> m_Tasks;
+  Task m_CurrentTask;
+  qint64 m_BackgroundStartUs = 0;
+  bool m_Started = false;
+  bool m_Scheduled = false;
+  bool m_Running = false;
+  QFutureWatcher<void> m_BackgroundWatcher;
+
+  void scheduleNextTask();
+  void runMainThreadPart(const Task& task);
+  void recordTask(const char* spanName, const Task& task, qint64 startUs);
+
+  DeferredTaskScheduler(const DeferredTaskScheduler&) = delete; // Copy Constructor Not Implemented
+  void operator=(const DeferredTaskScheduler&) = delete;        // Move assignment Not Implemented
+};
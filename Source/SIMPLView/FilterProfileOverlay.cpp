@@ -0,0 +1,166 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "FilterProfileOverlay.h"
+
+#include <QtGui/QPainter>
+#include <QtWidgets/QScrollBar>
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterProfileOverlay::FilterProfileOverlay(QAbstractItemView* view)
+: QWidget(view)
+, m_View(view)
+{
+  // The overlay is a child of the view and not of its viewport, which would scroll it away
+  setAttribute(Qt::WA_TransparentForMouseEvents);
+  setAttribute(Qt::WA_NoSystemBackground);
+  view->viewport()->installEventFilter(this);
+  connect(view->verticalScrollBar(), &QScrollBar::valueChanged, this, [this] { update(); });
+  connect(view->horizontalScrollBar(), &QScrollBar::valueChanged, this, [this] { update(); });
+
+  QAbstractItemModel* model = view->model();
+  if(model != nullptr)
+  {
+    connect(model, &QAbstractItemModel::rowsInserted, this, &FilterProfileOverlay::clearRecords);
+    connect(model, &QAbstractItemModel::rowsRemoved, this, &FilterProfileOverlay::clearRecords);
+    connect(model, &QAbstractItemModel::rowsMoved, this, &FilterProfileOverlay::clearRecords);
+    connect(model, &QAbstractItemModel::modelReset, this, &FilterProfileOverlay::clearRecords);
+  }
+  followViewport();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterProfileOverlay::~FilterProfileOverlay() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FilterProfileOverlay::setRecords(const QVector<FilterProfiler::Record>& records)
+{
+  m_Records.clear();
+  for(const FilterProfiler::Record& record : records)
+  {
+    m_Records.insert(record.index, record);
+  }
+  followViewport();
+  raise();
+  update();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FilterProfileOverlay::clearRecords()
+{
+  m_Records.clear();
+  update();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FilterProfileOverlay::followViewport()
+{
+  if(m_View != nullptr)
+  {
+    setGeometry(m_View->viewport()->geometry());
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool FilterProfileOverlay::eventFilter(QObject* watched, QEvent* event)
+{
+  if(m_View != nullptr && watched == m_View->viewport() && (event->type() == QEvent::Resize || event->type() == QEvent::Move))
+  {
+    followViewport();
+  }
+  return QWidget::eventFilter(watched, event);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FilterProfileOverlay::paintEvent(QPaintEvent* event)
+{
+  Q_UNUSED(event)
+  if(m_View == nullptr || m_View->model() == nullptr || m_Records.isEmpty())
+  {
+    return;
+  }
+
+  // The slowest filter stands out so that it is found without reading every row
+  qint64 slowestUs = 0;
+  for(const FilterProfiler::Record& record : m_Records)
+  {
+    slowestUs = qMax(slowestUs, record.wallUs);
+  }
+
+  QPainter painter(this);
+  QFont font = painter.font();
+  font.setPointSizeF(font.pointSizeF() * 0.85);
+  painter.setFont(font);
+
+  QAbstractItemModel* model = m_View->model();
+  for(QMap<int, FilterProfiler::Record>::const_iterator iter = m_Records.constBegin(); iter != m_Records.constEnd(); ++iter)
+  {
+    if(iter.key() >= model->rowCount())
+    {
+      break;
+    }
+    QRect rowRect = m_View->visualRect(model->index(iter.key(), 0));
+    if(!rowRect.isValid() || !rect().intersects(rowRect))
+    {
+      continue;
+    }
+
+    QString text = FilterProfiler::FormatRecord(iter.value());
+    QRect textRect = painter.fontMetrics().boundingRect(text).adjusted(-4, -1, 4, 1);
+    textRect.moveCenter(rowRect.center());
+    textRect.moveRight(rowRect.right() - 28);
+
+    bool slowest = (iter.value().wallUs == slowestUs && m_Records.size() > 1);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(slowest ? QColor(200, 60, 40, 200) : QColor(40, 40, 40, 160));
+    painter.drawRoundedRect(textRect, 3, 3);
+    painter.setPen(Qt::white);
+    painter.drawText(textRect, Qt::AlignCenter, text);
+  }
+}
@@ -0,0 +1,86 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QMap>
+#include <QtCore/QPointer>
+
+#include <QtWidgets/QAbstractItemView>
+#include <QtWidgets/QWidget>
+
+#include "SIMPLView/FilterProfiler.h"
+
+/**
+ * @brief The FilterProfileOverlay class draws the FilterProfiler records of the last run on
+ * top of the rows of a pipeline view, right aligned in each filter's row. It covers the
+ * viewport of the view and lets every mouse event through. The records are dropped as
+ * soon as filters are added, removed or moved, because the rows no longer match them.
+ */
+class FilterProfileOverlay : public QWidget
+{
+  Q_OBJECT
+
+public:
+  FilterProfileOverlay(QAbstractItemView* view);
+  ~FilterProfileOverlay() override;
+
+  /**
+   * @brief setRecords Shows the records, keyed by the row of their filter
+   * @param records
+   */
+  void setRecords(const QVector<FilterProfiler::Record>& records);
+
+  /**
+   * @brief clearRecords
+   */
+  void clearRecords();
+
+protected:
+  bool eventFilter(QObject* watched, QEvent* event) override;
+  void paintEvent(QPaintEvent* event) override;
+
+private:
+  QPointer<QAbstractItemView> m_View;
+  QMap<int, FilterProfiler::Record> m_Records;
+
+  /**
+   * @brief followViewport Matches the geometry of the view's viewport
+   */
+  void followViewport();
+
+  FilterProfileOverlay(const FilterProfileOverlay&) = delete; // Copy Constructor Not Implemented
+  void operator=(const FilterProfileOverlay&) = delete;       // Move assignment Not Implemented
+};
@@ -0,0 +1,352 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "FilterProfiler.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+
+#if defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+#include "SIMPLib/Messages/PipelineMessage.h"
+
+#include "SIMPLView/PipelineMetrics.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString csvCell(const QString& text)
+{
+  QString cell = text;
+  if(cell.contains(',') || cell.contains('"'))
+  {
+    cell.replace("\"", "\"\"");
+    cell = "\"" + cell + "\"";
+  }
+  return cell;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString formatBytes(double bytes)
+{
+  const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+  int unit = 0;
+  while(bytes >= 1024.0 && unit < 4)
+  {
+    bytes /= 1024.0;
+    unit++;
+  }
+  return QString("%1 %2").arg(bytes, 0, 'f', (unit == 0 || bytes >= 100.0) ? 0 : 1).arg(units[unit]);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString formatSeconds(qint64 us)
+{
+  return QString("%1 s").arg(us / 1000000.0, 0, 'f', 2);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool writeText(const QString& filePath, const QByteArray& contents)
+{
+  QDir().mkpath(QFileInfo(filePath).absolutePath());
+  QSaveFile file(filePath);
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+  file.write(contents);
+  return file.commit();
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterProfiler::FilterProfiler() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterProfiler::~FilterProfiler() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FilterProfiler::start()
+{
+  m_Records.clear();
+  m_Current = Record();
+  m_Clock.start();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool FilterProfiler::isRunning() const
+{
+  return m_Clock.isValid();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FilterProfiler::processPipelineMessage(const PipelineMessage& pm)
+{
+  int index = pm.getPipelineIndex();
+  if(index < 0 || (isRunning() && index == m_Current.index))
+  {
+    return;
+  }
+  if(!isRunning())
+  {
+    start();
+  }
+
+  Sample now = takeSample();
+  closeCurrent(now);
+  m_Current.index = index;
+  m_Current.label = pm.getFilterHumanLabel();
+  m_Current.startUs = now.wallUs;
+  m_CurrentStart = now;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int FilterProfiler::getCurrentIndex() const
+{
+  return isRunning() ? m_Current.index : -1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 FilterProfiler::getCurrentElapsedUs() const
+{
+  return (getCurrentIndex() >= 0) ? m_Clock.nsecsElapsed() / 1000 - m_Current.startUs : 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FilterProfiler::finish()
+{
+  if(!isRunning())
+  {
+    return;
+  }
+  closeCurrent(takeSample());
+  m_Clock.invalidate();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<FilterProfiler::Record> FilterProfiler::getRecords() const
+{
+  return m_Records;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterProfiler::Sample FilterProfiler::takeSample() const
+{
+  Sample sample;
+  sample.wallUs = m_Clock.nsecsElapsed() / 1000;
+#if defined(Q_OS_UNIX)
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage) == 0)
+  {
+    sample.cpuUs = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000LL + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#if defined(Q_OS_MAC)
+    sample.peakMemoryKB = usage.ru_maxrss / 1024;
+#else
+    sample.peakMemoryKB = usage.ru_maxrss;
+#endif
+  }
+#endif
+  PipelineMetrics::ReadProcessIo(sample.bytesRead, sample.bytesWritten);
+  return sample;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FilterProfiler::closeCurrent(const Sample& now)
+{
+  if(m_Current.index < 0)
+  {
+    return;
+  }
+  m_Current.wallUs = now.wallUs - m_CurrentStart.wallUs;
+  m_Current.cpuUs = now.cpuUs - m_CurrentStart.cpuUs;
+  m_Current.peakMemoryIncreaseKB = now.peakMemoryKB - m_CurrentStart.peakMemoryKB;
+  m_Current.bytesRead = now.bytesRead - m_CurrentStart.bytesRead;
+  m_Current.bytesWritten = now.bytesWritten - m_CurrentStart.bytesWritten;
+  m_Records.push_back(m_Current);
+  m_Current = Record();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject FilterProfiler::RecordToJson(const Record& record)
+{
+  QJsonObject json;
+  json["index"] = record.index;
+  json["label"] = record.label;
+  json["startUs"] = static_cast<double>(record.startUs);
+  json["wallUs"] = static_cast<double>(record.wallUs);
+  json["cpuUs"] = static_cast<double>(record.cpuUs);
+  json["peakMemoryIncreaseKB"] = static_cast<double>(record.peakMemoryIncreaseKB);
+  json["bytesRead"] = static_cast<double>(record.bytesRead);
+  json["bytesWritten"] = static_cast<double>(record.bytesWritten);
+  return json;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterProfiler::Record FilterProfiler::RecordFromJson(const QJsonObject& json)
+{
+  Record record;
+  record.index = json["index"].toInt(-1);
+  record.label = json["label"].toString();
+  record.startUs = static_cast<qint64>(json["startUs"].toDouble());
+  record.wallUs = static_cast<qint64>(json["wallUs"].toDouble());
+  record.cpuUs = static_cast<qint64>(json["cpuUs"].toDouble());
+  record.peakMemoryIncreaseKB = static_cast<qint64>(json["peakMemoryIncreaseKB"].toDouble());
+  record.bytesRead = static_cast<qint64>(json["bytesRead"].toDouble());
+  record.bytesWritten = static_cast<qint64>(json["bytesWritten"].toDouble());
+  return record;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool FilterProfiler::WriteChromeTrace(const QString& filePath, const QVector<Record>& records, const QString& pipelineName)
+{
+  QJsonArray events;
+
+  QJsonObject processName;
+  processName["name"] = QString("process_name");
+  processName["ph"] = QString("M");
+  processName["pid"] = 1;
+  processName["args"] = QJsonObject({{"name", pipelineName}});
+  events.push_back(processName);
+
+  for(const Record& record : records)
+  {
+    QJsonObject args = RecordToJson(record);
+    args.remove("label");
+    args.remove("startUs");
+    args.remove("wallUs");
+
+    QJsonObject event;
+    event["name"] = QString("[%1] %2").arg(record.index).arg(record.label);
+    event["cat"] = QString("filter");
+    event["ph"] = QString("X");
+    event["ts"] = static_cast<double>(record.startUs);
+    event["dur"] = static_cast<double>(record.wallUs);
+    event["pid"] = 1;
+    event["tid"] = 1;
+    event["args"] = args;
+    events.push_back(event);
+  }
+
+  QJsonObject root;
+  root["traceEvents"] = events;
+  root["displayTimeUnit"] = QString("ms");
+  return writeText(filePath, QJsonDocument(root).toJson(QJsonDocument::Compact));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool FilterProfiler::WriteCsv(const QString& filePath, const QVector<Record>& records)
+{
+  QString text;
+  QTextStream out(&text);
+  out << "Index,Filter,Start (ms),Wall (ms),CPU (ms),Peak Memory Increase (KB),Bytes Read,Bytes Written\n";
+  for(const Record& record : records)
+  {
+    out << record.index << "," << csvCell(record.label) << "," << record.startUs / 1000.0 << "," << record.wallUs / 1000.0 << "," << record.cpuUs / 1000.0 << ","
+        << record.peakMemoryIncreaseKB << "," << record.bytesRead << "," << record.bytesWritten << "\n";
+  }
+  out.flush();
+  return writeText(filePath, text.toUtf8());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString FilterProfiler::FormatRecord(const Record& record)
+{
+  QStringList parts;
+  parts << formatSeconds(record.wallUs);
+  if(record.cpuUs > 0)
+  {
+    parts << "CPU " + formatSeconds(record.cpuUs);
+  }
+  if(record.peakMemoryIncreaseKB > 0)
+  {
+    parts << "+" + formatBytes(record.peakMemoryIncreaseKB * 1024.0);
+  }
+  if(record.bytesRead > 0)
+  {
+    parts << "read " + formatBytes(record.bytesRead);
+  }
+  if(record.bytesWritten > 0)
+  {
+    parts << "wrote " + formatBytes(record.bytesWritten);
+  }
+  return parts.join(", ");
+}
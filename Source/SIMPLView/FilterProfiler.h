@@ -0,0 +1,186 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+class PipelineMessage;
+
+/**
+ * @brief The FilterProfiler class records what every filter of a running pipeline costs:
+ * wall time, CPU time, how much it raised the peak resident memory and the bytes it read
+ * and wrote. It is fed the PipelineMessages of the run and takes one sample of the process
+ * counters whenever the messages move on to the next filter, so it is cheap enough to stay
+ * on for every run.
+ *
+ * The counters belong to the whole process, so a filter is charged for everything the
+ * process did while it ran. CPU time and the peak memory are only available on Unix and
+ * the bytes read and written only on Linux; elsewhere they are 0.
+ */
+class FilterProfiler
+{
+public:
+  struct Record
+  {
+    int index = -1;
+    QString label;
+    qint64 startUs = 0;
+    qint64 wallUs = 0;
+    qint64 cpuUs = 0;
+    qint64 peakMemoryIncreaseKB = 0;
+    qint64 bytesRead = 0;
+    qint64 bytesWritten = 0;
+  };
+
+  FilterProfiler();
+  virtual ~FilterProfiler();
+
+  /**
+   * @brief start Forgets the records of the last run and starts the clock. A message that
+   * arrives while the profiler is not running starts it as well.
+   */
+  void start();
+
+  /**
+   * @brief isRunning
+   * @return
+   */
+  bool isRunning() const;
+
+  /**
+   * @brief processPipelineMessage Closes the record of the previous filter when the message
+   * comes from a different one
+   * @param pm
+   */
+  void processPipelineMessage(const PipelineMessage& pm);
+
+  /**
+   * @brief getCurrentIndex Returns the pipeline index of the filter that is running
+   * @return -1 if no filter has sent a message yet
+   */
+  int getCurrentIndex() const;
+
+  /**
+   * @brief getCurrentElapsedUs Returns how long the running filter has been running
+   * @return
+   */
+  qint64 getCurrentElapsedUs() const;
+
+  /**
+   * @brief finish Closes the record of the last filter and stops the clock
+   */
+  void finish();
+
+  /**
+   * @brief getRecords Returns the records of the filters that have finished, in the order
+   * they ran
+   * @return
+   */
+  QVector<Record> getRecords() const;
+
+  /**
+   * @brief RecordToJson
+   * @param record
+   * @return
+   */
+  static QJsonObject RecordToJson(const Record& record);
+
+  /**
+   * @brief RecordFromJson
+   * @param json
+   * @return
+   */
+  static Record RecordFromJson(const QJsonObject& json);
+
+  /**
+   * @brief WriteChromeTrace Writes the records in the Trace Event format that chrome://tracing
+   * and Perfetto open
+   * @param filePath
+   * @param records
+   * @param pipelineName Shown as the name of the process
+   * @return
+   */
+  static bool WriteChromeTrace(const QString& filePath, const QVector<Record>& records, const QString& pipelineName);
+
+  /**
+   * @brief WriteCsv Writes one row per record
+   * @param filePath
+   * @param records
+   * @return
+   */
+  static bool WriteCsv(const QString& filePath, const QVector<Record>& records);
+
+  /**
+   * @brief FormatRecord Returns a short description of the record, such as
+   * "1.20 s, CPU 3.50 s, +512 MB, read 1.1 GB"
+   * @param record
+   * @return
+   */
+  static QString FormatRecord(const Record& record);
+
+private:
+  struct Sample
+  {
+    qint64 wallUs = 0;
+    qint64 cpuUs = 0;
+    qint64 peakMemoryKB = 0;
+    qint64 bytesRead = 0;
+    qint64 bytesWritten = 0;
+  };
+
+  QElapsedTimer m_Clock;
+  Record m_Current;
+  Sample m_CurrentStart;
+  QVector<Record> m_Records;
+
+  /**
+   * @brief takeSample Reads the clock and the counters of the process
+   * @return
+   */
+  Sample takeSample() const;
+
+  /**
+   * @brief closeCurrent Completes the record of the current filter, if any
+   * @param now
+   */
+  void closeCurrent(const Sample& now);
+
+  FilterProfiler(const FilterProfiler&) = delete; // Copy Constructor Not Implemented
+  void operator=(const FilterProfiler&) = delete; // Move assignment Not Implemented
+};
@@ -0,0 +1,440 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "FilterResultCache.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataArrays/IDataArray.h"
+#include "SIMPLib/Messages/PipelineMessage.h"
+
+#include "SIMPLView/FilterResultStore.h"
+#include "SIMPLView/PipelineCheckpoints.h"
+#include "SIMPLView/RunManifest.h"
+
+namespace
+{
+// The filters since the last kept state have to take this long before the next state is
+// kept, which is about what copying a large state costs
+const qint64 k_MinSnapshotWorkMs = 500;
+
+// Writing a state to the FilterResultStore costs a lot more than copying it
+const qint64 k_MinPersistWorkMs = 5000;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject filterParameters(const AbstractFilter::Pointer& filter)
+{
+  QJsonObject parameters;
+  filter->writeFilterParameters(parameters);
+  return parameters;
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterResultCache::FilterResultCache()
+: m_MinSnapshotWork(k_MinSnapshotWorkMs)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterResultCache::~FilterResultCache() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FilterResultCache::setMemoryBudget(qint64 megabytes)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_MemoryBudget = qMax<qint64>(0, megabytes);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 FilterResultCache::getMemoryBudget() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return m_MemoryBudget;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 FilterResultCache::getMemoryUsage() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return m_MemoryUsage;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FilterResultCache::setMinSnapshotWork(qint64 msec)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_MinSnapshotWork = qMax<qint64>(0, msec);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 FilterResultCache::getMinSnapshotWork() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return m_MinSnapshotWork;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FilterResultCache::clear()
+{
+  QMutexLocker lock(&m_Mutex);
+  m_Entries.clear();
+  m_MemoryUsage = 0;
+}
+
+// -----------------------------------------------------------------------------
+// An output file that exists may have been overwritten by a run with other parameters
+// since, so a filter that writes files is always executed, and so is one with a path
+// that cannot be told apart as input or output
+// -----------------------------------------------------------------------------
+bool FilterResultCache::CanSkip(const AbstractFilter::Pointer& filter)
+{
+  QStringList inputs;
+  QStringList outputs;
+  if(!RunManifest::CollectPaths(filterParameters(filter), inputs, outputs))
+  {
+    return false;
+  }
+  return outputs.isEmpty();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<QByteArray> FilterResultCache::ComputeKeys(const FilterPipeline::FilterContainerType& filters)
+{
+  QVector<QByteArray> keys;
+  QByteArray upstream;
+  for(const AbstractFilter::Pointer& filter : filters)
+  {
+    QJsonObject parameters = filterParameters(filter);
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(upstream);
+    hash.addData(filter->getUuid().toString().toUtf8());
+    hash.addData(filter->getEnabled() ? "1" : "0");
+    hash.addData(QJsonDocument(parameters).toJson(QJsonDocument::Compact));
+
+    // A reader with the same parameters reads something else once its file changed
+    QStringList inputs;
+    QStringList outputs;
+    RunManifest::CollectPaths(parameters, inputs, outputs);
+    foreach(QString input, inputs)
+    {
+      QFileInfo fi(input);
+      hash.addData(QString("%1|%2|%3").arg(input).arg(fi.size()).arg(fi.lastModified().toMSecsSinceEpoch()).toUtf8());
+    }
+
+    upstream = hash.result();
+    keys.push_back(upstream);
+  }
+  return keys;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 FilterResultCache::EstimateSize(const DataContainerArray::Pointer& dca)
+{
+  qint64 bytes = 0;
+  for(const DataContainer::Pointer& dc : dca->getDataContainers())
+  {
+    for(const AttributeMatrix::Pointer& am : dc->getAttributeMatrices())
+    {
+      foreach(QString name, am->getAttributeArrayNames())
+      {
+        IDataArray::Pointer array = am->getAttributeArray(name);
+        if(array.get() != nullptr)
+        {
+          bytes += static_cast<qint64>(array->getSize()) * array->getTypeSize();
+        }
+      }
+    }
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int FilterResultCache::execute(const FilterPipeline::Pointer& pipeline, const QString& pipelinePath, Observer* observer, QVector<int>& cachedFilters)
+{
+  cachedFilters.clear();
+
+  if(observer != nullptr)
+  {
+    pipeline->addMessageReceiver(observer);
+  }
+  int err = pipeline->preflightPipeline();
+  if(observer != nullptr)
+  {
+    pipeline->removeMessageReceiver(observer);
+  }
+  if(err < 0)
+  {
+    return err;
+  }
+
+  FilterPipeline::FilterContainerType filters = pipeline->getFilterContainer();
+  QVector<QByteArray> keys = ComputeKeys(filters);
+  FilterResultStore* resultStore = FilterResultStore::Instance();
+  bool persistent = resultStore->getEnabled();
+  PipelineCheckpoints* checkpoints = PipelineCheckpoints::Instance();
+  bool checkpointing = checkpoints->isActive() && !pipelinePath.isEmpty();
+  QVector<int> checkpointIndices = checkpoints->getFilterIndices();
+  QVector<QByteArray> storedKeys = (persistent || checkpointing) ? resultStore->computeKeys(filters) : QVector<QByteArray>();
+
+  // A filter that writes files has to run again, and so does everything after it
+  int resumeAfter = -1;
+  int storedAfter = -1;
+  int validUpTo = -1;
+  DataContainerArray::Pointer kept;
+  for(int i = 0; i < filters.size() && CanSkip(filters[i]); i++)
+  {
+    validUpTo = i;
+    DataContainerArray::Pointer state = lookup(keys[i]);
+    if(state.get() != nullptr)
+    {
+      resumeAfter = i;
+      kept = state;
+    }
+    if(persistent && resultStore->contains(storedKeys[i]))
+    {
+      storedAfter = i;
+    }
+  }
+
+  int checkpointAfter = (checkpointing && checkpoints->getResume()) ? checkpoints->findCheckpoint(pipelinePath, storedKeys, validUpTo) : -1;
+
+  DataContainerArray::Pointer dca;
+  if(checkpointAfter > resumeAfter && checkpointAfter >= storedAfter)
+  {
+    dca = checkpoints->readCheckpoint(pipelinePath, checkpointAfter, storedKeys[checkpointAfter]);
+    if(dca.get() != nullptr)
+    {
+      resumeAfter = checkpointAfter;
+    }
+  }
+  if(dca.get() == nullptr && storedAfter > resumeAfter)
+  {
+    dca = resultStore->read(storedKeys[storedAfter]);
+    if(dca.get() != nullptr)
+    {
+      resumeAfter = storedAfter;
+    }
+  }
+  if(dca.get() == nullptr)
+  {
+    // The kept state is shared with later runs, so this run works on a copy
+    dca = (kept.get() != nullptr) ? kept->deepCopy(false) : DataContainerArray::New();
+  }
+  for(int i = 0; i <= resumeAfter; i++)
+  {
+    cachedFilters.push_back(i);
+  }
+
+  qint64 minSnapshotWork = getMinSnapshotWork();
+  QElapsedTimer sinceSnapshot;
+  sinceSnapshot.start();
+  QElapsedTimer sincePersist;
+  sincePersist.start();
+
+  // Keeps the state after a filter where the cache, the store or a checkpoint wants it
+  auto filterFinished = [&](int i) {
+    if(checkpointing && checkpointIndices.contains(i))
+    {
+      checkpoints->writeCheckpoint(pipelinePath, i, filters[i]->getHumanLabel(), storedKeys[i], dca);
+    }
+    if(persistent && sincePersist.elapsed() >= k_MinPersistWorkMs)
+    {
+      resultStore->write(storedKeys[i], dca, pipelinePath, i, filters[i]->getHumanLabel());
+      sincePersist.restart();
+    }
+    if(sinceSnapshot.elapsed() >= minSnapshotWork)
+    {
+      store(keys[i], dca);
+      sinceSnapshot.restart();
+    }
+  };
+
+  // The pipeline itself executes the filters, so its progress, status messages and
+  // cancellation work as usual. It sends a progress value of its own, without a filter
+  // class, before every filter it runs. The filter whose messages came in since the last
+  // one has finished then. A filter that sent no message is not kept, since which one
+  // ran cannot be told.
+  int reported = -1;
+  QMetaObject::Connection connection = QObject::connect(pipeline.get(), &FilterPipeline::pipelineGeneratedMessage, [&](const PipelineMessage& pm) {
+    if(!pm.getFilterClassName().isEmpty())
+    {
+      int index = pm.getPipelineIndex();
+      if(index >= 0 && index < filters.size())
+      {
+        reported = index;
+      }
+      return;
+    }
+    if(pm.getType() != PipelineMessage::MessageType::ProgressValue)
+    {
+      return;
+    }
+    if(reported > resumeAfter)
+    {
+      filterFinished(reported);
+    }
+    reported = -1;
+  });
+
+  // The filters whose results were kept are passed over by disabling them for this run
+  QVector<bool> enabled;
+  for(int i = 0; i <= resumeAfter; i++)
+  {
+    enabled.push_back(filters[i]->getEnabled());
+    filters[i]->setEnabled(false);
+  }
+  if(observer != nullptr)
+  {
+    pipeline->addMessageReceiver(observer);
+  }
+  pipeline->execute(dca);
+  if(observer != nullptr)
+  {
+    pipeline->removeMessageReceiver(observer);
+  }
+  for(int i = 0; i <= resumeAfter; i++)
+  {
+    filters[i]->setEnabled(enabled[i]);
+  }
+  QObject::disconnect(connection);
+
+  err = pipeline->getErrorCondition();
+  if(err >= 0 && !pipeline->getCancel() && filters.size() - 1 > resumeAfter)
+  {
+    filterFinished(filters.size() - 1);
+  }
+
+  // A failed run is resumed from its checkpoints, a successful one does not need them
+  if(checkpointing && err >= 0 && !pipeline->getCancel())
+  {
+    checkpoints->removeCheckpoints(pipelinePath);
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer FilterResultCache::lookup(const QByteArray& key)
+{
+  QMutexLocker lock(&m_Mutex);
+  QMap<QByteArray, Entry>::iterator iter = m_Entries.find(key);
+  if(iter == m_Entries.end())
+  {
+    return DataContainerArray::NullPointer();
+  }
+  iter->lastUsed = ++m_UseCount;
+  return iter->dca;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FilterResultCache::store(const QByteArray& key, const DataContainerArray::Pointer& dca)
+{
+  qint64 bytes = EstimateSize(dca);
+  qint64 budget = getMemoryBudget() * 1024 * 1024;
+  if(budget <= 0 || bytes > budget)
+  {
+    return;
+  }
+
+  // The copy is made outside the lock, other runs only need it for the map
+  Entry entry;
+  entry.dca = dca->deepCopy(false);
+  entry.bytes = bytes;
+
+  QMutexLocker lock(&m_Mutex);
+  if(m_Entries.contains(key))
+  {
+    m_MemoryUsage -= m_Entries[key].bytes;
+  }
+  entry.lastUsed = ++m_UseCount;
+  m_Entries.insert(key, entry);
+  m_MemoryUsage += bytes;
+
+  while(m_MemoryUsage > budget)
+  {
+    QMap<QByteArray, Entry>::iterator oldest = m_Entries.end();
+    for(QMap<QByteArray, Entry>::iterator iter = m_Entries.begin(); iter != m_Entries.end(); ++iter)
+    {
+      if(iter.key() != key && (oldest == m_Entries.end() || iter->lastUsed < oldest->lastUsed))
+      {
+        oldest = iter;
+      }
+    }
+    if(oldest == m_Entries.end())
+    {
+      break;
+    }
+    m_MemoryUsage -= oldest->bytes;
+    m_Entries.erase(oldest);
+  }
+}
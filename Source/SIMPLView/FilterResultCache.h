@@ -0,0 +1,173 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+
+#include "SIMPLib/Common/Observer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+/**
+ * @brief The FilterResultCache class lets a pipeline that is run again skip the filters that
+ * did not change. execute() has the pipeline execute the filters that have to run, starting
+ * from the deepest kept state, and keeps a copy of the DataContainerArray after them, keyed
+ * by a hash of the filter's parameters and input files and of everything upstream. The next
+ * run of a pipeline that shares those filters resumes from the deepest state that is still
+ * valid.
+ *
+ * A state is only kept once the filters since the last kept state took a noticeable time,
+ * so that cheap filters do not pay for the copies. The least recently used states are
+ * dropped when the cache grows past its memory budget. Only the filters before the first one
+ * that writes files, or that has a path parameter that is neither an input nor an output,
+ * are ever skipped. Whether a file that exists is still the one this pipeline wrote cannot
+ * be told, since another run may have overwritten it. When the FilterResultStore is enabled, the states of
+ * slow prefixes are also written to disk and a run may resume from them instead, and the same
+ * goes for the PipelineCheckpoints that the user placed. All functions may be called from
+ * any thread.
+ */
+class FilterResultCache
+{
+public:
+  FilterResultCache();
+  virtual ~FilterResultCache();
+
+  /**
+   * @brief setMemoryBudget Sets how much memory the kept states may use. With a budget of 0
+   * only the FilterResultStore is used.
+   * @param megabytes
+   */
+  void setMemoryBudget(qint64 megabytes);
+
+  /**
+   * @brief getMemoryBudget
+   * @return The budget in MB
+   */
+  qint64 getMemoryBudget() const;
+
+  /**
+   * @brief getMemoryUsage
+   * @return The size of the kept states in bytes
+   */
+  qint64 getMemoryUsage() const;
+
+  /**
+   * @brief setMinSnapshotWork Sets how long the filters since the last kept state have to
+   * take before the state after them is kept
+   * @param msec
+   */
+  void setMinSnapshotWork(qint64 msec);
+
+  /**
+   * @brief getMinSnapshotWork
+   * @return
+   */
+  qint64 getMinSnapshotWork() const;
+
+  /**
+   * @brief clear Drops every kept state
+   */
+  void clear();
+
+  /**
+   * @brief execute Executes a pipeline that has been read but not executed, resuming from
+   * the deepest kept state. The pipeline reports progress and may be canceled as usual.
+   * @param pipeline
+   * @param pipelinePath The file the pipeline came from, may be empty
+   * @param observer Receives the messages of the filters that are executed, may be null
+   * @param cachedFilters Receives the indices of the filters that were skipped
+   * @return The error condition of the pipeline
+   */
+  int execute(const FilterPipeline::Pointer& pipeline, const QString& pipelinePath, Observer* observer, QVector<int>& cachedFilters);
+
+  /**
+   * @brief CanSkip Returns whether the state after a filter may come from an earlier run,
+   * which is not the case for a filter that writes files
+   * @param filter
+   * @return
+   */
+  static bool CanSkip(const AbstractFilter::Pointer& filter);
+
+  /**
+   * @brief ComputeKeys Returns the key of the state after every filter
+   * @param filters
+   * @return
+   */
+  static QVector<QByteArray> ComputeKeys(const FilterPipeline::FilterContainerType& filters);
+
+  /**
+   * @brief EstimateSize Adds up the sizes of the attribute arrays. Geometries are not counted.
+   * @param dca
+   * @return The size in bytes
+   */
+  static qint64 EstimateSize(const DataContainerArray::Pointer& dca);
+
+private:
+  struct Entry
+  {
+    DataContainerArray::Pointer dca;
+    qint64 bytes = 0;
+    quint64 lastUsed = 0;
+  };
+
+  mutable QMutex m_Mutex;
+  qint64 m_MemoryBudget = 4096;
+  qint64 m_MemoryUsage = 0;
+  qint64 m_MinSnapshotWork;
+  quint64 m_UseCount = 0;
+  QMap<QByteArray, Entry> m_Entries;
+
+  /**
+   * @brief lookup Returns the kept state of a key, which must not be changed
+   * @param key
+   * @return A null pointer if the state is not kept
+   */
+  DataContainerArray::Pointer lookup(const QByteArray& key);
+
+  /**
+   * @brief store Keeps a copy of the state and drops the least recently used states until
+   * the cache fits its budget
+   * @param key
+   * @param dca
+   */
+  void store(const QByteArray& key, const DataContainerArray::Pointer& dca);
+
+  FilterResultCache(const FilterResultCache&) = delete; // Copy Constructor Not Implemented
+  void operator=(const FilterResultCache&) = delete;    // Move assignment Not Implemented
+};
@@ -0,0 +1,471 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "FilterResultStore.h"
+
+#include <algorithm>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QStringList>
+
+#include "SIMPLib/CoreFilters/DataContainerReader.h"
+#include "SIMPLib/CoreFilters/DataContainerWriter.h"
+
+#include "SIMPLView/PerformanceHistory.h"
+#include "SIMPLView/PluginManifest.h"
+#include "SIMPLView/RunManifest.h"
+
+namespace
+{
+// Left over files of runs that were killed are only removed once they are this old, so that
+// a run of another process that is still writing them is not disturbed
+const qint64 k_StaleFileSecs = 24 * 60 * 60;
+
+// Serializes the .dream3d files of the store and of the checkpoints
+QMutex s_Hdf5Mutex;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString statePath(const QString& directory, const QByteArray& key)
+{
+  return QDir(directory).filePath(QString::fromLatin1(key) + ".dream3d");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString sidecarPath(const QString& directory, const QByteArray& key)
+{
+  return QDir(directory).filePath(QString::fromLatin1(key) + ".json");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool writeSidecar(const QString& filePath, const QJsonObject& sidecar)
+{
+  QSaveFile file(filePath);
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+  file.write(QJsonDocument(sidecar).toJson());
+  return file.commit();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void removeEntry(const QString& directory, const QByteArray& key)
+{
+  QFile::remove(statePath(directory, key));
+  QFile::remove(sidecarPath(directory, key));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool isStale(const QFileInfo& fi)
+{
+  return fi.lastModified().secsTo(QDateTime::currentDateTime()) > k_StaleFileSecs;
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterResultStore::FilterResultStore()
+: m_Directory(GetDefaultDirectory())
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterResultStore::~FilterResultStore() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterResultStore* FilterResultStore::Instance()
+{
+  static FilterResultStore self;
+  return &self;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString FilterResultStore::GetDefaultDirectory()
+{
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/FilterResults";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FilterResultStore::setDirectory(const QString& directory)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_Directory = directory;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString FilterResultStore::getDirectory() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return m_Directory;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FilterResultStore::setEnabled(bool enabled)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_Enabled = enabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool FilterResultStore::getEnabled() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return m_Enabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FilterResultStore::setMaxSize(qint64 megabytes)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_MaxSize = qMax<qint64>(0, megabytes);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 FilterResultStore::getMaxSize() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return m_MaxSize;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QByteArray FilterResultStore::hashInput(const QString& filePath)
+{
+  QFileInfo fi(filePath);
+  qint64 lastModified = fi.lastModified().toMSecsSinceEpoch();
+  {
+    QMutexLocker lock(&m_Mutex);
+    QMap<QString, InputHash>::const_iterator iter = m_InputHashes.constFind(filePath);
+    if(iter != m_InputHashes.constEnd() && iter->size == fi.size() && iter->lastModified == lastModified)
+    {
+      return iter->sha1;
+    }
+  }
+
+  // Large inputs take a while to hash, which must not hold up the other runs
+  InputHash entry;
+  entry.size = fi.size();
+  entry.lastModified = lastModified;
+  entry.sha1 = PluginManifest::ComputeHash(filePath);
+
+  QMutexLocker lock(&m_Mutex);
+  m_InputHashes.insert(filePath, entry);
+  return entry.sha1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<QByteArray> FilterResultStore::computeKeys(const FilterPipeline::FilterContainerType& filters)
+{
+  QVector<QByteArray> keys;
+  QByteArray upstream = PerformanceHistory::ComputePluginsHash();
+  for(const AbstractFilter::Pointer& filter : filters)
+  {
+    QJsonObject parameters;
+    filter->writeFilterParameters(parameters);
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(upstream);
+    hash.addData(filter->getUuid().toString().toUtf8());
+    hash.addData(filter->getEnabled() ? "1" : "0");
+    hash.addData(QJsonDocument(parameters).toJson(QJsonDocument::Compact));
+
+    QStringList inputs;
+    QStringList outputs;
+    RunManifest::CollectPaths(parameters, inputs, outputs);
+    foreach(QString input, inputs)
+    {
+      hash.addData(hashInput(input));
+    }
+
+    upstream = hash.result().toHex();
+    keys.push_back(upstream);
+  }
+  return keys;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool FilterResultStore::contains(const QByteArray& key) const
+{
+  return QFileInfo::exists(statePath(getDirectory(), key));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer FilterResultStore::read(const QByteArray& key)
+{
+  QString directory = getDirectory();
+  QString filePath = statePath(directory, key);
+  if(!QFileInfo::exists(filePath))
+  {
+    return DataContainerArray::NullPointer();
+  }
+
+  DataContainerArray::Pointer dca;
+  {
+    QMutexLocker fileLock(&m_FileMutex);
+    dca = ReadStateFile(filePath);
+    if(dca.get() == nullptr)
+    {
+      removeEntry(directory, key);
+      return dca;
+    }
+  }
+
+  QFile file(sidecarPath(directory, key));
+  if(file.open(QIODevice::ReadOnly))
+  {
+    QJsonObject sidecar = QJsonDocument::fromJson(file.readAll()).object();
+    file.close();
+    sidecar["lastUsed"] = static_cast<double>(QDateTime::currentMSecsSinceEpoch());
+    writeSidecar(file.fileName(), sidecar);
+  }
+  return dca;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool FilterResultStore::write(const QByteArray& key, const DataContainerArray::Pointer& dca, const QString& pipelinePath, int filterIndex, const QString& filterLabel)
+{
+  QString directory = getDirectory();
+  QString filePath = statePath(directory, key);
+  if(QFileInfo::exists(filePath))
+  {
+    return true;
+  }
+  if(!QDir().mkpath(directory))
+  {
+    return false;
+  }
+
+  // The sidecar comes first, so that a state is never seen without it
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  QJsonObject sidecar;
+  sidecar["key"] = QString::fromLatin1(key);
+  sidecar["pipelinePath"] = pipelinePath;
+  sidecar["filterIndex"] = filterIndex;
+  sidecar["filterLabel"] = filterLabel;
+  sidecar["created"] = static_cast<double>(now);
+  sidecar["lastUsed"] = static_cast<double>(now);
+  if(!writeSidecar(sidecarPath(directory, key), sidecar))
+  {
+    return false;
+  }
+
+  {
+    QMutexLocker fileLock(&m_FileMutex);
+    QString tempPath = QDir(directory).filePath(QString("%1.%2.tmp.dream3d").arg(QString::fromLatin1(key)).arg(QCoreApplication::applicationPid()));
+    if(!WriteStateFile(tempPath, dca))
+    {
+      QFile::remove(tempPath);
+      QFile::remove(sidecarPath(directory, key));
+      return false;
+    }
+
+    // Another process may have stored the same key meanwhile, which holds the same state
+    if(!QFile::rename(tempPath, filePath))
+    {
+      QFile::remove(tempPath);
+    }
+  }
+
+  collectGarbage();
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer FilterResultStore::ReadStateFile(const QString& filePath)
+{
+  QMutexLocker hdf5Lock(&s_Hdf5Mutex);
+  DataContainerArray::Pointer dca = DataContainerArray::New();
+  DataContainerReader::Pointer reader = DataContainerReader::New();
+  reader->setInputFile(filePath);
+  reader->setInputFileDataContainerArrayProxy(reader->readDataContainerArrayStructure(filePath));
+  reader->setDataContainerArray(dca);
+  reader->execute();
+  return (reader->getErrorCondition() < 0) ? DataContainerArray::NullPointer() : dca;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool FilterResultStore::WriteStateFile(const QString& filePath, const DataContainerArray::Pointer& dca)
+{
+  QMutexLocker hdf5Lock(&s_Hdf5Mutex);
+  DataContainerWriter::Pointer writer = DataContainerWriter::New();
+  writer->setOutputFile(filePath);
+  writer->setWriteXdmfFile(false);
+  writer->setDataContainerArray(dca);
+  writer->execute();
+  return writer->getErrorCondition() >= 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<FilterResultStore::Entry> FilterResultStore::getEntries() const
+{
+  QString directory = getDirectory();
+  QVector<Entry> entries;
+  QFileInfoList sidecars = QDir(directory).entryInfoList(QStringList() << "*.json", QDir::Files);
+  for(const QFileInfo& fi : sidecars)
+  {
+    QByteArray key = fi.completeBaseName().toLatin1();
+    QFileInfo state(statePath(directory, key));
+    QFile file(fi.absoluteFilePath());
+    if(!state.exists() || !file.open(QIODevice::ReadOnly))
+    {
+      continue;
+    }
+    QJsonObject sidecar = QJsonDocument::fromJson(file.readAll()).object();
+
+    Entry entry;
+    entry.key = key;
+    entry.pipelinePath = sidecar["pipelinePath"].toString();
+    entry.filterIndex = sidecar["filterIndex"].toInt(-1);
+    entry.filterLabel = sidecar["filterLabel"].toString();
+    entry.bytes = state.size();
+    entry.created = static_cast<qint64>(sidecar["created"].toDouble());
+    entry.lastUsed = static_cast<qint64>(sidecar["lastUsed"].toDouble());
+    entries.push_back(entry);
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastUsed < b.lastUsed; });
+  return entries;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int FilterResultStore::collectGarbage()
+{
+  QString directory = getDirectory();
+  qint64 maxBytes = getMaxSize() * 1024 * 1024;
+  QVector<Entry> entries = getEntries();
+  qint64 totalBytes = 0;
+  for(const Entry& entry : entries)
+  {
+    totalBytes += entry.bytes;
+  }
+
+  QMutexLocker fileLock(&m_FileMutex);
+  int removed = 0;
+  for(const Entry& entry : entries)
+  {
+    if(totalBytes <= maxBytes)
+    {
+      break;
+    }
+    removeEntry(directory, entry.key);
+    totalBytes -= entry.bytes;
+    removed++;
+  }
+
+  // Runs that were killed leave a temporary state or a sidecar without its state behind
+  QFileInfoList files = QDir(directory).entryInfoList(QStringList() << "*.dream3d" << "*.json", QDir::Files);
+  for(const QFileInfo& fi : files)
+  {
+    bool temporary = fi.fileName().endsWith(".tmp.dream3d");
+    bool orphan = !temporary && fi.suffix() == "json" && !QFileInfo::exists(statePath(directory, fi.completeBaseName().toLatin1()));
+    if((temporary || orphan) && isStale(fi))
+    {
+      QFile::remove(fi.absoluteFilePath());
+    }
+  }
+  return removed;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int FilterResultStore::clear()
+{
+  QString directory = getDirectory();
+  QVector<Entry> entries = getEntries();
+
+  QMutexLocker fileLock(&m_FileMutex);
+  for(const Entry& entry : entries)
+  {
+    removeEntry(directory, entry.key);
+  }
+  return entries.size();
+}
@@ -0,0 +1,224 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+/**
+ * @brief The FilterResultStore class keeps the DataContainerArray after a filter on disk, as a
+ * .dream3d file named by a key that hashes the versions of the loaded plugins, the contents
+ * of the input files and the parameters of the filter and of everything upstream. Runs in
+ * later sessions, or by other users that point at the same directory, find the states of
+ * the pipeline prefixes they share and FilterResultCache resumes after the deepest one.
+ *
+ * Every state has a JSON sidecar that says which pipeline and filter wrote it and when it
+ * was last read. collectGarbage() removes the least recently read states until the store
+ * fits its size. The store is off by default. All functions may be called from any thread;
+ * the .dream3d files are read and written one at a time because HDF5 is not thread safe,
+ * see ReadStateFile().
+ */
+class FilterResultStore
+{
+public:
+  /**
+   * @brief The Entry struct describes one stored state
+   */
+  struct Entry
+  {
+    QByteArray key;
+    QString pipelinePath;
+    int filterIndex = -1;
+    QString filterLabel;
+    qint64 bytes = 0;
+    qint64 created = 0;
+    qint64 lastUsed = 0;
+  };
+
+  virtual ~FilterResultStore();
+
+  /**
+   * @brief Instance
+   * @return
+   */
+  static FilterResultStore* Instance();
+
+  /**
+   * @brief GetDefaultDirectory Returns where the states are kept unless told otherwise
+   * @return
+   */
+  static QString GetDefaultDirectory();
+
+  /**
+   * @brief setDirectory
+   * @param directory
+   */
+  void setDirectory(const QString& directory);
+
+  /**
+   * @brief getDirectory
+   * @return
+   */
+  QString getDirectory() const;
+
+  /**
+   * @brief setEnabled Turns the lookups and writes of FilterResultCache on or off
+   * @param enabled
+   */
+  void setEnabled(bool enabled);
+
+  /**
+   * @brief getEnabled
+   * @return
+   */
+  bool getEnabled() const;
+
+  /**
+   * @brief setMaxSize Sets the size that collectGarbage() shrinks the store to
+   * @param megabytes
+   */
+  void setMaxSize(qint64 megabytes);
+
+  /**
+   * @brief getMaxSize
+   * @return The size in MB
+   */
+  qint64 getMaxSize() const;
+
+  /**
+   * @brief computeKeys Returns the key of the state after every filter. The inputs are
+   * hashed once for every size and time stamp that they are seen with.
+   * @param filters
+   * @return
+   */
+  QVector<QByteArray> computeKeys(const FilterPipeline::FilterContainerType& filters);
+
+  /**
+   * @brief contains
+   * @param key
+   * @return Whether a state is stored for the key
+   */
+  bool contains(const QByteArray& key) const;
+
+  /**
+   * @brief read Reads a stored state and marks it as used
+   * @param key
+   * @return A null pointer if the state is not stored or could not be read, in which case
+   * it is removed
+   */
+  DataContainerArray::Pointer read(const QByteArray& key);
+
+  /**
+   * @brief write Stores a state and collects the garbage
+   * @param key
+   * @param dca
+   * @param pipelinePath The file the pipeline came from, may be empty
+   * @param filterIndex The filter after which the state was taken
+   * @param filterLabel
+   * @return
+   */
+  bool write(const QByteArray& key, const DataContainerArray::Pointer& dca, const QString& pipelinePath, int filterIndex, const QString& filterLabel);
+
+  /**
+   * @brief ReadStateFile Reads every data container of a .dream3d file. The .dream3d files of
+   * all callers in this process are read and written one at a time.
+   * @param filePath
+   * @return A null pointer if the file could not be read
+   */
+  static DataContainerArray::Pointer ReadStateFile(const QString& filePath);
+
+  /**
+   * @brief WriteStateFile Writes every data container to a .dream3d file, see ReadStateFile()
+   * @param filePath
+   * @param dca
+   * @return
+   */
+  static bool WriteStateFile(const QString& filePath, const DataContainerArray::Pointer& dca);
+
+  /**
+   * @brief getEntries
+   * @return The stored states, the least recently used first
+   */
+  QVector<Entry> getEntries() const;
+
+  /**
+   * @brief collectGarbage Removes the least recently used states until the store is no
+   * larger than getMaxSize(), and the files that no sidecar refers to
+   * @return How many states were removed
+   */
+  int collectGarbage();
+
+  /**
+   * @brief clear Removes every stored state
+   * @return How many states were removed
+   */
+  int clear();
+
+protected:
+  FilterResultStore();
+
+private:
+  struct InputHash
+  {
+    qint64 size = -1;
+    qint64 lastModified = 0;
+    QByteArray sha1;
+  };
+
+  mutable QMutex m_Mutex;
+  QMutex m_FileMutex;
+  QString m_Directory;
+  bool m_Enabled = false;
+  qint64 m_MaxSize = 20480;
+  QMap<QString, InputHash> m_InputHashes;
+
+  /**
+   * @brief hashInput Returns the SHA-1 of an input file, computing it only when the file
+   * changed since the last call
+   * @param filePath
+   * @return
+   */
+  QByteArray hashInput(const QString& filePath);
+
+  FilterResultStore(const FilterResultStore&) = delete; // Copy Constructor Not Implemented
+  void operator=(const FilterResultStore&) = delete;    // Move assignment Not Implemented
+};
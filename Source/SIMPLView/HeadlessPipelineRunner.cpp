@@ -0,0 +1,487 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "HeadlessPipelineRunner.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFuture>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThreadPool>
+
+#include <hdf5.h>
+
+#include "SIMPLib/FilterParameters/H5FilterParametersReader.h"
+#include "SIMPLib/FilterParameters/JsonFilterParametersReader.h"
+#include "SIMPLib/Messages/PipelineMessage.h"
+
+#include "SIMPLView/FilterResultCache.h"
+#include "SIMPLView/FilterResultStore.h"
+#include "SIMPLView/PerformanceHistory.h"
+#include "SIMPLView/PipelineCheckpoints.h"
+#include "SIMPLView/PipelineMetrics.h"
+#include "SIMPLView/PipelineProcessPool.h"
+#include "SIMPLView/RunManifest.h"
+
+namespace
+{
+// Serializes the pipelines of the process while HDF5 is not thread safe
+QMutex s_PipelineRunMutex;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+HeadlessPipelineObserver::HeadlessPipelineObserver() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+HeadlessPipelineObserver::~HeadlessPipelineObserver() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void HeadlessPipelineObserver::setMessageCallback(const MessageCallback& callback)
+{
+  m_MessageCallback = callback;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList HeadlessPipelineObserver::getErrors() const
+{
+  return m_Errors;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<FilterProfiler::Record> HeadlessPipelineObserver::getFilterProfile()
+{
+  m_Profiler.finish();
+  return m_Profiler.getRecords();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void HeadlessPipelineObserver::processPipelineMessage(const PipelineMessage& pm)
+{
+  m_Profiler.processPipelineMessage(pm);
+
+  if(pm.getType() == PipelineMessage::MessageType::Error)
+  {
+    m_Errors.push_back(pm.generateErrorString());
+  }
+  if(m_MessageCallback)
+  {
+    m_MessageCallback(pm);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+HeadlessPipelineRunner::HeadlessPipelineRunner() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+HeadlessPipelineRunner::~HeadlessPipelineRunner() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void HeadlessPipelineRunner::setJobs(int jobs)
+{
+  m_Jobs = qMax(1, jobs);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int HeadlessPipelineRunner::getJobs() const
+{
+  return m_Jobs;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void HeadlessPipelineRunner::setProcessPool(PipelineProcessPool* pool)
+{
+  m_ProcessPool = pool;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void HeadlessPipelineRunner::setManifestDirectory(const QString& manifestDir)
+{
+  m_ManifestDirectory = manifestDir;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void HeadlessPipelineRunner::setForce(bool force)
+{
+  m_Force = force;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void HeadlessPipelineRunner::setDryRun(bool dryRun)
+{
+  m_DryRun = dryRun;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void HeadlessPipelineRunner::setProfileDirectory(const QString& profileDir)
+{
+  m_ProfileDirectory = profileDir;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void HeadlessPipelineRunner::setPipelineFiles(const QStringList& filePaths)
+{
+  m_PipelineFiles = filePaths;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<HeadlessPipelineRunner::Result> HeadlessPipelineRunner::getResults() const
+{
+  return m_Results;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int HeadlessPipelineRunner::run()
+{
+  int count = m_PipelineFiles.size();
+  m_Results.clear();
+  m_Results.resize(count);
+
+  QMutex mutex;
+  int nextFile = 0;
+  int finishedCount = 0;
+  int failedCount = 0;
+  int skippedCount = 0;
+
+  // Each worker takes the next file from the shared queue, so a long pipeline does not
+  // hold up the files behind it
+  auto worker = [&] {
+    forever
+    {
+      int index = 0;
+      {
+        QMutexLocker lock(&mutex);
+        if(nextFile >= count)
+        {
+          return;
+        }
+        index = nextFile++;
+      }
+      const QString& filePath = m_PipelineFiles[index];
+
+      // An empty reason means that the manifest of the last successful run still matches
+      QString reason = "Up-to-date checks are off";
+      QString manifestFile;
+      if(!m_ManifestDirectory.isEmpty())
+      {
+        manifestFile = RunManifest::GetFilePath(m_ManifestDirectory, filePath, QJsonObject());
+        RunManifest recorded;
+        if(m_Force)
+        {
+          reason = "Forced";
+        }
+        else if(!recorded.readFile(manifestFile))
+        {
+          reason = "No successful run was recorded";
+        }
+        else
+        {
+          reason = recorded.findChange(RunManifest::Capture(filePath, QJsonObject(), false));
+        }
+      }
+
+      if(m_DryRun)
+      {
+        QMutexLocker lock(&mutex);
+        finishedCount++;
+        QString status = reason.isEmpty() ? QString("UP TO DATE") : QString("WOULD RUN (%1)").arg(reason);
+        qDebug().noquote() << QString("[%1/%2] %3: %4").arg(finishedCount).arg(count).arg(QDir::toNativeSeparators(filePath)).arg(status);
+        m_Results[index].filePath = filePath;
+        m_Results[index].skipped = reason.isEmpty();
+        skippedCount += reason.isEmpty() ? 1 : 0;
+        continue;
+      }
+
+      Result result;
+      result.filePath = filePath;
+      result.skipped = reason.isEmpty();
+      if(result.skipped)
+      {
+        PipelineMetrics::Instance()->jobSkipped();
+      }
+      else
+      {
+        PipelineMetrics::Instance()->jobStarted();
+        result = (m_ProcessPool != nullptr) ? m_ProcessPool->runJob(filePath) : RunPipeline(filePath);
+        if(result.errorCode >= 0 && !manifestFile.isEmpty() && !RunManifest::Capture(filePath, QJsonObject(), true).writeFile(manifestFile))
+        {
+          result.errors.push_back("The run manifest could not be written to " + QDir::toNativeSeparators(manifestFile));
+        }
+        if(!m_ProfileDirectory.isEmpty())
+        {
+          QString name = QFileInfo(filePath).completeBaseName();
+          QString profileFile = QDir(m_ProfileDirectory).filePath(name);
+          if(!FilterProfiler::WriteChromeTrace(profileFile + ".trace.json", result.filterProfile, name) || !FilterProfiler::WriteCsv(profileFile + ".csv", result.filterProfile))
+          {
+            result.errors.push_back("The filter profile could not be written to " + QDir::toNativeSeparators(m_ProfileDirectory));
+          }
+        }
+        PipelineMetrics::Instance()->jobFinished(result);
+      }
+
+      QMutexLocker lock(&mutex);
+      m_Results[index] = result;
+      finishedCount++;
+      QString status = (result.errorCode < 0) ? QString("FAILED (%1)").arg(result.errorCode) : QString("OK");
+      if(result.skipped)
+      {
+        skippedCount++;
+        qDebug().noquote() << QString("[%1/%2] %3: UP TO DATE").arg(finishedCount).arg(count).arg(QDir::toNativeSeparators(filePath));
+      }
+      else
+      {
+        qDebug().noquote() << QString("[%1/%2] %3: %4 in %5 ms").arg(finishedCount).arg(count).arg(QDir::toNativeSeparators(filePath)).arg(status).arg(result.elapsedMs);
+      }
+      if(result.errorCode < 0)
+      {
+        failedCount++;
+      }
+      foreach(QString error, result.errors)
+      {
+        qDebug().noquote() << "    " << error;
+      }
+      foreach(QString warning, result.warnings)
+      {
+        qDebug().noquote() << "     SLOW:" << warning;
+      }
+      if(!result.cachedFilters.isEmpty())
+      {
+        qDebug().noquote() << "     REUSED:" << result.cachedFilters.size() << "filters from an earlier run";
+      }
+    }
+  };
+
+  if(!m_DryRun)
+  {
+    PipelineMetrics::Instance()->jobsQueued(count);
+  }
+
+  QThreadPool pool;
+  pool.setMaxThreadCount(qMin(m_Jobs, qMax(1, count)));
+  QVector<QFuture<void>> workers;
+  for(int i = 0; i < pool.maxThreadCount(); i++)
+  {
+    workers.push_back(QtConcurrent::run(&pool, worker));
+  }
+  for(QFuture<void>& future : workers)
+  {
+    future.waitForFinished();
+  }
+
+  if(m_DryRun)
+  {
+    qDebug().noquote() << QString("%1 of %2 pipelines would run").arg(count - skippedCount).arg(count);
+    return 0;
+  }
+  qDebug().noquote() << QString("%1 of %2 pipelines failed, %3 were up to date").arg(failedCount).arg(count).arg(skippedCount);
+  return (failedCount > 0) ? 1 : 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void HeadlessPipelineRunner::ApplyOverrides(QJsonObject& root, const QJsonObject& overrides)
+{
+  for(QJsonObject::const_iterator iter = overrides.constBegin(); iter != overrides.constEnd(); ++iter)
+  {
+    QJsonObject filterObject = root.value(iter.key()).toObject();
+    QJsonObject parameters = iter.value().toObject();
+    for(QJsonObject::const_iterator param = parameters.constBegin(); param != parameters.constEnd(); ++param)
+    {
+      filterObject.insert(param.key(), param.value());
+    }
+    root.insert(iter.key(), filterObject);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterPipeline::Pointer HeadlessPipelineRunner::ReadPipeline(const QString& filePath, const QJsonObject& overrides)
+{
+  QFileInfo fi(filePath);
+  if(!fi.exists())
+  {
+    return FilterPipeline::NullPointer();
+  }
+
+  if(fi.suffix().compare("json", Qt::CaseInsensitive) == 0)
+  {
+    JsonFilterParametersReader::Pointer reader = JsonFilterParametersReader::New();
+    if(overrides.isEmpty())
+    {
+      return reader->readPipelineFromFile(filePath);
+    }
+
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+      return FilterPipeline::NullPointer();
+    }
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    ApplyOverrides(root, overrides);
+    return reader->readPipelineFromString(QString::fromUtf8(QJsonDocument(root).toJson()));
+  }
+  if(overrides.isEmpty() && fi.suffix().compare("dream3d", Qt::CaseInsensitive) == 0)
+  {
+    return H5FilterParametersReader::ReadPipelineFromFile(filePath);
+  }
+  return FilterPipeline::NullPointer();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool HeadlessPipelineRunner::IsHdf5ThreadSafe()
+{
+  hbool_t threadSafe = 0;
+  if(H5is_library_threadsafe(&threadSafe) < 0)
+  {
+    return false;
+  }
+  return threadSafe > 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+HeadlessPipelineRunner::Result HeadlessPipelineRunner::RunPipeline(const QString& filePath, const QJsonObject& overrides, const HeadlessPipelineObserver::MessageCallback& callback,
+                                                                    FilterResultCache* cache)
+{
+  // Reading a .dream3d file uses HDF5 as well, so the lock covers the whole run
+  QMutexLocker runLock(IsHdf5ThreadSafe() ? nullptr : &s_PipelineRunMutex);
+
+  QElapsedTimer timer;
+  timer.start();
+
+  Result result;
+  result.filePath = filePath;
+
+  FilterPipeline::Pointer pipeline = ReadPipeline(filePath, overrides);
+  if(pipeline.get() == nullptr)
+  {
+    result.errorCode = -1;
+    result.errors.push_back("The pipeline file could not be read");
+    result.elapsedMs = timer.elapsed();
+    return result;
+  }
+
+  // The history is keyed by the inputs as they are before the run, like in the GUI
+  PerformanceHistory* history = PerformanceHistory::Instance();
+  PerformanceHistory::Run run;
+  QVector<qint64> estimates;
+  if(history->getEnabled())
+  {
+    run = PerformanceHistory::DescribeRun(pipeline, filePath);
+    estimates = history->estimateFilters(run);
+  }
+
+  HeadlessPipelineObserver observer;
+  observer.setMessageCallback(callback);
+  // Without a cache of its own the run can still resume from the states on disk
+  FilterResultCache diskOnly;
+  diskOnly.setMemoryBudget(0);
+  if(cache == nullptr && (FilterResultStore::Instance()->getEnabled() || PipelineCheckpoints::Instance()->isActive()))
+  {
+    cache = &diskOnly;
+  }
+
+  if(cache != nullptr)
+  {
+    result.errorCode = cache->execute(pipeline, filePath, &observer, result.cachedFilters);
+  }
+  else
+  {
+    pipeline->addMessageReceiver(&observer);
+    pipeline->execute();
+    result.errorCode = pipeline->getErrorCondition();
+  }
+
+  result.errors = observer.getErrors();
+  result.filterProfile = observer.getFilterProfile();
+  result.elapsedMs = timer.elapsed();
+
+  if(history->getEnabled())
+  {
+    run.elapsedMs = result.elapsedMs;
+    run.errorCode = result.errorCode;
+    PerformanceHistory::AddProfile(run, result.filterProfile);
+    result.warnings = history->findSlowFilters(run, estimates);
+    history->append(run);
+  }
+  return result;
+}
@@ -0,0 +1,245 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "SIMPLib/Common/Observer.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "SIMPLView/FilterProfiler.h"
+
+/**
+ * @brief The HeadlessPipelineObserver class keeps the error messages of one pipeline instead
+ * of printing them, so that concurrently running pipelines do not mix their output. Every
+ * message can also be passed on to a callback, which is called on the pipeline's thread.
+ */
+class HeadlessPipelineObserver : public Observer
+{
+  Q_OBJECT
+
+public:
+  using MessageCallback = std::function<void(const PipelineMessage&)>;
+
+  HeadlessPipelineObserver();
+  ~HeadlessPipelineObserver() override;
+
+  /**
+   * @brief setMessageCallback
+   * @param callback
+   */
+  void setMessageCallback(const MessageCallback& callback);
+
+  /**
+   * @brief getErrors
+   * @return
+   */
+  QStringList getErrors() const;
+
+  /**
+   * @brief getFilterProfile Returns what each filter that sent a message cost, measured
+   * from its first message to the first message of the next filter or this call
+   * @return
+   */
+  QVector<FilterProfiler::Record> getFilterProfile();
+
+public slots:
+  void processPipelineMessage(const PipelineMessage& pm) override;
+
+private:
+  QStringList m_Errors;
+  MessageCallback m_MessageCallback;
+  FilterProfiler m_Profiler;
+
+  HeadlessPipelineObserver(const HeadlessPipelineObserver&) = delete; // Copy Constructor Not Implemented
+  void operator=(const HeadlessPipelineObserver&) = delete;          // Move assignment Not Implemented
+};
+
+class FilterResultCache;
+class PipelineProcessPool;
+
+/**
+ * @brief The HeadlessPipelineRunner class executes pipeline files without any widgets. Up to
+ * getJobs() pipelines run at the same time; each worker takes the next file from a shared
+ * queue when it is done with the previous one. The plugins must have been loaded already.
+ *
+ * Nearly every pipeline reads or writes HDF5 files, and the HDF5 library must not be entered
+ * from two threads at once unless it was built thread safe (IsHdf5ThreadSafe()). Otherwise
+ * RunPipeline() runs one pipeline of the process at a time, and pipelines only run in
+ * parallel on the worker processes of a PipelineProcessPool.
+ */
+class HeadlessPipelineRunner
+{
+public:
+  /**
+   * @brief The outcome of one pipeline file
+   */
+  struct Result
+  {
+    QString filePath;
+    int errorCode = 0;
+    qint64 elapsedMs = 0;
+    QStringList errors;
+    QStringList warnings;
+    bool skipped = false;
+    QVector<FilterProfiler::Record> filterProfile;
+    qint64 peakMemoryMB = 0;
+    qint64 bytesRead = 0;
+    qint64 bytesWritten = 0;
+    QVector<int> cachedFilters;
+  };
+
+  HeadlessPipelineRunner();
+  virtual ~HeadlessPipelineRunner();
+
+  /**
+   * @brief setJobs Sets how many pipelines may run at the same time
+   * @param jobs
+   */
+  void setJobs(int jobs);
+
+  /**
+   * @brief getJobs
+   * @return
+   */
+  int getJobs() const;
+
+  /**
+   * @brief setProcessPool Runs every pipeline on a worker process of the pool instead of a
+   * thread of this process. The pool must have been started and outlive run().
+   * @param pool
+   */
+  void setProcessPool(PipelineProcessPool* pool);
+
+  /**
+   * @brief setManifestDirectory Turns on the up-to-date check: a pipeline is skipped when the
+   * RunManifest of its last successful run, kept in this directory, still matches. Empty turns
+   * the check off.
+   * @param manifestDir
+   */
+  void setManifestDirectory(const QString& manifestDir);
+
+  /**
+   * @brief setForce Runs every pipeline even if it is up to date, and records its manifest
+   * @param force
+   */
+  void setForce(bool force);
+
+  /**
+   * @brief setDryRun Makes run() only print which pipelines would run and why
+   * @param dryRun
+   */
+  void setDryRun(bool dryRun);
+
+  /**
+   * @brief setProfileDirectory Makes run() write the filter profile of every pipeline that ran
+   * to <directory>/<pipeline name>.trace.json and .csv, see FilterProfiler
+   * @param profileDir
+   */
+  void setProfileDirectory(const QString& profileDir);
+
+  /**
+   * @brief setPipelineFiles Sets the .json or .dream3d files to execute
+   * @param filePaths
+   */
+  void setPipelineFiles(const QStringList& filePaths);
+
+  /**
+   * @brief run Executes every pipeline file and prints one line per file
+   * @return 0 if every pipeline succeeded and 1 otherwise, for use as the process exit code
+   */
+  int run();
+
+  /**
+   * @brief getResults Returns the results of the last run() in the order of the files
+   * @return
+   */
+  QVector<Result> getResults() const;
+
+  /**
+   * @brief ApplyOverrides Replaces filter parameters in the JSON root of a pipeline file
+   * @param root
+   * @param overrides Filter parameters keyed by the index of the filter like the file itself:
+   * {"0": {"OutputFile": "/tmp/out.dream3d"}}
+   */
+  static void ApplyOverrides(QJsonObject& root, const QJsonObject& overrides);
+
+  /**
+   * @brief ReadPipeline Reads the pipeline stored in a .json or .dream3d file
+   * @param filePath
+   * @param overrides Filter parameters that replace the ones in a .json file, see
+   * ApplyOverrides(). A .dream3d file cannot be read with overrides.
+   * @return The pipeline or a null pointer if the file could not be read
+   */
+  static FilterPipeline::Pointer ReadPipeline(const QString& filePath, const QJsonObject& overrides = QJsonObject());
+
+  /**
+   * @brief RunPipeline Reads and executes one pipeline file on the calling thread. Waits for
+   * the pipelines that other threads run unless IsHdf5ThreadSafe().
+   * @param filePath
+   * @param overrides See ReadPipeline()
+   * @param callback Receives every message of the pipeline, may be empty
+   * @param cache Skips the filters whose results it kept from an earlier run, may be null
+   * @return
+   */
+  static Result RunPipeline(const QString& filePath, const QJsonObject& overrides = QJsonObject(),
+                            const HeadlessPipelineObserver::MessageCallback& callback = HeadlessPipelineObserver::MessageCallback(), FilterResultCache* cache = nullptr);
+
+  /**
+   * @brief IsHdf5ThreadSafe Returns whether the HDF5 library was built thread safe, so that
+   * several pipelines may run on the threads of one process
+   * @return
+   */
+  static bool IsHdf5ThreadSafe();
+
+private:
+  int m_Jobs = 1;
+  PipelineProcessPool* m_ProcessPool = nullptr;
+  QString m_ManifestDirectory;
+  bool m_Force = false;
+  bool m_DryRun = false;
+  QString m_ProfileDirectory;
+  QStringList m_PipelineFiles;
+  QVector<Result> m_Results;
+
+  HeadlessPipelineRunner(const HeadlessPipelineRunner&) = delete; // Copy Constructor Not Implemented
+  void operator=(const HeadlessPipelineRunner&) = delete;        // Move assignment Not Implemented
+};
@@ -0,0 +1,146 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "LazyFilterFactory.h"
+
+#include "SIMPLib/Filtering/FilterManager.h"
+
+#include "SIMPLView/SIMPLViewPluginLoader.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+LazyFilterFactory::LazyFilterFactory(const PluginManifest::FilterEntry& entry, const QString& pluginFilePath, SIMPLViewPluginLoader* loader)
+: m_Entry(entry)
+, m_PluginFilePath(pluginFilePath)
+, m_Loader(loader)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+LazyFilterFactory::~LazyFilterFactory() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer LazyFilterFactory::create() const
+{
+  if(m_Loader.isNull())
+  {
+    return AbstractFilter::NullPointer();
+  }
+
+  // Activating the plugin replaces this proxy in the FilterManager, which may release
+  // the last reference to it, so nothing from 'this' is touched afterwards.
+  QString className = m_Entry.className;
+  if(!m_Loader->activatePlugin(m_PluginFilePath))
+  {
+    return AbstractFilter::NullPointer();
+  }
+
+  IFilterFactory::Pointer factory = FilterManager::Instance()->getFactoryFromClassName(className);
+  if(factory.get() == nullptr || std::dynamic_pointer_cast<LazyFilterFactory>(factory).get() != nullptr)
+  {
+    // The plugin no longer provides this filter
+    return AbstractFilter::NullPointer();
+  }
+  return factory->create();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString LazyFilterFactory::getFilterClassName() const
+{
+  return m_Entry.className;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString LazyFilterFactory::getFilterGroup() const
+{
+  return m_Entry.group;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString LazyFilterFactory::getFilterSubGroup() const
+{
+  return m_Entry.subGroup;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString LazyFilterFactory::getFilterHumanLabel() const
+{
+  return m_Entry.humanLabel;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString LazyFilterFactory::getBrandingString() const
+{
+  return m_Entry.brandingString;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString LazyFilterFactory::getCompiledLibraryName() const
+{
+  return m_Entry.compiledLibraryName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QUuid LazyFilterFactory::getUuid()
+{
+  return m_Entry.uuid;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString LazyFilterFactory::getPluginFilePath() const
+{
+  return m_PluginFilePath;
+}
@@ -0,0 +1,100 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QPointer>
+#include <QtCore/QString>
+#include <QtCore/QUuid>
+
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+#include "SIMPLib/Filtering/IFilterFactory.hpp"
+
+#include "SIMPLView/PluginManifest.h"
+
+class SIMPLViewPluginLoader;
+
+/**
+ * @brief The LazyFilterFactory class stands in for the filter factory of a plugin that has
+ * not been opened yet. It describes the filter from its manifest entry so the filter can be
+ * listed and searched for. The first call to create() activates the plugin, which replaces
+ * this proxy with the real factory in the FilterManager, and then creates the filter from
+ * the real factory.
+ */
+class LazyFilterFactory : public IFilterFactory
+{
+public:
+  SIMPL_SHARED_POINTERS(LazyFilterFactory)
+
+  static Pointer New(const PluginManifest::FilterEntry& entry, const QString& pluginFilePath, SIMPLViewPluginLoader* loader)
+  {
+    Pointer sharedPtr(new LazyFilterFactory(entry, pluginFilePath, loader));
+    return sharedPtr;
+  }
+
+  ~LazyFilterFactory() override;
+
+  /**
+   * @brief create Activates the plugin and creates the filter from the real factory
+   * @return
+   */
+  AbstractFilter::Pointer create() const override;
+
+  QString getFilterClassName() const override;
+  QString getFilterGroup() const override;
+  QString getFilterSubGroup() const override;
+  QString getFilterHumanLabel() const override;
+  QString getBrandingString() const override;
+  QString getCompiledLibraryName() const override;
+  QUuid getUuid() override;
+
+  /**
+   * @brief getPluginFilePath Returns the plugin library that provides the filter
+   * @return
+   */
+  QString getPluginFilePath() const;
+
+protected:
+  LazyFilterFactory(const PluginManifest::FilterEntry& entry, const QString& pluginFilePath, SIMPLViewPluginLoader* loader);
+
+private:
+  PluginManifest::FilterEntry m_Entry;
+  QString m_PluginFilePath;
+  QPointer<SIMPLViewPluginLoader> m_Loader;
+
+  LazyFilterFactory(const LazyFilterFactory&) = delete; // Copy Constructor Not Implemented
+  void operator=(const LazyFilterFactory&) = delete;    // Move assignment Not Implemented
+};
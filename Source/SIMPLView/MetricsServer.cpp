@@ -0,0 +1,218 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "MetricsServer.h"
+
+#include <QtCore/QTimer>
+
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+#include "SIMPLView/PipelineMetrics.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void answerRequest(QTcpSocket* socket)
+{
+  QByteArray request = socket->peek(8192);
+  if(!request.contains("\r\n\r\n") && !request.contains("\n\n"))
+  {
+    if(request.size() >= 8192)
+    {
+      socket->abort();
+    }
+    return;
+  }
+
+  QList<QByteArray> requestLine = request.left(request.indexOf('\n')).trimmed().split(' ');
+  QByteArray path = (requestLine.size() > 1) ? requestLine[1] : QByteArray();
+  QByteArray status = "200 OK";
+  QByteArray body;
+  if(requestLine[0] != "GET")
+  {
+    status = "405 Method Not Allowed";
+  }
+  else if(path == "/metrics" || path == "/")
+  {
+    body = PipelineMetrics::Instance()->toText().toUtf8();
+  }
+  else
+  {
+    status = "404 Not Found";
+  }
+
+  socket->readAll();
+  socket->write("HTTP/1.0 " + status + "\r\n");
+  socket->write("Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n");
+  socket->write("Content-Length: " + QByteArray::number(body.size()) + "\r\n");
+  socket->write("Connection: close\r\n\r\n");
+  socket->write(body);
+  socket->disconnectFromHost();
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+MetricsServer::MetricsServer(QObject* parent)
+: QThread(parent)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+MetricsServer::~MetricsServer()
+{
+  stopServing();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MetricsServer::setPort(quint16 port)
+{
+  m_Port = port;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MetricsServer::setFilePath(const QString& filePath)
+{
+  m_FilePath = filePath;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MetricsServer::setInterval(int seconds)
+{
+  m_Interval = qMax(1, seconds);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int MetricsServer::getInterval() const
+{
+  return m_Interval;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString MetricsServer::getErrorString() const
+{
+  return m_ErrorString;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool MetricsServer::startServing()
+{
+  if(m_Port == 0 && m_FilePath.isEmpty())
+  {
+    return true;
+  }
+  m_ErrorString.clear();
+  start();
+  m_Started.acquire();
+  if(!m_ErrorString.isEmpty())
+  {
+    wait();
+    return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MetricsServer::stopServing()
+{
+  if(!isRunning())
+  {
+    return;
+  }
+  quit();
+  wait();
+  if(!m_FilePath.isEmpty())
+  {
+    PipelineMetrics::Instance()->writeFile(m_FilePath);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MetricsServer::run()
+{
+  // Both objects live in this thread, so their signals are delivered by exec() below
+  QTcpServer server;
+  if(m_Port > 0)
+  {
+    if(!server.listen(QHostAddress::LocalHost, m_Port))
+    {
+      m_ErrorString = server.errorString();
+      m_Started.release();
+      return;
+    }
+    connect(&server, &QTcpServer::newConnection, &server, [&server] {
+      while(QTcpSocket* socket = server.nextPendingConnection())
+      {
+        connect(socket, &QTcpSocket::readyRead, socket, [socket] { answerRequest(socket); });
+        connect(socket, &QTcpSocket::disconnected, socket, &QTcpSocket::deleteLater);
+      }
+    });
+  }
+
+  QTimer timer;
+  if(!m_FilePath.isEmpty())
+  {
+    QString filePath = m_FilePath;
+    connect(&timer, &QTimer::timeout, &timer, [filePath] { PipelineMetrics::Instance()->writeFile(filePath); });
+    timer.start(m_Interval * 1000);
+    PipelineMetrics::Instance()->writeFile(filePath);
+  }
+
+  m_Started.release();
+  exec();
+}
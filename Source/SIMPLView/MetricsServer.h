@@ -0,0 +1,109 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QSemaphore>
+#include <QtCore/QString>
+#include <QtCore/QThread>
+
+/**
+ * @brief The MetricsServer class publishes PipelineMetrics from a thread of its own, so that
+ * the metrics stay available while the main thread blocks on a headless run. It answers
+ * "GET /metrics" with HTTP on a local port and, if a file is set, replaces that file with the
+ * same text every getInterval() seconds for collectors that scrape files instead.
+ */
+class MetricsServer : public QThread
+{
+  Q_OBJECT
+
+public:
+  MetricsServer(QObject* parent = nullptr);
+  ~MetricsServer() override;
+
+  /**
+   * @brief setPort Sets the local port to answer on. 0 disables HTTP.
+   * @param port
+   */
+  void setPort(quint16 port);
+
+  /**
+   * @brief setFilePath Sets the file that is written periodically. Empty disables it.
+   * @param filePath
+   */
+  void setFilePath(const QString& filePath);
+
+  /**
+   * @brief setInterval Sets the seconds between two writes of the file
+   * @param seconds
+   */
+  void setInterval(int seconds);
+
+  /**
+   * @brief getInterval
+   * @return
+   */
+  int getInterval() const;
+
+  /**
+   * @brief startServing Starts the thread and waits until it listens
+   * @return false if the port could not be opened
+   */
+  bool startServing();
+
+  /**
+   * @brief stopServing Stops the thread and writes the file a last time
+   */
+  void stopServing();
+
+  /**
+   * @brief getErrorString Returns why startServing() failed
+   * @return
+   */
+  QString getErrorString() const;
+
+protected:
+  void run() override;
+
+private:
+  quint16 m_Port = 0;
+  QString m_FilePath;
+  int m_Interval = 15;
+  QString m_ErrorString;
+  QSemaphore m_Started;
+
+  MetricsServer(const MetricsServer&) = delete; // Copy Constructor Not Implemented
+  void operator=(const MetricsServer&) = delete; // Move assignment Not Implemented
+};
@@ -0,0 +1,547 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ParameterSweep.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMap>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTextStream>
+
+#include "SIMPLib/FilterParameters/JsonFilterParametersReader.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+#include "SIMPLib/Messages/PipelineMessage.h"
+
+#include "SIMPLView/HeadlessPipelineRunner.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+// Replaces the sweep's placeholders in every string of a JSON value
+// -----------------------------------------------------------------------------
+QJsonValue substitutePlaceholders(const QJsonValue& value, const QString& variantName, const QString& outputDir)
+{
+  if(value.isString())
+  {
+    QString text = value.toString();
+    text.replace("@VARIANT@", variantName);
+    text.replace("@OUTPUT_DIR@", outputDir);
+    return text;
+  }
+  if(value.isArray())
+  {
+    QJsonArray array = value.toArray();
+    for(int i = 0; i < array.size(); i++)
+    {
+      array[i] = substitutePlaceholders(array[i], variantName, outputDir);
+    }
+    return array;
+  }
+  if(value.isObject())
+  {
+    QJsonObject object = value.toObject();
+    for(QJsonObject::iterator iter = object.begin(); iter != object.end(); ++iter)
+    {
+      iter.value() = substitutePlaceholders(iter.value(), variantName, outputDir);
+    }
+    return object;
+  }
+  return value;
+}
+
+// -----------------------------------------------------------------------------
+// Splits one CSV line. Quoted cells may hold commas and doubled quotes.
+// -----------------------------------------------------------------------------
+QStringList splitCsvLine(const QString& line)
+{
+  QStringList cells;
+  QString cell;
+  bool quoted = false;
+  for(int i = 0; i < line.size(); i++)
+  {
+    QChar c = line[i];
+    if(quoted)
+    {
+      if(c == '"' && i + 1 < line.size() && line[i + 1] == '"')
+      {
+        cell += c;
+        i++;
+      }
+      else if(c == '"')
+      {
+        quoted = false;
+      }
+      else
+      {
+        cell += c;
+      }
+    }
+    else if(c == '"')
+    {
+      quoted = true;
+    }
+    else if(c == ',')
+    {
+      cells.push_back(cell.trimmed());
+      cell.clear();
+    }
+    else
+    {
+      cell += c;
+    }
+  }
+  cells.push_back(cell.trimmed());
+  return cells;
+}
+
+// -----------------------------------------------------------------------------
+// A cell is a JSON value if it parses as one (numbers, booleans, arrays, objects)
+// and a string otherwise
+// -----------------------------------------------------------------------------
+QJsonValue parseCsvValue(const QString& cell)
+{
+  QJsonParseError error;
+  QJsonDocument doc = QJsonDocument::fromJson(QString("[%1]").arg(cell).toUtf8(), &error);
+  if(error.error == QJsonParseError::NoError && doc.array().size() == 1)
+  {
+    return doc.array().at(0);
+  }
+  return cell;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString csvCell(const QString& text)
+{
+  QString cell = text;
+  if(cell.contains(',') || cell.contains('"'))
+  {
+    cell.replace("\"", "\"\"");
+    cell = "\"" + cell + "\"";
+  }
+  return cell;
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ParameterSweep::ParameterSweep()
+: m_OutputDirectory(QDir::currentPath())
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ParameterSweep::~ParameterSweep() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ParameterSweep::setPipelineFile(const QString& filePath)
+{
+  m_PipelineFile = filePath;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ParameterSweep::setOutputDirectory(const QString& path)
+{
+  m_OutputDirectory = QDir(path).absolutePath();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ParameterSweep::setOverrides(const QVector<QJsonObject>& overrides)
+{
+  m_Variants.clear();
+  for(int i = 0; i < overrides.size(); i++)
+  {
+    Variant variant;
+    variant.name = QString("variant_%1").arg(i, 4, 10, QChar('0'));
+    variant.overrides = overrides[i];
+    m_Variants.push_back(variant);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<ParameterSweep::Variant> ParameterSweep::getVariants() const
+{
+  return m_Variants;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ParameterSweep::getFilterExecutionCount() const
+{
+  return m_FilterExecutions;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ParameterSweep::run()
+{
+  QFile file(m_PipelineFile);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    qDebug().noquote() << "Could not open" << QDir::toNativeSeparators(m_PipelineFile);
+    return 1;
+  }
+  QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+  QDir().mkpath(m_OutputDirectory);
+
+  m_Filters.clear();
+  m_Filters.resize(m_Variants.size());
+  m_FilterKeys.clear();
+  m_FilterKeys.resize(m_Variants.size());
+  m_FilterCount = -1;
+  m_FilterExecutions = 0;
+
+  QVector<int> runnable;
+  for(int i = 0; i < m_Variants.size(); i++)
+  {
+    Variant& variant = m_Variants[i];
+    variant.errorCode = 0;
+    variant.elapsedMs = 0;
+    variant.attributedMs = 0;
+    variant.errors.clear();
+    if(prepareVariant(root, i))
+    {
+      runnable.push_back(i);
+    }
+  }
+
+  if(!runnable.isEmpty())
+  {
+    runNode(0, runnable, DataContainerArray::New(), 0);
+  }
+
+  int failedCount = 0;
+  foreach(Variant variant, m_Variants)
+  {
+    QString status = (variant.errorCode < 0) ? QString("FAILED (%1)").arg(variant.errorCode) : QString("OK");
+    QString parameters = QString::fromUtf8(QJsonDocument(variant.overrides).toJson(QJsonDocument::Compact));
+    qDebug().noquote() << QString("%1: %2 in %3 ms (%4 ms attributed) %5").arg(variant.name).arg(status).arg(variant.elapsedMs).arg(variant.attributedMs).arg(parameters);
+    if(variant.errorCode < 0)
+    {
+      failedCount++;
+      foreach(QString error, variant.errors)
+      {
+        qDebug().noquote() << "    " << error;
+      }
+    }
+  }
+
+  qDebug().noquote() << QString("%1 of %2 variants failed. %3 filters executed instead of %4.")
+                            .arg(failedCount)
+                            .arg(m_Variants.size())
+                            .arg(m_FilterExecutions)
+                            .arg(runnable.size() * qMax(0, m_FilterCount));
+
+  QString summaryPath = QDir(m_OutputDirectory).filePath("SweepSummary.csv");
+  if(!writeSummary(summaryPath))
+  {
+    qDebug().noquote() << "Could not write" << QDir::toNativeSeparators(summaryPath);
+  }
+  return (failedCount > 0) ? 1 : 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ParameterSweep::prepareVariant(const QJsonObject& root, int index)
+{
+  Variant& variant = m_Variants[index];
+
+  QJsonObject variantRoot = root;
+  HeadlessPipelineRunner::ApplyOverrides(variantRoot, variant.overrides);
+  variantRoot = substitutePlaceholders(variantRoot, variant.name, m_OutputDirectory).toObject();
+
+  JsonFilterParametersReader::Pointer reader = JsonFilterParametersReader::New();
+  FilterPipeline::Pointer pipeline = reader->readPipelineFromString(QString::fromUtf8(QJsonDocument(variantRoot).toJson()));
+  if(pipeline.get() == nullptr)
+  {
+    variant.errorCode = -1;
+    variant.errors.push_back("The pipeline could not be read with these parameters");
+    return false;
+  }
+
+  HeadlessPipelineObserver observer;
+  pipeline->addMessageReceiver(&observer);
+  int preflightError = pipeline->preflightPipeline();
+  pipeline->removeMessageReceiver(&observer);
+  if(preflightError < 0)
+  {
+    variant.errorCode = preflightError;
+    variant.errors = observer.getErrors();
+    variant.errors.push_front("The pipeline failed to preflight");
+    return false;
+  }
+
+  FilterPipeline::FilterContainerType filters = pipeline->getFilterContainer();
+  if(m_FilterCount < 0)
+  {
+    m_FilterCount = filters.size();
+  }
+  if(filters.size() != m_FilterCount)
+  {
+    variant.errorCode = -1;
+    variant.errors.push_back("The parameters changed the number of filters");
+    return false;
+  }
+
+  // Two variants share a filter if its parameters are the same. The filters before it are
+  // compared on the way down the tree.
+  for(int i = 0; i < filters.size(); i++)
+  {
+    m_Filters[index].push_back(filters[i]);
+    m_FilterKeys[index].push_back(QString::fromUtf8(QJsonDocument(variantRoot.value(QString::number(i)).toObject()).toJson(QJsonDocument::Compact)));
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ParameterSweep::runNode(int depth, const QVector<int>& variants, const DataContainerArray::Pointer& dca, qint64 pathMs)
+{
+  if(depth == m_FilterCount)
+  {
+    for(int index : variants)
+    {
+      m_Variants[index].elapsedMs = pathMs;
+    }
+    return;
+  }
+
+  // Branches keep the order of their first variant
+  QVector<QVector<int>> branches;
+  QMap<QString, int> branchIndex;
+  for(int index : variants)
+  {
+    const QString& key = m_FilterKeys[index][depth];
+    if(!branchIndex.contains(key))
+    {
+      branchIndex.insert(key, branches.size());
+      branches.push_back(QVector<int>());
+    }
+    branches[branchIndex[key]].push_back(index);
+  }
+
+  for(int b = 0; b < branches.size(); b++)
+  {
+    const QVector<int>& branch = branches[b];
+
+    // The last branch can take over the data, the others need a copy made before any
+    // branch changes it
+    DataContainerArray::Pointer branchDca = (b + 1 == branches.size()) ? dca : dca->deepCopy(false);
+
+    AbstractFilter::Pointer filter = m_Filters[branch.first()][depth];
+    qint64 filterMs = 0;
+    int errorCode = 0;
+    QStringList errors;
+    if(filter->getEnabled())
+    {
+      HeadlessPipelineObserver observer;
+      QObject::connect(filter.get(), SIGNAL(filterGeneratedMessage(const PipelineMessage&)), &observer, SLOT(processPipelineMessage(const PipelineMessage&)));
+
+      QElapsedTimer timer;
+      timer.start();
+      filter->setDataContainerArray(branchDca);
+      filter->execute();
+      filterMs = timer.elapsed();
+      m_FilterExecutions++;
+
+      errorCode = filter->getErrorCondition();
+      errors = observer.getErrors();
+    }
+
+    for(int index : branch)
+    {
+      m_Variants[index].attributedMs += filterMs / branch.size();
+    }
+
+    if(errorCode < 0)
+    {
+      for(int index : branch)
+      {
+        m_Variants[index].errorCode = errorCode;
+        m_Variants[index].errors = errors;
+        m_Variants[index].elapsedMs = pathMs + filterMs;
+      }
+      continue;
+    }
+
+    runNode(depth + 1, branch, branchDca, pathMs + filterMs);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ParameterSweep::writeSummary(const QString& filePath) const
+{
+  QSaveFile file(filePath);
+  if(!file.open(QIODevice::WriteOnly | QIODevice::Text))
+  {
+    return false;
+  }
+
+  QTextStream out(&file);
+  out << "Variant,Parameters,Error Code,Elapsed (ms),Attributed (ms)\n";
+  foreach(Variant variant, m_Variants)
+  {
+    QString parameters = QString::fromUtf8(QJsonDocument(variant.overrides).toJson(QJsonDocument::Compact));
+    out << variant.name << "," << csvCell(parameters) << "," << variant.errorCode << "," << variant.elapsedMs << "," << variant.attributedMs << "\n";
+  }
+  out.flush();
+  return file.commit();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<QJsonObject> ParameterSweep::ExpandGrid(const QJsonObject& grid)
+{
+  QStringList filterKeys;
+  QStringList parameterKeys;
+  QVector<QJsonArray> values;
+  for(QJsonObject::const_iterator filter = grid.constBegin(); filter != grid.constEnd(); ++filter)
+  {
+    QJsonObject parameters = filter.value().toObject();
+    for(QJsonObject::const_iterator param = parameters.constBegin(); param != parameters.constEnd(); ++param)
+    {
+      // A single value is a grid axis with one entry
+      QJsonArray axis = param.value().isArray() ? param.value().toArray() : QJsonArray({param.value()});
+      if(axis.isEmpty())
+      {
+        return QVector<QJsonObject>();
+      }
+      filterKeys.push_back(filter.key());
+      parameterKeys.push_back(param.key());
+      values.push_back(axis);
+    }
+  }
+
+  QVector<QJsonObject> combinations(1);
+  for(int axis = 0; axis < values.size(); axis++)
+  {
+    QVector<QJsonObject> expanded;
+    for(const QJsonObject& combination : combinations)
+    {
+      for(const QJsonValue& value : values[axis])
+      {
+        QJsonObject overrides = combination;
+        QJsonObject filterObject = overrides.value(filterKeys[axis]).toObject();
+        filterObject.insert(parameterKeys[axis], value);
+        overrides.insert(filterKeys[axis], filterObject);
+        expanded.push_back(overrides);
+      }
+    }
+    combinations = expanded;
+  }
+  return combinations;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<QJsonObject> ParameterSweep::ReadOverridesFile(const QString& filePath, QString& errorMessage)
+{
+  QFile file(filePath);
+  if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    errorMessage = QString("Could not open %1").arg(QDir::toNativeSeparators(filePath));
+    return QVector<QJsonObject>();
+  }
+
+  if(QFileInfo(filePath).suffix().compare("csv", Qt::CaseInsensitive) != 0)
+  {
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if(error.error != QJsonParseError::NoError || !doc.isObject())
+    {
+      errorMessage = QString("%1 is not a parameter grid: %2").arg(QDir::toNativeSeparators(filePath)).arg(error.errorString());
+      return QVector<QJsonObject>();
+    }
+    return ExpandGrid(doc.object());
+  }
+
+  QTextStream in(&file);
+  QStringList header = splitCsvLine(in.readLine());
+  for(const QString& column : header)
+  {
+    if(column.indexOf('/') < 1)
+    {
+      errorMessage = QString("The column '%1' does not have the form <filter index>/<parameter>").arg(column);
+      return QVector<QJsonObject>();
+    }
+  }
+
+  QVector<QJsonObject> rows;
+  while(!in.atEnd())
+  {
+    QString line = in.readLine();
+    if(line.trimmed().isEmpty())
+    {
+      continue;
+    }
+    QStringList cells = splitCsvLine(line);
+    QJsonObject overrides;
+    for(int i = 0; i < header.size() && i < cells.size(); i++)
+    {
+      QString filterKey = header[i].section('/', 0, 0);
+      QJsonObject filterObject = overrides.value(filterKey).toObject();
+      filterObject.insert(header[i].section('/', 1), parseCsvValue(cells[i]));
+      overrides.insert(filterKey, filterObject);
+    }
+    rows.push_back(overrides);
+  }
+  return rows;
+}
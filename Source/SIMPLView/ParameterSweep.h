@@ -0,0 +1,172 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+/**
+ * @brief The ParameterSweep class executes one pipeline file many times with different filter
+ * parameters. The variants form a prefix tree: a filter whose parameters are the same for
+ * several variants, and whose upstream filters are also the same, is executed once, and its
+ * data is copied only where the variants start to differ.
+ *
+ * The variants are either the cartesian product of a grid
+ * @code
+ *   {"5": {"MinAllowedDefectSize": [10, 20, 40]}, "7": {"Tolerance": [0.5, 1.0]}}
+ * @endcode
+ * or the rows of a CSV file whose header names the parameters as "5/MinAllowedDefectSize".
+ * Variant i is named "variant_000i". In every string parameter "@VARIANT@" is replaced with
+ * that name and "@OUTPUT_DIR@" with the output directory, so that writer filters produce
+ * deterministic file names. run() writes SweepSummary.csv to the output directory.
+ *
+ * The plugins must have been loaded already.
+ */
+class ParameterSweep
+{
+public:
+  /**
+   * @brief The outcome of one variant
+   */
+  struct Variant
+  {
+    QString name;
+    QJsonObject overrides;
+    int errorCode = 0;
+    qint64 elapsedMs = 0;
+    qint64 attributedMs = 0;
+    QStringList errors;
+  };
+
+  ParameterSweep();
+  virtual ~ParameterSweep();
+
+  /**
+   * @brief setPipelineFile Sets the .json pipeline file to sweep
+   * @param filePath
+   */
+  void setPipelineFile(const QString& filePath);
+
+  /**
+   * @brief setOutputDirectory Sets what "@OUTPUT_DIR@" is replaced with and where the summary
+   * is written
+   * @param path
+   */
+  void setOutputDirectory(const QString& path);
+
+  /**
+   * @brief setOverrides Sets one set of overrides per variant, see
+   * HeadlessPipelineRunner::ApplyOverrides()
+   * @param overrides
+   */
+  void setOverrides(const QVector<QJsonObject>& overrides);
+
+  /**
+   * @brief run Executes every variant and prints the summary table
+   * @return 0 if every variant succeeded and 1 otherwise, for use as the process exit code
+   */
+  int run();
+
+  /**
+   * @brief getVariants Returns the variants with the outcome of the last run()
+   * @return
+   */
+  QVector<Variant> getVariants() const;
+
+  /**
+   * @brief getFilterExecutionCount Returns how many filters the last run() executed
+   * @return
+   */
+  int getFilterExecutionCount() const;
+
+  /**
+   * @brief writeSummary Writes one CSV line per variant with its parameters and timings
+   * @param filePath
+   * @return
+   */
+  bool writeSummary(const QString& filePath) const;
+
+  /**
+   * @brief ExpandGrid Returns the overrides of every combination of the grid's values. The
+   * last parameter varies fastest.
+   * @param grid
+   * @return
+   */
+  static QVector<QJsonObject> ExpandGrid(const QJsonObject& grid);
+
+  /**
+   * @brief ReadOverridesFile Reads the variants from a .json grid or a .csv file
+   * @param filePath
+   * @param errorMessage Set if the file could not be read
+   * @return
+   */
+  static QVector<QJsonObject> ReadOverridesFile(const QString& filePath, QString& errorMessage);
+
+private:
+  QString m_PipelineFile;
+  QString m_OutputDirectory;
+  QVector<Variant> m_Variants;
+  QVector<QVector<AbstractFilter::Pointer>> m_Filters;
+  QVector<QStringList> m_FilterKeys;
+  int m_FilterCount = 0;
+  int m_FilterExecutions = 0;
+
+  /**
+   * @brief prepareVariant Reads the pipeline of one variant and preflights it
+   * @param root The JSON root of the pipeline file
+   * @param index
+   * @return False if the variant cannot be executed
+   */
+  bool prepareVariant(const QJsonObject& root, int index);
+
+  /**
+   * @brief runNode Executes the filter at depth once per distinct set of parameters among the
+   * variants and descends into each branch
+   * @param depth
+   * @param variants The variants that share every filter before depth
+   * @param dca The data after the filters before depth. Handed to the last branch.
+   * @param pathMs The time the filters before depth took
+   */
+  void runNode(int depth, const QVector<int>& variants, const DataContainerArray::Pointer& dca, qint64 pathMs);
+
+  ParameterSweep(const ParameterSweep&) = delete; // Copy Constructor Not Implemented
+  void operator=(const ParameterSweep&) = delete; // Move assignment Not Implemented
+};
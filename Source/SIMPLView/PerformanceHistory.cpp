@@ -0,0 +1,633 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PerformanceHistory.h"
+
+#include <algorithm>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QSysInfo>
+#include <QtCore/QTextStream>
+
+#include "SIMPLib/Plugin/ISIMPLibPlugin.h"
+#include "SIMPLib/Plugin/PluginManager.h"
+
+#include "SIMPLView/RunManifest.h"
+
+namespace
+{
+// Older samples of a key are dropped, so that the estimates follow the recent runs
+const int k_MaxSamplesPerKey = 20;
+
+// A filter shorter than this is not reported as slow, however it compares
+const qint64 k_MinSlowFilterUs = 1000000;
+
+// Thousands of runs of a long pipeline, which is plenty for the samples that are kept
+const qint64 k_DefaultMaxFileSize = 32 * 1024 * 1024;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString sampleKey(const QString& host, const PerformanceHistory::FilterEntry& filter)
+{
+  return host + "|" + filter.filterUuid + "|" + QString::fromLatin1(filter.parameterHash);
+}
+
+// -----------------------------------------------------------------------------
+// Matches the filter with any parameters, for when the exact ones have not been seen
+// -----------------------------------------------------------------------------
+QString looseSampleKey(const QString& host, const PerformanceHistory::FilterEntry& filter)
+{
+  return host + "|" + filter.filterUuid;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString formatSeconds(qint64 us)
+{
+  return QString::number(us / 1000000.0, 'f', 2) + " s";
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PerformanceHistory::PerformanceHistory()
+: m_FilePath(GetDefaultFilePath())
+, m_MaxFileSize(k_DefaultMaxFileSize)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PerformanceHistory::~PerformanceHistory() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PerformanceHistory* PerformanceHistory::Instance()
+{
+  static PerformanceHistory self;
+  return &self;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PerformanceHistory::GetDefaultFilePath()
+{
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/PerformanceHistory.jsonl";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PerformanceHistory::setFilePath(const QString& filePath)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_FilePath = filePath;
+  m_ReadOffset = 0;
+  m_RotatedFileRead = false;
+  m_Samples.clear();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PerformanceHistory::getFilePath() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return m_FilePath;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PerformanceHistory::getRotatedFilePath() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return m_FilePath + ".1";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PerformanceHistory::setMaxFileSize(qint64 bytes)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_MaxFileSize = bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 PerformanceHistory::getMaxFileSize() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return m_MaxFileSize;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PerformanceHistory::setEnabled(bool enabled)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_Enabled = enabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PerformanceHistory::getEnabled() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return m_Enabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PerformanceHistory::setSlowdownFactor(double factor)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_SlowdownFactor = qMax(1.0, factor);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double PerformanceHistory::getSlowdownFactor() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return m_SlowdownFactor;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PerformanceHistory::Run PerformanceHistory::DescribeRun(const FilterPipeline::Pointer& pipeline, const QString& pipelinePath)
+{
+  Run run;
+  run.time = QDateTime::currentMSecsSinceEpoch();
+  run.host = QSysInfo::machineHostName();
+  run.pipelinePath = pipelinePath.isEmpty() ? QString() : QFileInfo(pipelinePath).absoluteFilePath();
+
+  QCryptographicHash pipelineHash(QCryptographicHash::Sha1);
+  QStringList inputs;
+  QStringList outputs;
+  if(pipeline.get() != nullptr)
+  {
+    FilterPipeline::FilterContainerType filters = pipeline->getFilterContainer();
+    for(int i = 0; i < filters.size(); i++)
+    {
+      QJsonObject parameters;
+      filters[i]->writeFilterParameters(parameters);
+      RunManifest::CollectPaths(parameters, inputs, outputs);
+
+      FilterEntry entry;
+      entry.index = i;
+      entry.filterUuid = filters[i]->getUuid().toString();
+      entry.label = filters[i]->getHumanLabel();
+      entry.parameterHash = QCryptographicHash::hash(QJsonDocument(parameters).toJson(QJsonDocument::Compact), QCryptographicHash::Sha1).toHex();
+      entry.enabled = filters[i]->getEnabled();
+      run.filters.push_back(entry);
+
+      pipelineHash.addData(entry.filterUuid.toUtf8());
+      pipelineHash.addData(entry.parameterHash);
+    }
+  }
+  run.pipelineHash = pipelineHash.result().toHex();
+
+  inputs.removeDuplicates();
+  foreach(QString input, inputs)
+  {
+    run.inputBytes += QFileInfo(input).size();
+  }
+
+  run.pluginsHash = ComputePluginsHash();
+  return run;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QByteArray PerformanceHistory::ComputePluginsHash()
+{
+  QStringList pluginVersions;
+  QVector<ISIMPLibPlugin*> plugins = PluginManager::Instance()->getPluginsVector();
+  for(ISIMPLibPlugin* plugin : plugins)
+  {
+    pluginVersions.push_back(plugin->getPluginFileName() + "=" + plugin->getVersion());
+  }
+  pluginVersions.sort();
+  return QCryptographicHash::hash(pluginVersions.join("\n").toUtf8(), QCryptographicHash::Sha1).toHex();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PerformanceHistory::AddProfile(Run& run, const QVector<FilterProfiler::Record>& records)
+{
+  for(const FilterProfiler::Record& record : records)
+  {
+    if(record.index >= 0 && record.index < run.filters.size())
+    {
+      run.filters[record.index].wallUs = record.wallUs;
+      run.filters[record.index].cpuUs = record.cpuUs;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<qint64> PerformanceHistory::estimateFilters(const Run& run)
+{
+  QMutexLocker lock(&m_Mutex);
+  readNewRuns();
+
+  QVector<qint64> estimates;
+  for(const FilterEntry& filter : run.filters)
+  {
+    if(!filter.enabled)
+    {
+      estimates.push_back(0);
+      continue;
+    }
+    qint64 expectedUs = estimate(sampleKey(run.host, filter), run.inputBytes);
+    if(expectedUs < 0)
+    {
+      expectedUs = estimate(looseSampleKey(run.host, filter), run.inputBytes);
+    }
+    estimates.push_back(expectedUs);
+  }
+  return estimates;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList PerformanceHistory::findSlowFilters(const Run& run, const QVector<qint64>& estimates) const
+{
+  double factor = getSlowdownFactor();
+  QStringList messages;
+  for(int i = 0; i < run.filters.size() && i < estimates.size(); i++)
+  {
+    const FilterEntry& filter = run.filters[i];
+    if(estimates[i] <= 0 || filter.wallUs < k_MinSlowFilterUs || filter.wallUs < estimates[i] * factor)
+    {
+      continue;
+    }
+    messages.push_back(QString("Filter %1 (%2) took %3, %4 times its usual %5")
+                           .arg(filter.index)
+                           .arg(filter.label)
+                           .arg(formatSeconds(filter.wallUs))
+                           .arg(static_cast<double>(filter.wallUs) / estimates[i], 0, 'f', 1)
+                           .arg(formatSeconds(estimates[i])));
+  }
+  return messages;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PerformanceHistory::append(const Run& run)
+{
+  QMutexLocker lock(&m_Mutex);
+  if(!m_Enabled)
+  {
+    return true;
+  }
+
+  QDir().mkpath(QFileInfo(m_FilePath).absolutePath());
+  rotate();
+  QFile file(m_FilePath);
+  // Unbuffered, so that the line reaches the file in one write and other processes that
+  // append at the same time cannot split it
+  if(!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered))
+  {
+    return false;
+  }
+  QByteArray line = QJsonDocument(RunToJson(run)).toJson(QJsonDocument::Compact) + "\n";
+  return file.write(line) == line.size();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<PerformanceHistory::Run> PerformanceHistory::readRuns(const QString& pipelinePath)
+{
+  QString absolutePath = QFileInfo(pipelinePath).absoluteFilePath();
+
+  QVector<Run> runs;
+  for(const QString& filePath : {getRotatedFilePath(), getFilePath()})
+  {
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+      continue;
+    }
+    while(!file.atEnd())
+    {
+      QJsonObject json = QJsonDocument::fromJson(file.readLine()).object();
+      if(!json.isEmpty() && json["pipelinePath"].toString() == absolutePath)
+      {
+        runs.push_back(RunFromJson(json));
+      }
+    }
+  }
+  return runs;
+}
+
+// -----------------------------------------------------------------------------
+// Another process may rotate at the same time. Then one of the two renames fails and
+// that process appends to the file the other one started.
+// -----------------------------------------------------------------------------
+void PerformanceHistory::rotate()
+{
+  if(m_MaxFileSize <= 0 || QFileInfo(m_FilePath).size() < m_MaxFileSize)
+  {
+    return;
+  }
+  QString rotatedFilePath = m_FilePath + ".1";
+  QFile::remove(rotatedFilePath);
+  if(QFile::rename(m_FilePath, rotatedFilePath))
+  {
+    m_ReadOffset = 0;
+    m_RotatedFileRead = false;
+    m_Samples.clear();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PerformanceHistory::readNewRuns()
+{
+  QFile file(m_FilePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return;
+  }
+  if(file.size() < m_ReadOffset)
+  {
+    // The file was rotated or replaced
+    m_ReadOffset = 0;
+    m_RotatedFileRead = false;
+    m_Samples.clear();
+  }
+
+  // The samples of the previous generation come first, so that the newer ones replace them
+  if(!m_RotatedFileRead)
+  {
+    m_RotatedFileRead = true;
+    QFile rotatedFile(m_FilePath + ".1");
+    if(rotatedFile.open(QIODevice::ReadOnly))
+    {
+      while(!rotatedFile.atEnd())
+      {
+        QJsonObject json = QJsonDocument::fromJson(rotatedFile.readLine()).object();
+        if(!json.isEmpty())
+        {
+          addSamples(RunFromJson(json));
+        }
+      }
+    }
+  }
+
+  file.seek(m_ReadOffset);
+  while(!file.atEnd())
+  {
+    QByteArray line = file.readLine();
+    if(!line.endsWith('\n'))
+    {
+      // Another process is still writing this run
+      break;
+    }
+    m_ReadOffset += line.size();
+    QJsonObject json = QJsonDocument::fromJson(line).object();
+    if(!json.isEmpty())
+    {
+      addSamples(RunFromJson(json));
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PerformanceHistory::addSamples(const Run& run)
+{
+  if(run.errorCode < 0)
+  {
+    return;
+  }
+  for(const FilterEntry& filter : run.filters)
+  {
+    if(filter.wallUs < 0)
+    {
+      continue;
+    }
+    Sample sample;
+    sample.wallUs = filter.wallUs;
+    sample.inputBytes = run.inputBytes;
+    for(const QString& key : {sampleKey(run.host, filter), looseSampleKey(run.host, filter)})
+    {
+      QVector<Sample>& samples = m_Samples[key];
+      samples.push_back(sample);
+      if(samples.size() > k_MaxSamplesPerKey)
+      {
+        samples.remove(0);
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 PerformanceHistory::estimate(const QString& key, qint64 inputBytes) const
+{
+  QVector<Sample> samples = m_Samples.value(key);
+  if(samples.isEmpty())
+  {
+    return -1;
+  }
+
+  // Filters mostly scale with the amount of data, so each sample is scaled to the size of
+  // the inputs before taking the median
+  QVector<double> scaled;
+  for(const Sample& sample : samples)
+  {
+    double ratio = (inputBytes > 0 && sample.inputBytes > 0) ? static_cast<double>(inputBytes) / sample.inputBytes : 1.0;
+    scaled.push_back(sample.wallUs * ratio);
+  }
+  std::sort(scaled.begin(), scaled.end());
+  return static_cast<qint64>(scaled[scaled.size() / 2]);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PerformanceHistory::CompareRuns(const Run& before, const Run& after, double factor)
+{
+  QString text;
+  QTextStream out(&text);
+  out << "Before: " << QDateTime::fromMSecsSinceEpoch(before.time).toString(Qt::ISODate) << " on " << before.host << ", " << before.elapsedMs << " ms\n";
+  out << "After:  " << QDateTime::fromMSecsSinceEpoch(after.time).toString(Qt::ISODate) << " on " << after.host << ", " << after.elapsedMs << " ms\n";
+  if(before.pluginsHash != after.pluginsHash)
+  {
+    out << "The plugins changed between the runs.\n";
+  }
+  if(before.pipelineHash != after.pipelineHash)
+  {
+    out << "The pipeline changed between the runs.\n";
+  }
+  if(before.inputBytes != after.inputBytes)
+  {
+    out << "The inputs changed from " << before.inputBytes << " to " << after.inputBytes << " bytes.\n";
+  }
+  out << "\n";
+
+  int count = qMax(before.filters.size(), after.filters.size());
+  for(int i = 0; i < count; i++)
+  {
+    FilterEntry a = before.filters.value(i);
+    FilterEntry b = after.filters.value(i);
+    QString label = b.label.isEmpty() ? a.label : b.label;
+    QString change;
+    QString mark;
+    if(a.wallUs > 0 && b.wallUs >= 0)
+    {
+      double ratio = static_cast<double>(b.wallUs) / a.wallUs;
+      change = QString("%1%2%").arg(ratio >= 1.0 ? "+" : "").arg((ratio - 1.0) * 100.0, 0, 'f', 0);
+      if(ratio >= factor || (b.wallUs > 0 && ratio <= 1.0 / factor))
+      {
+        mark = (ratio >= 1.0) ? "  SLOWER" : "  FASTER";
+      }
+    }
+    if(a.filterUuid != b.filterUuid && !a.filterUuid.isEmpty() && !b.filterUuid.isEmpty())
+    {
+      mark += "  (different filter)";
+    }
+    else if(a.parameterHash != b.parameterHash && !a.parameterHash.isEmpty() && !b.parameterHash.isEmpty())
+    {
+      mark += "  (parameters changed)";
+    }
+
+    out << QString("%1 %2 %3 %4 %5%6\n")
+               .arg(i, 3)
+               .arg(label.left(40), -40)
+               .arg(a.wallUs >= 0 ? formatSeconds(a.wallUs) : QString("-"), 12)
+               .arg(b.wallUs >= 0 ? formatSeconds(b.wallUs) : QString("-"), 12)
+               .arg(change, 7)
+               .arg(mark);
+  }
+  out.flush();
+  return text;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject PerformanceHistory::RunToJson(const Run& run)
+{
+  QJsonArray filters;
+  for(const FilterEntry& filter : run.filters)
+  {
+    QJsonObject entry;
+    entry["index"] = filter.index;
+    entry["uuid"] = filter.filterUuid;
+    entry["label"] = filter.label;
+    entry["parameterHash"] = QString::fromLatin1(filter.parameterHash);
+    entry["enabled"] = filter.enabled;
+    entry["wallUs"] = static_cast<double>(filter.wallUs);
+    entry["cpuUs"] = static_cast<double>(filter.cpuUs);
+    filters.push_back(entry);
+  }
+
+  QJsonObject json;
+  json["time"] = static_cast<double>(run.time);
+  json["host"] = run.host;
+  json["pipelinePath"] = run.pipelinePath;
+  json["pipelineHash"] = QString::fromLatin1(run.pipelineHash);
+  json["pluginsHash"] = QString::fromLatin1(run.pluginsHash);
+  json["inputBytes"] = static_cast<double>(run.inputBytes);
+  json["elapsedMs"] = static_cast<double>(run.elapsedMs);
+  json["errorCode"] = run.errorCode;
+  json["filters"] = filters;
+  return json;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PerformanceHistory::Run PerformanceHistory::RunFromJson(const QJsonObject& json)
+{
+  Run run;
+  run.time = static_cast<qint64>(json["time"].toDouble());
+  run.host = json["host"].toString();
+  run.pipelinePath = json["pipelinePath"].toString();
+  run.pipelineHash = json["pipelineHash"].toString().toLatin1();
+  run.pluginsHash = json["pluginsHash"].toString().toLatin1();
+  run.inputBytes = static_cast<qint64>(json["inputBytes"].toDouble());
+  run.elapsedMs = static_cast<qint64>(json["elapsedMs"].toDouble());
+  run.errorCode = json["errorCode"].toInt();
+  foreach(QJsonValue value, json["filters"].toArray())
+  {
+    QJsonObject entry = value.toObject();
+    FilterEntry filter;
+    filter.index = entry["index"].toInt(-1);
+    filter.filterUuid = entry["uuid"].toString();
+    filter.label = entry["label"].toString();
+    filter.parameterHash = entry["parameterHash"].toString().toLatin1();
+    filter.enabled = entry["enabled"].toBool(true);
+    filter.wallUs = static_cast<qint64>(entry["wallUs"].toDouble(-1));
+    filter.cpuUs = static_cast<qint64>(entry["cpuUs"].toDouble(-1));
+    run.filters.push_back(filter);
+  }
+  return run;
+}
@@ -0,0 +1,282 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "SIMPLView/FilterProfiler.h"
+
+/**
+ * @brief The PerformanceHistory class keeps the filter timings of every run in an append-only
+ * JSON lines file that the GUI and all headless modes share, one line per run. A filter's
+ * timings are keyed by the host, the filter's UUID, the hash of its parameters and the size
+ * of the pipeline's input files, so they can predict how long the filter will take the next
+ * time, flag a run in which it is much slower than usual and compare two runs after a
+ * plugin upgrade.
+ *
+ * Several processes may append at the same time; every run is written with a single write.
+ * Once the file has grown past getMaxFileSize() it is renamed to getRotatedFilePath(),
+ * replacing the one rotated before, and a new file is started, so at most two generations
+ * are kept. The estimates read the rotated file and then the current one incrementally and
+ * keep the last samples of every key in memory. All functions may be called from any thread.
+ */
+class PerformanceHistory
+{
+public:
+  struct FilterEntry
+  {
+    int index = -1;
+    QString filterUuid;
+    QString label;
+    QByteArray parameterHash;
+    bool enabled = true;
+    qint64 wallUs = -1;
+    qint64 cpuUs = -1;
+  };
+
+  struct Run
+  {
+    qint64 time = 0;
+    QString host;
+    QString pipelinePath;
+    QByteArray pipelineHash;
+    QByteArray pluginsHash;
+    qint64 inputBytes = 0;
+    qint64 elapsedMs = 0;
+    int errorCode = 0;
+    QVector<FilterEntry> filters;
+  };
+
+  virtual ~PerformanceHistory();
+
+  /**
+   * @brief Instance
+   * @return
+   */
+  static PerformanceHistory* Instance();
+
+  /**
+   * @brief GetDefaultFilePath Returns where the history is kept unless told otherwise
+   * @return
+   */
+  static QString GetDefaultFilePath();
+
+  /**
+   * @brief setFilePath
+   * @param filePath
+   */
+  void setFilePath(const QString& filePath);
+
+  /**
+   * @brief getFilePath
+   * @return
+   */
+  QString getFilePath() const;
+
+  /**
+   * @brief getRotatedFilePath Returns where the previous generation of the history is kept
+   * @return
+   */
+  QString getRotatedFilePath() const;
+
+  /**
+   * @brief setMaxFileSize Sets the size past which the history file is rotated
+   * @param bytes
+   */
+  void setMaxFileSize(qint64 bytes);
+
+  /**
+   * @brief getMaxFileSize
+   * @return
+   */
+  qint64 getMaxFileSize() const;
+
+  /**
+   * @brief setEnabled Turns recording on or off. It is on by default.
+   * @param enabled
+   */
+  void setEnabled(bool enabled);
+
+  /**
+   * @brief getEnabled
+   * @return
+   */
+  bool getEnabled() const;
+
+  /**
+   * @brief setSlowdownFactor Sets how many times slower than its history a filter has to be
+   * before findSlowFilters() reports it
+   * @param factor
+   */
+  void setSlowdownFactor(double factor);
+
+  /**
+   * @brief getSlowdownFactor
+   * @return
+   */
+  double getSlowdownFactor() const;
+
+  /**
+   * @brief DescribeRun Fills in the keys of a run of the pipeline, without any timings
+   * @param pipeline
+   * @param pipelinePath The file the pipeline came from, may be empty
+   * @return
+   */
+  static Run DescribeRun(const FilterPipeline::Pointer& pipeline, const QString& pipelinePath);
+
+  /**
+   * @brief ComputePluginsHash Hashes the file names and versions of the loaded plugins
+   * @return The hex encoded SHA-1
+   */
+  static QByteArray ComputePluginsHash();
+
+  /**
+   * @brief AddProfile Copies the timings of the profile records to the filters of the run
+   * @param run
+   * @param records
+   */
+  static void AddProfile(Run& run, const QVector<FilterProfiler::Record>& records);
+
+  /**
+   * @brief estimateFilters Predicts the wall time of every filter of the run from the
+   * samples recorded on this host, scaled by the size of the input files
+   * @param run
+   * @return The time in microseconds per filter of the run, -1 where nothing is known and 0
+   * for disabled filters
+   */
+  QVector<qint64> estimateFilters(const Run& run);
+
+  /**
+   * @brief findSlowFilters Compares the timings of the run with the estimates made before it
+   * @param run
+   * @param estimates As returned by estimateFilters() before the run was appended
+   * @return One message per filter that took getSlowdownFactor() times its estimate or longer
+   */
+  QStringList findSlowFilters(const Run& run, const QVector<qint64>& estimates) const;
+
+  /**
+   * @brief append Adds the run to the history file. Does nothing while recording is off.
+   * @param run
+   * @return
+   */
+  bool append(const Run& run);
+
+  /**
+   * @brief readRuns Reads every recorded run of a pipeline file that is still kept, oldest first
+   * @param pipelinePath
+   * @return
+   */
+  QVector<Run> readRuns(const QString& pipelinePath);
+
+  /**
+   * @brief CompareRuns Renders a filter by filter comparison of two runs as text
+   * @param before
+   * @param after
+   * @param factor Changes by this factor or more are marked
+   * @return
+   */
+  static QString CompareRuns(const Run& before, const Run& after, double factor);
+
+  /**
+   * @brief RunToJson
+   * @param run
+   * @return
+   */
+  static QJsonObject RunToJson(const Run& run);
+
+  /**
+   * @brief RunFromJson
+   * @param json
+   * @return
+   */
+  static Run RunFromJson(const QJsonObject& json);
+
+protected:
+  PerformanceHistory();
+
+private:
+  struct Sample
+  {
+    qint64 wallUs = 0;
+    qint64 inputBytes = 0;
+  };
+
+  mutable QMutex m_Mutex;
+  QString m_FilePath;
+  bool m_Enabled = true;
+  double m_SlowdownFactor = 3.0;
+  qint64 m_MaxFileSize = 0;
+  qint64 m_ReadOffset = 0;
+  bool m_RotatedFileRead = false;
+  QMap<QString, QVector<Sample>> m_Samples;
+
+  /**
+   * @brief readNewRuns Adds the samples of the runs appended since the last call. The mutex
+   * must be held.
+   */
+  void readNewRuns();
+
+  /**
+   * @brief rotate Renames the history file once it has grown past the maximum size. The
+   * mutex must be held.
+   */
+  void rotate();
+
+  /**
+   * @brief addSamples Adds the timings of a run to the samples. The mutex must be held.
+   * @param run
+   */
+  void addSamples(const Run& run);
+
+  /**
+   * @brief estimate Returns the median of the samples of a key scaled to the input size
+   * @param key
+   * @param inputBytes
+   * @return -1 if there are no samples
+   */
+  qint64 estimate(const QString& key, qint64 inputBytes) const;
+
+  PerformanceHistory(const PerformanceHistory&) = delete; // Copy Constructor Not Implemented
+  void operator=(const PerformanceHistory&) = delete;     // Move assignment Not Implemented
+};
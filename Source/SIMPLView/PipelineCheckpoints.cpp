@@ -0,0 +1,287 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineCheckpoints.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QStringList>
+
+#include <algorithm>
+
+#include "SIMPLView/FilterResultStore.h"
+#include "SIMPLView/RunManifest.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString checkpointPath(const QString& prefix, int filterIndex, const QByteArray& key, const QString& suffix)
+{
+  return QString("%1-%2-%3.%4").arg(prefix).arg(filterIndex).arg(QString::fromLatin1(key.left(16))).arg(suffix);
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineCheckpoints::PipelineCheckpoints()
+: m_Directory(GetDefaultDirectory())
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineCheckpoints::~PipelineCheckpoints() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineCheckpoints* PipelineCheckpoints::Instance()
+{
+  static PipelineCheckpoints self;
+  return &self;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineCheckpoints::GetDefaultDirectory()
+{
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/Checkpoints";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineCheckpoints::setDirectory(const QString& directory)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_Directory = directory;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineCheckpoints::getDirectory() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return m_Directory;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineCheckpoints::setFilterIndices(const QVector<int>& indices)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_FilterIndices = indices;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<int> PipelineCheckpoints::getFilterIndices() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return m_FilterIndices;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineCheckpoints::ParseFilterIndices(const QString& text, int filterCount, QVector<int>& indices)
+{
+  indices.clear();
+  QStringList ranges = text.split(',');
+  foreach(QString range, ranges)
+  {
+    QStringList bounds = range.trimmed().split('-');
+    if(bounds.size() > 2)
+    {
+      return false;
+    }
+    bool firstOk = false;
+    bool lastOk = false;
+    int first = bounds.first().toInt(&firstOk);
+    int last = bounds.last().toInt(&lastOk);
+    if(!firstOk || !lastOk || first < 0 || last < first || last >= filterCount)
+    {
+      return false;
+    }
+    for(int index = first; index <= last; index++)
+    {
+      if(!indices.contains(index))
+      {
+        indices.push_back(index);
+      }
+    }
+  }
+  std::sort(indices.begin(), indices.end());
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineCheckpoints::setResume(bool resume)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_Resume = resume;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineCheckpoints::getResume() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return m_Resume;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineCheckpoints::isActive() const
+{
+  QMutexLocker lock(&m_Mutex);
+  return m_Resume || !m_FilterIndices.isEmpty();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineCheckpoints::filePrefix(const QString& pipelinePath) const
+{
+  QByteArray hash = QCryptographicHash::hash(QFileInfo(pipelinePath).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+  return QDir(getDirectory()).filePath(QFileInfo(pipelinePath).completeBaseName() + "-" + QString::fromLatin1(hash.left(16)));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineCheckpoints::findCheckpoint(const QString& pipelinePath, const QVector<QByteArray>& keys, int maxIndex) const
+{
+  QString prefix = filePrefix(pipelinePath);
+  for(int i = qMin(maxIndex, keys.size() - 1); i >= 0; i--)
+  {
+    // The sidecar is written last, so a checkpoint without it is incomplete
+    QFile file(checkpointPath(prefix, i, keys[i], "json"));
+    if(!QFileInfo::exists(checkpointPath(prefix, i, keys[i], "dream3d")) || !file.open(QIODevice::ReadOnly))
+    {
+      continue;
+    }
+    QJsonObject sidecar = QJsonDocument::fromJson(file.readAll()).object();
+    if(sidecar["key"].toString().toLatin1() == keys[i] && sidecar["filterIndex"].toInt(-1) == i)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer PipelineCheckpoints::readCheckpoint(const QString& pipelinePath, int filterIndex, const QByteArray& key) const
+{
+  return FilterResultStore::ReadStateFile(checkpointPath(filePrefix(pipelinePath), filterIndex, key, "dream3d"));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineCheckpoints::writeCheckpoint(const QString& pipelinePath, int filterIndex, const QString& filterLabel, const QByteArray& key, const DataContainerArray::Pointer& dca) const
+{
+  QString prefix = filePrefix(pipelinePath);
+  QDir directory = QFileInfo(prefix).absoluteDir();
+  if(!directory.mkpath("."))
+  {
+    return false;
+  }
+
+  // A checkpoint at the same filter with another key is out of date
+  QString stalePattern = QString("%1-%2-*").arg(QFileInfo(prefix).fileName()).arg(filterIndex);
+  foreach(QString fileName, directory.entryList(QStringList() << stalePattern, QDir::Files))
+  {
+    directory.remove(fileName);
+  }
+
+  QString filePath = checkpointPath(prefix, filterIndex, key, "dream3d");
+  QString tempPath = QString("%1.%2.tmp").arg(filePath).arg(QCoreApplication::applicationPid());
+  if(!FilterResultStore::WriteStateFile(tempPath, dca) || !QFile::rename(tempPath, filePath))
+  {
+    QFile::remove(tempPath);
+    return false;
+  }
+
+  QJsonObject sidecar;
+  sidecar["key"] = QString::fromLatin1(key);
+  sidecar["pipelinePath"] = QFileInfo(pipelinePath).absoluteFilePath();
+  sidecar["filterIndex"] = filterIndex;
+  sidecar["filterLabel"] = filterLabel;
+  sidecar["created"] = static_cast<double>(QDateTime::currentMSecsSinceEpoch());
+  QSaveFile file(checkpointPath(prefix, filterIndex, key, "json"));
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+  file.write(QJsonDocument(sidecar).toJson());
+  return file.commit();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineCheckpoints::removeCheckpoints(const QString& pipelinePath) const
+{
+  QString prefix = filePrefix(pipelinePath);
+  QDir directory = QFileInfo(prefix).absoluteDir();
+  foreach(QString fileName, directory.entryList(QStringList() << QFileInfo(prefix).fileName() + "-*", QDir::Files))
+  {
+    directory.remove(fileName);
+  }
+}
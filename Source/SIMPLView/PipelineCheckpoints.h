@@ -0,0 +1,180 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+/**
+ * @brief The PipelineCheckpoints class writes the DataContainerArray to a .dream3d file after
+ * the filters that were marked as checkpoints, so that a long pipeline that failed or was
+ * stopped late can be resumed instead of run again from the start.
+ *
+ * FilterResultCache writes the state when execution passes a checkpoint, before the next
+ * filter runs, because HDF5 must not be used from two threads at once. A checkpoint records the key of everything
+ * upstream of it (see FilterResultStore::computeKeys()), so a resumed run only loads it
+ * while the filters up to it, their inputs and the plugins are unchanged; the filters after
+ * it may have been edited. The checkpoints of a pipeline file are removed once it succeeds.
+ * All functions may be called from any thread.
+ */
+class PipelineCheckpoints
+{
+public:
+  virtual ~PipelineCheckpoints();
+
+  /**
+   * @brief Instance
+   * @return
+   */
+  static PipelineCheckpoints* Instance();
+
+  /**
+   * @brief GetDefaultDirectory Returns where the checkpoints are written unless told otherwise
+   * @return
+   */
+  static QString GetDefaultDirectory();
+
+  /**
+   * @brief setDirectory
+   * @param directory
+   */
+  void setDirectory(const QString& directory);
+
+  /**
+   * @brief getDirectory
+   * @return
+   */
+  QString getDirectory() const;
+
+  /**
+   * @brief setFilterIndices Marks the filters after which a checkpoint is written
+   * @param indices
+   */
+  void setFilterIndices(const QVector<int>& indices);
+
+  /**
+   * @brief getFilterIndices
+   * @return
+   */
+  QVector<int> getFilterIndices() const;
+
+  /**
+   * @brief ParseFilterIndices Reads a list of filter indices such as "3,7-8"
+   * @param text
+   * @param filterCount The indices must be below it
+   * @param indices Receives the sorted indices
+   * @return False if the list is malformed or an index is out of range
+   */
+  static bool ParseFilterIndices(const QString& text, int filterCount, QVector<int>& indices);
+
+  /**
+   * @brief setResume Lets the runs start after the deepest valid checkpoint
+   * @param resume
+   */
+  void setResume(bool resume);
+
+  /**
+   * @brief getResume
+   * @return
+   */
+  bool getResume() const;
+
+  /**
+   * @brief isActive
+   * @return Whether checkpoints are written or resumed from
+   */
+  bool isActive() const;
+
+  /**
+   * @brief findCheckpoint Looks for the deepest checkpoint of the pipeline file whose
+   * recorded key matches the current one
+   * @param pipelinePath
+   * @param keys The current key of every filter
+   * @param maxIndex The deepest filter that may be skipped
+   * @return The index of the filter after which the checkpoint was written, or -1
+   */
+  int findCheckpoint(const QString& pipelinePath, const QVector<QByteArray>& keys, int maxIndex) const;
+
+  /**
+   * @brief readCheckpoint
+   * @param pipelinePath
+   * @param filterIndex
+   * @param key
+   * @return A null pointer if the checkpoint could not be read
+   */
+  DataContainerArray::Pointer readCheckpoint(const QString& pipelinePath, int filterIndex, const QByteArray& key) const;
+
+  /**
+   * @brief writeCheckpoint Writes the state
+   * @param pipelinePath
+   * @param filterIndex
+   * @param filterLabel
+   * @param key
+   * @param dca
+   * @return Whether the checkpoint was written
+   */
+  bool writeCheckpoint(const QString& pipelinePath, int filterIndex, const QString& filterLabel, const QByteArray& key, const DataContainerArray::Pointer& dca) const;
+
+  /**
+   * @brief removeCheckpoints Removes every checkpoint of the pipeline file
+   * @param pipelinePath
+   */
+  void removeCheckpoints(const QString& pipelinePath) const;
+
+protected:
+  PipelineCheckpoints();
+
+private:
+  mutable QMutex m_Mutex;
+  QString m_Directory;
+  QVector<int> m_FilterIndices;
+  bool m_Resume = false;
+
+  /**
+   * @brief filePrefix Returns the start of the file names of the checkpoints of a pipeline
+   * @param pipelinePath
+   * @return
+   */
+  QString filePrefix(const QString& pipelinePath) const;
+
+  PipelineCheckpoints(const PipelineCheckpoints&) = delete; // Copy Constructor Not Implemented
+  void operator=(const PipelineCheckpoints&) = delete;      // Move assignment Not Implemented
+};
@@ -0,0 +1,441 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineDaemon.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+
+#include "SIMPLib/Messages/PipelineMessage.h"
+
+#include "SIMPLView/HeadlessPipelineRunner.h"
+#include "SIMPLView/PipelineMetrics.h"
+#include "SIMPLView/PipelineProcessPool.h"
+
+#include "BrandedStrings.h"
+
+namespace
+{
+const int k_ProbeTimeout = 1000;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QByteArray toLine(const QJsonObject& message)
+{
+  return QJsonDocument(message).toJson(QJsonDocument::Compact) + "\n";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject errorMessage(const QJsonValue& id, const QString& text)
+{
+  QJsonObject message;
+  message["type"] = QString("error");
+  message["id"] = id;
+  message["text"] = text;
+  return message;
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineDaemon::PipelineDaemon(QObject* parent)
+: QObject(parent)
+{
+  m_Pool.setMaxThreadCount(1);
+
+  // Only the user who started the daemon may submit jobs to it
+  m_Server.setSocketOptions(QLocalServer::UserAccessOption);
+  connect(&m_Server, &QLocalServer::newConnection, this, &PipelineDaemon::acceptConnections);
+  connect(this, &PipelineDaemon::jobMessage, this, &PipelineDaemon::sendMessage, Qt::QueuedConnection);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineDaemon::~PipelineDaemon()
+{
+  m_Server.close();
+  m_Pool.waitForDone();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineDaemon::GetDefaultServerName()
+{
+  QString userName = QString::fromLocal8Bit(qgetenv("USER"));
+  if(userName.isEmpty())
+  {
+    userName = QString::fromLocal8Bit(qgetenv("USERNAME"));
+  }
+  return BrandedStrings::ApplicationName + "-PipelineDaemon-" + userName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineDaemon::setMaxJobs(int maxJobs)
+{
+  m_Pool.setMaxThreadCount(qMax(1, maxJobs));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineDaemon::getMaxJobs() const
+{
+  return m_Pool.maxThreadCount();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineDaemon::setProcessPool(PipelineProcessPool* pool)
+{
+  m_ProcessPool = pool;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineDaemon::setResultCache(FilterResultCache* cache)
+{
+  m_ResultCache = cache;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineDaemon::listen(const QString& serverName)
+{
+  m_ErrorString.clear();
+
+  // A daemon that answers must keep its socket; only one left behind by a daemon that
+  // crashed is removed
+  QLocalSocket probe;
+  probe.connectToServer(serverName);
+  if(probe.waitForConnected(k_ProbeTimeout))
+  {
+    probe.disconnectFromServer();
+    m_ErrorString = QString("Another daemon is already listening on %1").arg(serverName);
+    return false;
+  }
+
+  QLocalServer::removeServer(serverName);
+  return m_Server.listen(serverName);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineDaemon::getErrorString() const
+{
+  if(!m_ErrorString.isEmpty())
+  {
+    return m_ErrorString;
+  }
+  return m_Server.errorString();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineDaemon::acceptConnections()
+{
+  while(m_Server.hasPendingConnections())
+  {
+    QLocalSocket* socket = m_Server.nextPendingConnection();
+    quint64 clientId = m_NextClientId++;
+    m_Clients.insert(clientId, socket);
+
+    connect(socket, &QLocalSocket::readyRead, this, [this, clientId] { readClient(clientId); });
+    connect(socket, &QLocalSocket::disconnected, this, [this, clientId, socket] {
+      // Jobs of a client that went away still run, their answers are dropped
+      m_Clients.remove(clientId);
+      socket->deleteLater();
+    });
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineDaemon::readClient(quint64 clientId)
+{
+  QLocalSocket* socket = m_Clients.value(clientId);
+  if(socket == nullptr)
+  {
+    return;
+  }
+
+  while(socket->canReadLine())
+  {
+    QByteArray line = socket->readLine().trimmed();
+    if(line.isEmpty())
+    {
+      continue;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+    QJsonObject request = doc.object();
+    if(parseError.error != QJsonParseError::NoError || !doc.isObject())
+    {
+      sendMessage(clientId, errorMessage(QJsonValue(), "Invalid request: " + parseError.errorString()));
+    }
+    else if(request["type"].toString() == "submit")
+    {
+      submitJob(clientId, request);
+    }
+    else
+    {
+      sendMessage(clientId, errorMessage(request["id"], "Unknown request type: " + request["type"].toString()));
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineDaemon::submitJob(quint64 clientId, const QJsonObject& request)
+{
+  QJsonValue id = request["id"];
+  QString filePath = request["path"].toString();
+  QJsonObject overrides = request["overrides"].toObject();
+
+  PipelineProcessPool::JobLimits limits;
+  limits.memoryMB = static_cast<qint64>(request["limits"].toObject()["memoryMB"].toDouble());
+  limits.timeoutSec = request["limits"].toObject()["timeoutSec"].toInt();
+  if(m_ProcessPool == nullptr && (limits.memoryMB > 0 || limits.timeoutSec > 0))
+  {
+    // A job on one of the daemon's threads can neither be capped nor stopped
+    sendMessage(clientId, errorMessage(id, "Resource limits need a daemon started with --isolate"));
+    return;
+  }
+
+  QJsonObject accepted;
+  accepted["type"] = QString("accepted");
+  accepted["id"] = id;
+  sendMessage(clientId, accepted);
+
+  PipelineMetrics::Instance()->jobsQueued(1);
+  QtConcurrent::run(&m_Pool, [this, clientId, id, filePath, overrides, limits] {
+    PipelineMetrics::Instance()->jobStarted();
+    HeadlessPipelineRunner::Result result;
+    if(m_ProcessPool != nullptr)
+    {
+      // The worker process has already converted its messages
+      result = m_ProcessPool->runJob(filePath, overrides, [this, clientId, id](const QJsonObject& workerMessage) {
+        QJsonObject message = workerMessage;
+        message["id"] = id;
+        emit jobMessage(clientId, message);
+      }, limits);
+    }
+    else
+    {
+      result = HeadlessPipelineRunner::RunPipeline(filePath, overrides, [this, clientId, id](const PipelineMessage& pm) {
+        QJsonObject message = MessageToJson(pm);
+        message["id"] = id;
+        emit jobMessage(clientId, message);
+      }, m_ResultCache);
+    }
+    PipelineMetrics::Instance()->jobFinished(result);
+
+    QJsonObject message;
+    message["type"] = QString("result");
+    message["id"] = id;
+    message["path"] = filePath;
+    message["errorCode"] = result.errorCode;
+    message["elapsedMs"] = result.elapsedMs;
+    message["errors"] = QJsonArray::fromStringList(result.errors);
+    message["warnings"] = QJsonArray::fromStringList(result.warnings);
+    QJsonArray cachedFilters;
+    foreach(int index, result.cachedFilters)
+    {
+      cachedFilters.append(index);
+    }
+    message["cachedFilters"] = cachedFilters;
+    emit jobMessage(clientId, message);
+  });
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineDaemon::sendMessage(quint64 clientId, const QJsonObject& message)
+{
+  QLocalSocket* socket = m_Clients.value(clientId);
+  if(socket != nullptr)
+  {
+    socket->write(toLine(message));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject PipelineDaemon::MessageToJson(const PipelineMessage& pm)
+{
+  QJsonObject message;
+  message["type"] = QString("message");
+
+  PipelineMessage::MessageType type = pm.getType();
+  if(type == PipelineMessage::MessageType::Error)
+  {
+    message["level"] = QString("error");
+    message["text"] = pm.generateErrorString();
+  }
+  else if(type == PipelineMessage::MessageType::Warning)
+  {
+    message["level"] = QString("warning");
+    message["text"] = pm.generateWarningString();
+  }
+  else if(type == PipelineMessage::MessageType::StatusMessage)
+  {
+    message["level"] = QString("status");
+    message["text"] = pm.generateStatusString();
+  }
+  else if(type == PipelineMessage::MessageType::ProgressValue)
+  {
+    message["level"] = QString("progress");
+    message["progress"] = pm.getProgressValue();
+  }
+  else if(type == PipelineMessage::MessageType::StatusMessageAndProgressValue)
+  {
+    message["level"] = QString("progress");
+    message["progress"] = pm.getProgressValue();
+    message["text"] = pm.generateStatusString();
+  }
+  else
+  {
+    message["level"] = QString("output");
+    message["text"] = pm.getText();
+  }
+  return message;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineDaemon::SubmitJobs(const QString& serverName, const QVector<QJsonObject>& jobs)
+{
+  QLocalSocket socket;
+  socket.connectToServer(serverName);
+  if(!socket.waitForConnected(3000))
+  {
+    qDebug().noquote() << "Could not connect to the pipeline daemon" << serverName << ":" << socket.errorString();
+    return 2;
+  }
+
+  QMap<int, QString> pendingJobs;
+  for(int i = 0; i < jobs.size(); i++)
+  {
+    QJsonObject request = jobs[i];
+    request["type"] = QString("submit");
+    request["id"] = i;
+    pendingJobs.insert(i, request["path"].toString());
+    socket.write(toLine(request));
+  }
+  socket.flush();
+
+  int failedCount = 0;
+  while(!pendingJobs.isEmpty())
+  {
+    if(!socket.canReadLine() && !socket.waitForReadyRead(-1))
+    {
+      qDebug().noquote() << "Lost the connection to the pipeline daemon:" << socket.errorString();
+      return 2;
+    }
+
+    while(socket.canReadLine())
+    {
+      QJsonObject message = QJsonDocument::fromJson(socket.readLine()).object();
+      QString type = message["type"].toString();
+      int id = message["id"].toInt(-1);
+      QString prefix = QString("[%1]").arg(id);
+
+      if(type == "message")
+      {
+        QString level = message["level"].toString();
+        if(level == "progress")
+        {
+          qDebug().noquote() << prefix << QString("%1%").arg(message["progress"].toInt()) << message["text"].toString();
+        }
+        else
+        {
+          qDebug().noquote() << prefix << message["text"].toString();
+        }
+      }
+      else if(type == "result")
+      {
+        int errorCode = message["errorCode"].toInt();
+        QString status = (errorCode < 0) ? QString("FAILED (%1)").arg(errorCode) : QString("OK");
+        qDebug().noquote() << prefix << QDir::toNativeSeparators(message["path"].toString()) << ":" << status << "in" << message["elapsedMs"].toInt() << "ms";
+        int cachedCount = message["cachedFilters"].toArray().size();
+        if(cachedCount > 0)
+        {
+          qDebug().noquote() << prefix << cachedCount << "filters were reused from an earlier job";
+        }
+        foreach(QJsonValue warning, message["warnings"].toArray())
+        {
+          qDebug().noquote() << prefix << "SLOW:" << warning.toString();
+        }
+        if(errorCode < 0)
+        {
+          failedCount++;
+        }
+        pendingJobs.remove(id);
+      }
+      else if(type == "error")
+      {
+        qDebug().noquote() << prefix << message["text"].toString();
+        if(pendingJobs.remove(id) > 0)
+        {
+          failedCount++;
+        }
+      }
+    }
+  }
+
+  return (failedCount > 0) ? 1 : 0;
+}
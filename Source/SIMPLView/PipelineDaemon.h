@@ -0,0 +1,183 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QString>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+
+class PipelineMessage;
+class FilterResultCache;
+class PipelineProcessPool;
+
+/**
+ * @brief The PipelineDaemon class keeps the plugins loaded and executes pipeline jobs that
+ * clients send over a local socket, so that a job does not pay for the startup of a process.
+ *
+ * Every message is one line of compact JSON. A client submits a job with
+ * @code
+ *   {"type": "submit", "id": 1, "path": "/data/pipeline.json", "overrides": {"0": {"OutputFile": "/tmp/out.dream3d"}}}
+ * @endcode
+ * and the daemon answers with an "accepted" message, a "message" for every PipelineMessage
+ * of the job (level "error", "warning", "status", "progress" or "output") and a final
+ * "result" with the error code, the time spent, the error messages and "warnings" about
+ * filters that ran much slower than their PerformanceHistory. All answers carry the id of
+ * the job. At most getMaxJobs() jobs run at the same time; the others wait. Jobs on threads of
+ * the daemon execute one at a time unless HDF5 is thread safe (see
+ * HeadlessPipelineRunner::IsHdf5ThreadSafe()).
+ *
+ * A job may carry "limits": {"memoryMB": 4096, "timeoutSec": 600}, which are only accepted
+ * when the jobs run on a PipelineProcessPool (see setProcessPool()).
+ *
+ * Jobs that run on a thread of the daemon may share a FilterResultCache (see
+ * setResultCache()), and every job resumes from the FilterResultStore when it is enabled.
+ * The result lists the "cachedFilters" that were not executed again.
+ */
+class PipelineDaemon : public QObject
+{
+  Q_OBJECT
+
+public:
+  PipelineDaemon(QObject* parent = nullptr);
+  ~PipelineDaemon() override;
+
+  /**
+   * @brief GetDefaultServerName Returns the socket name used when none is given, one per user
+   * @return
+   */
+  static QString GetDefaultServerName();
+
+  /**
+   * @brief setMaxJobs Sets how many jobs may run at the same time
+   * @param maxJobs
+   */
+  void setMaxJobs(int maxJobs);
+
+  /**
+   * @brief getMaxJobs
+   * @return
+   */
+  int getMaxJobs() const;
+
+  /**
+   * @brief setProcessPool Runs every job on a worker process of the pool instead of a thread
+   * of the daemon. The pool must have been started and outlive the daemon.
+   * @param pool
+   */
+  void setProcessPool(PipelineProcessPool* pool);
+
+  /**
+   * @brief setResultCache Lets the jobs skip the filters whose results the cache kept from an
+   * earlier job. It is not used when the jobs run on a PipelineProcessPool, because the
+   * workers do not share the memory of the daemon. The cache must outlive the daemon.
+   * @param cache
+   */
+  void setResultCache(FilterResultCache* cache);
+
+  /**
+   * @brief listen Starts accepting clients of the same user. Fails if another daemon answers on
+   * the socket; a stale socket left by a daemon that did not shut down cleanly is removed first.
+   * @param serverName
+   * @return
+   */
+  bool listen(const QString& serverName);
+
+  /**
+   * @brief getErrorString Returns why listen() failed
+   * @return
+   */
+  QString getErrorString() const;
+
+  /**
+   * @brief MessageToJson Converts a pipeline message to the "message" answer of the protocol
+   * @param pm
+   * @return
+   */
+  static QJsonObject MessageToJson(const PipelineMessage& pm);
+
+  /**
+   * @brief SubmitJobs Sends the jobs to a running daemon, prints the answers and waits for
+   * every result
+   * @param serverName
+   * @param jobs Objects with a "path" and optional "overrides" and "limits"
+   * @return 0 if every job succeeded, 1 if any failed and 2 if the daemon could not be reached
+   */
+  static int SubmitJobs(const QString& serverName, const QVector<QJsonObject>& jobs);
+
+signals:
+  /**
+   * @brief jobMessage Emitted from the worker threads with an answer for a client
+   * @param clientId
+   * @param message
+   */
+  void jobMessage(quint64 clientId, const QJsonObject& message);
+
+private slots:
+  void acceptConnections();
+  void sendMessage(quint64 clientId, const QJsonObject& message);
+
+private:
+  QLocalServer m_Server;
+  QString m_ErrorString;
+  QThreadPool m_Pool;
+  PipelineProcessPool* m_ProcessPool = nullptr;
+  FilterResultCache* m_ResultCache = nullptr;
+  QMap<quint64, QPointer<QLocalSocket>> m_Clients;
+  quint64 m_NextClientId = 1;
+
+  /**
+   * @brief readClient Handles the complete lines the client has sent
+   * @param clientId
+   */
+  void readClient(quint64 clientId);
+
+  /**
+   * @brief submitJob Queues a job on the pool
+   * @param clientId
+   * @param request
+   */
+  void submitJob(quint64 clientId, const QJsonObject& request);
+
+  PipelineDaemon(const PipelineDaemon&) = delete; // Copy Constructor Not Implemented
+  void operator=(const PipelineDaemon&) = delete; // Move assignment Not Implemented
+};
@@ -0,0 +1,308 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineMetrics.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
+
+#if defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+const QVector<double> k_DurationBounds = {0.01, 0.05, 0.1, 0.5, 1.0, 5.0, 10.0, 30.0, 60.0, 300.0, 600.0, 1800.0, 3600.0};
+
+// 128 MB to 64 GB
+const QVector<double> k_MemoryBounds = {134217728.0, 268435456.0, 536870912.0, 1073741824.0, 2147483648.0, 4294967296.0, 8589934592.0, 17179869184.0, 34359738368.0, 68719476736.0};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString escapeLabel(const QString& value)
+{
+  QString escaped = value;
+  escaped.replace("\\", "\\\\");
+  escaped.replace("\"", "\\\"");
+  escaped.replace("\n", "\\n");
+  return escaped;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void appendHeader(QString& out, const QString& name, const QString& type, const QString& help)
+{
+  out += QString("# HELP %1 %2\n# TYPE %1 %3\n").arg(name, help, type);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void appendValue(QString& out, const QString& name, const QString& type, const QString& help, double value)
+{
+  appendHeader(out, name, type, help);
+  out += QString("%1 %2\n").arg(name).arg(value, 0, 'g', 15);
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineMetrics::PipelineMetrics() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineMetrics::~PipelineMetrics() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineMetrics* PipelineMetrics::Instance()
+{
+  static PipelineMetrics self;
+  return &self;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineMetrics::jobsQueued(int count)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_Queued += count;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineMetrics::jobStarted()
+{
+  QMutexLocker lock(&m_Mutex);
+  m_Queued = qMax<qint64>(0, m_Queued - 1);
+  m_Running++;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineMetrics::jobSkipped()
+{
+  QMutexLocker lock(&m_Mutex);
+  m_Queued = qMax<qint64>(0, m_Queued - 1);
+  m_Skipped++;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineMetrics::jobFinished(const HeadlessPipelineRunner::Result& result)
+{
+  // Jobs on threads share this process, so only its peak is known for them
+  qint64 peakMemoryMB = (result.peakMemoryMB > 0) ? result.peakMemoryMB : GetPeakMemory();
+
+  QMutexLocker lock(&m_Mutex);
+  m_Running = qMax<qint64>(0, m_Running - 1);
+  if(result.errorCode < 0)
+  {
+    m_Failed++;
+  }
+  else
+  {
+    m_Succeeded++;
+  }
+
+  Observe(m_PipelineDurations[QFileInfo(result.filePath).completeBaseName()], k_DurationBounds, result.elapsedMs / 1000.0);
+  for(const FilterProfiler::Record& record : result.filterProfile)
+  {
+    Observe(m_FilterDurations[record.label], k_DurationBounds, record.wallUs / 1000000.0);
+  }
+  Observe(m_JobMemory, k_MemoryBounds, peakMemoryMB * 1024.0 * 1024.0);
+  m_WorkerBytesRead += result.bytesRead;
+  m_WorkerBytesWritten += result.bytesWritten;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineMetrics::setPluginLoadTime(qint64 loadTimeMs, int failedCount)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_PluginLoadTimeMs = loadTimeMs;
+  m_PluginLoadFailures = failedCount;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineMetrics::Observe(Histogram& histogram, const QVector<double>& bounds, double value)
+{
+  if(histogram.counts.isEmpty())
+  {
+    histogram.counts.fill(0, bounds.size());
+  }
+  for(int i = 0; i < bounds.size(); i++)
+  {
+    if(value <= bounds[i])
+    {
+      histogram.counts[i]++;
+    }
+  }
+  histogram.sum += value;
+  histogram.count++;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineMetrics::AppendHistogram(QString& out, const QString& name, const QString& labels, const Histogram& histogram, const QVector<double>& bounds)
+{
+  QString prefix = labels.isEmpty() ? QString() : labels + ",";
+  for(int i = 0; i < bounds.size(); i++)
+  {
+    out += QString("%1_bucket{%2le=\"%3\"} %4\n").arg(name, prefix).arg(bounds[i], 0, 'g', 15).arg(histogram.counts.value(i));
+  }
+  out += QString("%1_bucket{%2le=\"+Inf\"} %3\n").arg(name, prefix).arg(histogram.count);
+  QString braces = labels.isEmpty() ? QString() : "{" + labels + "}";
+  out += QString("%1_sum%2 %3\n").arg(name, braces).arg(histogram.sum, 0, 'g', 15);
+  out += QString("%1_count%2 %3\n").arg(name, braces).arg(histogram.count);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineMetrics::toText()
+{
+  qint64 bytesRead = 0;
+  qint64 bytesWritten = 0;
+  ReadProcessIo(bytesRead, bytesWritten);
+  qint64 peakMemoryMB = GetPeakMemory();
+
+  QMutexLocker lock(&m_Mutex);
+  QString out;
+  appendValue(out, "simplview_jobs_queued", "gauge", "Jobs waiting for a free slot", m_Queued);
+  appendValue(out, "simplview_jobs_running", "gauge", "Jobs being executed", m_Running);
+  appendValue(out, "simplview_jobs_succeeded_total", "counter", "Jobs that finished without an error", m_Succeeded);
+  appendValue(out, "simplview_jobs_failed_total", "counter", "Jobs that finished with an error", m_Failed);
+  appendValue(out, "simplview_jobs_skipped_total", "counter", "Jobs skipped because they were up to date", m_Skipped);
+
+  appendHeader(out, "simplview_pipeline_duration_seconds", "histogram", "Time to execute a pipeline");
+  for(QMap<QString, Histogram>::const_iterator iter = m_PipelineDurations.constBegin(); iter != m_PipelineDurations.constEnd(); ++iter)
+  {
+    AppendHistogram(out, "simplview_pipeline_duration_seconds", QString("pipeline=\"%1\"").arg(escapeLabel(iter.key())), iter.value(), k_DurationBounds);
+  }
+  appendHeader(out, "simplview_filter_duration_seconds", "histogram", "Time to execute a filter");
+  for(QMap<QString, Histogram>::const_iterator iter = m_FilterDurations.constBegin(); iter != m_FilterDurations.constEnd(); ++iter)
+  {
+    AppendHistogram(out, "simplview_filter_duration_seconds", QString("filter=\"%1\"").arg(escapeLabel(iter.key())), iter.value(), k_DurationBounds);
+  }
+  appendHeader(out, "simplview_job_peak_memory_bytes", "histogram", "Peak resident memory of the process that executed a job");
+  AppendHistogram(out, "simplview_job_peak_memory_bytes", QString(), m_JobMemory, k_MemoryBounds);
+
+  appendValue(out, "simplview_read_bytes_total", "counter", "Bytes read from storage by this process and its workers", bytesRead + m_WorkerBytesRead);
+  appendValue(out, "simplview_written_bytes_total", "counter", "Bytes written to storage by this process and its workers", bytesWritten + m_WorkerBytesWritten);
+  appendValue(out, "simplview_process_peak_memory_bytes", "gauge", "Peak resident memory of this process", peakMemoryMB * 1024.0 * 1024.0);
+  appendValue(out, "simplview_plugin_load_seconds", "gauge", "Time it took to load the plugins", m_PluginLoadTimeMs / 1000.0);
+  appendValue(out, "simplview_plugin_load_failures", "gauge", "Plugins that could not be loaded", m_PluginLoadFailures);
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineMetrics::writeFile(const QString& filePath)
+{
+  QDir().mkpath(QFileInfo(filePath).absolutePath());
+  QSaveFile file(filePath);
+  if(!file.open(QIODevice::WriteOnly | QIODevice::Text))
+  {
+    return false;
+  }
+  file.write(toText().toUtf8());
+  return file.commit();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineMetrics::ReadProcessIo(qint64& bytesRead, qint64& bytesWritten)
+{
+  bytesRead = 0;
+  bytesWritten = 0;
+#if defined(Q_OS_LINUX)
+  QFile io("/proc/self/io");
+  if(!io.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    return;
+  }
+  foreach(QByteArray line, io.readAll().split('\n'))
+  {
+    if(line.startsWith("read_bytes:"))
+    {
+      bytesRead = line.mid(11).trimmed().toLongLong();
+    }
+    else if(line.startsWith("write_bytes:"))
+    {
+      bytesWritten = line.mid(12).trimmed().toLongLong();
+    }
+  }
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 PipelineMetrics::GetPeakMemory()
+{
+#if defined(Q_OS_UNIX)
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage) != 0)
+  {
+    return 0;
+  }
+#if defined(Q_OS_MAC)
+  return usage.ru_maxrss / (1024 * 1024);
+#else
+  return usage.ru_maxrss / 1024;
+#endif
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,165 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLView/HeadlessPipelineRunner.h"
+
+/**
+ * @brief The PipelineMetrics class counts the jobs of the headless modes and keeps histograms
+ * of their durations, per pipeline and per filter, and of their peak memory. The filter
+ * durations come from the PipelineMessage stream of each job (see
+ * HeadlessPipelineObserver::getFilterProfile()). toText() renders everything in the
+ * Prometheus text exposition format, together with the I/O of this process and of the worker
+ * processes. All functions may be called from any thread.
+ */
+class PipelineMetrics
+{
+public:
+  virtual ~PipelineMetrics();
+
+  /**
+   * @brief Instance
+   * @return
+   */
+  static PipelineMetrics* Instance();
+
+  /**
+   * @brief jobsQueued Counts jobs that wait for a free slot
+   * @param count
+   */
+  void jobsQueued(int count);
+
+  /**
+   * @brief jobStarted Moves one job from queued to running
+   */
+  void jobStarted();
+
+  /**
+   * @brief jobFinished Records the outcome of a running job
+   * @param result
+   */
+  void jobFinished(const HeadlessPipelineRunner::Result& result);
+
+  /**
+   * @brief jobSkipped Records a queued job that did not need to run
+   */
+  void jobSkipped();
+
+  /**
+   * @brief setPluginLoadTime
+   * @param loadTimeMs
+   * @param failedCount
+   */
+  void setPluginLoadTime(qint64 loadTimeMs, int failedCount);
+
+  /**
+   * @brief toText Renders every metric in the Prometheus text format
+   * @return
+   */
+  QString toText();
+
+  /**
+   * @brief writeFile Replaces the file with toText()
+   * @param filePath
+   * @return
+   */
+  bool writeFile(const QString& filePath);
+
+  /**
+   * @brief ReadProcessIo Reads how many bytes this process has read from and written to
+   * storage. Linux only; elsewhere both are 0.
+   * @param bytesRead
+   * @param bytesWritten
+   */
+  static void ReadProcessIo(qint64& bytesRead, qint64& bytesWritten);
+
+  /**
+   * @brief GetPeakMemory Returns the peak resident memory of this process in MB
+   * @return
+   */
+  static qint64 GetPeakMemory();
+
+protected:
+  PipelineMetrics();
+
+private:
+  struct Histogram
+  {
+    QVector<qint64> counts;
+    double sum = 0.0;
+    qint64 count = 0;
+  };
+
+  QMutex m_Mutex;
+  qint64 m_Queued = 0;
+  qint64 m_Running = 0;
+  qint64 m_Succeeded = 0;
+  qint64 m_Failed = 0;
+  qint64 m_Skipped = 0;
+  qint64 m_WorkerBytesRead = 0;
+  qint64 m_WorkerBytesWritten = 0;
+  qint64 m_PluginLoadTimeMs = 0;
+  int m_PluginLoadFailures = 0;
+  QMap<QString, Histogram> m_PipelineDurations;
+  QMap<QString, Histogram> m_FilterDurations;
+  Histogram m_JobMemory;
+
+  /**
+   * @brief Observe Adds a value to a histogram with the given bucket bounds
+   * @param histogram
+   * @param bounds
+   * @param value
+   */
+  static void Observe(Histogram& histogram, const QVector<double>& bounds, double value);
+
+  /**
+   * @brief AppendHistogram Renders one labelled histogram
+   * @param out
+   * @param name
+   * @param labels
+   * @param histogram
+   * @param bounds
+   */
+  static void AppendHistogram(QString& out, const QString& name, const QString& labels, const Histogram& histogram, const QVector<double>& bounds);
+
+  PipelineMetrics(const PipelineMetrics&) = delete;  // Copy Constructor Not Implemented
+  void operator=(const PipelineMetrics&) = delete;   // Move assignment Not Implemented
+};
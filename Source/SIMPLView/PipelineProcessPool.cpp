@@ -0,0 +1,1050 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineProcessPool.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMutexLocker>
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#if defined(Q_OS_UNIX)
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#if defined(Q_OS_LINUX)
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+#include "SIMPLib/Messages/PipelineMessage.h"
+
+#include "SIMPLView/PipelineDaemon.h"
+#include "SIMPLView/PipelineMetrics.h"
+
+namespace
+{
+// The highest core id plus one that an affinity mask can hold
+#if defined(Q_OS_LINUX)
+const int k_MaxCpuCount = CPU_SETSIZE;
+#else
+const int k_MaxCpuCount = 1024;
+#endif
+
+#if defined(Q_OS_UNIX)
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool writeAll(int fd, const char* data, qint64 size)
+{
+  while(size > 0)
+  {
+    ssize_t written = ::write(fd, data, static_cast<size_t>(size));
+    if(written < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= written;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool readAll(int fd, char* data, qint64 size)
+{
+  while(size > 0)
+  {
+    ssize_t count = ::read(fd, data, static_cast<size_t>(size));
+    if(count < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+    if(count == 0)
+    {
+      // The other end closed the pipe
+      return false;
+    }
+    data += count;
+    size -= count;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// A frame is the size of a compact JSON document followed by the document
+// -----------------------------------------------------------------------------
+bool writeFrame(int fd, const QJsonObject& object)
+{
+  QByteArray payload = QJsonDocument(object).toJson(QJsonDocument::Compact);
+  quint32 size = static_cast<quint32>(payload.size());
+  return writeAll(fd, reinterpret_cast<const char*>(&size), sizeof(size)) && writeAll(fd, payload.constData(), payload.size());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool readFrame(int fd, QJsonObject& object)
+{
+  quint32 size = 0;
+  if(!readAll(fd, reinterpret_cast<char*>(&size), sizeof(size)))
+  {
+    return false;
+  }
+  QByteArray payload(static_cast<int>(size), Qt::Uninitialized);
+  if(!readAll(fd, payload.data(), size))
+  {
+    return false;
+  }
+  object = QJsonDocument::fromJson(payload).object();
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// Passes a descriptor to the other end of a Unix domain socket
+// -----------------------------------------------------------------------------
+bool sendDescriptor(int socket, int fd)
+{
+  char byte = 0;
+  struct iovec iov;
+  iov.iov_base = &byte;
+  iov.iov_len = 1;
+
+  char control[CMSG_SPACE(sizeof(int))] = {};
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+  forever
+  {
+    ssize_t sent = ::sendmsg(socket, &msg, 0);
+    if(sent < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    return sent == 1;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool receiveDescriptor(int socket, int& fd)
+{
+  char byte = 0;
+  struct iovec iov;
+  iov.iov_base = &byte;
+  iov.iov_len = 1;
+
+  char control[CMSG_SPACE(sizeof(int))] = {};
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t received = -1;
+  do
+  {
+    received = ::recvmsg(socket, &msg, 0);
+  } while(received < 0 && errno == EINTR);
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  if(received != 1 || cmsg == nullptr || cmsg->cmsg_type != SCM_RIGHTS)
+  {
+    return false;
+  }
+  memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString describeExit(qint64 pid, int status)
+{
+  if(WIFSIGNALED(status))
+  {
+    return QString("%1 was killed by signal %2").arg(pid).arg(WTERMSIG(status));
+  }
+  if(WIFEXITED(status))
+  {
+    return QString("%1 exited with code %2").arg(pid).arg(WEXITSTATUS(status));
+  }
+  return QString();
+}
+
+// -----------------------------------------------------------------------------
+// Waits until fd can be read or the deadline passes. A negative deadline waits forever.
+// -----------------------------------------------------------------------------
+bool waitReadable(int fd, qint64 deadlineMs, const QElapsedTimer& timer)
+{
+  forever
+  {
+    int timeout = -1;
+    if(deadlineMs >= 0)
+    {
+      timeout = static_cast<int>(qMax<qint64>(0, deadlineMs - timer.elapsed()));
+    }
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    int ready = ::poll(&pfd, 1, timeout);
+    if(ready < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    // A closed pipe is readable, the read then reports the end of the stream
+    return ready != 0;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Limits how much more address space this process may map. The limit never goes past the
+// one the user set, which is restored by passing it to setrlimit() after the job.
+// -----------------------------------------------------------------------------
+void limitAddressSpace(qint64 extraMB, const struct rlimit& original)
+{
+#if defined(Q_OS_LINUX)
+  if(extraMB <= 0)
+  {
+    return;
+  }
+
+  // The address space the worker already has, the loaded plugins above all, does not
+  // count against the job
+  QFile statm("/proc/self/statm");
+  if(statm.open(QIODevice::ReadOnly))
+  {
+    rlim_t current = static_cast<rlim_t>(statm.readAll().split(' ').value(0).toLongLong() * sysconf(_SC_PAGESIZE));
+    struct rlimit limit = original;
+    limit.rlim_cur = current + static_cast<rlim_t>(extraMB) * 1024 * 1024;
+    if(original.rlim_cur != RLIM_INFINITY)
+    {
+      limit.rlim_cur = qMin(limit.rlim_cur, original.rlim_cur);
+    }
+    setrlimit(RLIMIT_AS, &limit);
+  }
+#else
+  Q_UNUSED(extraMB)
+  Q_UNUSED(original)
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Returns the resident memory of this process in MB
+// -----------------------------------------------------------------------------
+qint64 residentMemory()
+{
+#if defined(Q_OS_LINUX)
+  QFile statm("/proc/self/statm");
+  if(statm.open(QIODevice::ReadOnly))
+  {
+    QList<QByteArray> fields = statm.readAll().split(' ');
+    if(fields.size() > 1)
+    {
+      return fields[1].toLongLong() * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+    }
+  }
+  return 0;
+#else
+  // The peak is the best that is available
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage) != 0)
+  {
+    return 0;
+  }
+  return usage.ru_maxrss / (1024 * 1024);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Resets the peak resident memory of this process, so that the peak after a job belongs to
+// that job and not to an earlier one of the same worker
+// -----------------------------------------------------------------------------
+void resetPeakMemory()
+{
+#if defined(Q_OS_LINUX)
+  QFile clearRefs("/proc/self/clear_refs");
+  if(clearRefs.open(QIODevice::WriteOnly))
+  {
+    clearRefs.write("5");
+  }
+#endif
+}
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineProcessPool::PipelineProcessPool()
+{
+#if defined(Q_OS_UNIX)
+  // A worker that died must show up as a failed write, not kill this process
+  ::signal(SIGPIPE, SIG_IGN);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineProcessPool::~PipelineProcessPool()
+{
+  stop();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineProcessPool::IsSupported()
+{
+#if defined(Q_OS_UNIX)
+  return true;
+#else
+  return false;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineProcessPool::setMaxJobsPerWorker(int maxJobs)
+{
+  m_MaxJobsPerWorker = qMax(1, maxJobs);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineProcessPool::getMaxJobsPerWorker() const
+{
+  return m_MaxJobsPerWorker;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineProcessPool::setMaxWorkerMemory(qint64 megabytes)
+{
+  m_MaxWorkerMemory = qMax<qint64>(0, megabytes);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 PipelineProcessPool::getMaxWorkerMemory() const
+{
+  return m_MaxWorkerMemory;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineProcessPool::setJobLimits(const JobLimits& limits)
+{
+  m_JobLimits = limits;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineProcessPool::JobLimits PipelineProcessPool::getJobLimits() const
+{
+  return m_JobLimits;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineProcessPool::setPlacement(const Placement& placement)
+{
+  QMutexLocker lock(&m_Mutex);
+  m_Placement = placement;
+  m_SlotCpus.clear();
+
+  QVector<QVector<int>> nodes;
+  if(m_Placement.pinToNumaNodes)
+  {
+    foreach(QVector<int> nodeCpus, GetNumaNodeCpus())
+    {
+      QVector<int> usable;
+      for(int cpu : nodeCpus)
+      {
+        if(m_Placement.cpus.isEmpty() || m_Placement.cpus.contains(cpu))
+        {
+          usable.push_back(cpu);
+        }
+      }
+      if(!usable.isEmpty())
+      {
+        nodes.push_back(usable);
+      }
+    }
+  }
+
+  // Without NUMA information every worker may use every allowed core
+  if(nodes.isEmpty() && !m_Placement.cpus.isEmpty())
+  {
+    nodes.push_back(m_Placement.cpus);
+  }
+  m_SlotCpus = nodes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineProcessPool::Placement PipelineProcessPool::getPlacement() const
+{
+  return m_Placement;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<int> PipelineProcessPool::ParseCpuList(const QString& text)
+{
+  std::vector<bool> selected(k_MaxCpuCount, false);
+  foreach(QString range, text.trimmed().split(',', QString::SkipEmptyParts))
+  {
+    bool firstOk = false;
+    bool lastOk = false;
+    int first = range.section('-', 0, 0).trimmed().toInt(&firstOk);
+    int last = range.contains('-') ? range.section('-', 1, 1).trimmed().toInt(&lastOk) : first;
+    if(!firstOk || (range.contains('-') && !lastOk))
+    {
+      return QVector<int>();
+    }
+    // CPU_SET() does not check its argument
+    if(first < 0 || last < first || last >= k_MaxCpuCount)
+    {
+      return QVector<int>();
+    }
+    std::fill(selected.begin() + first, selected.begin() + last + 1, true);
+  }
+
+  QVector<int> cpus;
+  for(int cpu = 0; cpu < k_MaxCpuCount; cpu++)
+  {
+    if(selected[cpu])
+    {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<QVector<int>> PipelineProcessPool::GetNumaNodeCpus()
+{
+  QVector<QVector<int>> nodes;
+#if defined(Q_OS_LINUX)
+  QDir nodeDir("/sys/devices/system/node");
+  QStringList nodeNames = nodeDir.entryList(QStringList() << "node*", QDir::Dirs);
+  std::sort(nodeNames.begin(), nodeNames.end(), [](const QString& a, const QString& b) { return a.mid(4).toInt() < b.mid(4).toInt(); });
+  foreach(QString nodeName, nodeNames)
+  {
+    QFile cpuList(nodeDir.filePath(nodeName + "/cpulist"));
+    if(cpuList.open(QIODevice::ReadOnly))
+    {
+      QVector<int> cpus = ParseCpuList(QString::fromLatin1(cpuList.readAll()));
+      if(!cpus.isEmpty())
+      {
+        nodes.push_back(cpus);
+      }
+    }
+  }
+#endif
+  return nodes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineProcessPool::ApplyPlacement(const QVector<int>& cpus, int niceness, int ioPriority)
+{
+#if defined(Q_OS_LINUX)
+  if(!cpus.isEmpty())
+  {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(int cpu : cpus)
+    {
+      if(cpu >= 0 && cpu < k_MaxCpuCount)
+      {
+        CPU_SET(cpu, &set);
+      }
+    }
+    sched_setaffinity(0, sizeof(set), &set);
+  }
+  if(ioPriority >= 0)
+  {
+    // IOPRIO_WHO_PROCESS and the best-effort class, see ioprio_set(2)
+    const int ioprioClassBestEffort = 2;
+    syscall(SYS_ioprio_set, 1, 0, (ioprioClassBestEffort << 13) | qBound(0, ioPriority, 7));
+  }
+#else
+  Q_UNUSED(cpus)
+  Q_UNUSED(ioPriority)
+#endif
+#if defined(Q_OS_UNIX)
+  if(niceness > 0)
+  {
+    setpriority(PRIO_PROCESS, 0, niceness);
+  }
+#else
+  Q_UNUSED(niceness)
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineProcessPool::start(int workerCount)
+{
+  if(!IsSupported())
+  {
+    return false;
+  }
+
+  QMutexLocker lock(&m_Mutex);
+  if(m_ForkServer < 0 && !startForkServer())
+  {
+    return false;
+  }
+  for(int i = 0; i < workerCount; i++)
+  {
+    Worker worker;
+    worker.slot = i;
+    if(!spawnWorker(worker))
+    {
+      break;
+    }
+    m_IdleWorkers.push_back(worker);
+  }
+  m_WorkerCount = m_IdleWorkers.size();
+  return m_WorkerCount == workerCount;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineProcessPool::stop()
+{
+  QMutexLocker lock(&m_Mutex);
+  for(Worker& worker : m_IdleWorkers)
+  {
+    retireWorker(worker);
+  }
+  m_IdleWorkers.clear();
+  m_WorkerCount = 0;
+  m_WorkerAvailable.wakeAll();
+
+#if defined(Q_OS_UNIX)
+  // The fork server exits at the end of its input
+  if(m_ForkServer >= 0)
+  {
+    ::close(m_ForkServer);
+    ::waitpid(static_cast<pid_t>(m_ForkServerPid), nullptr, 0);
+    m_ForkServer = -1;
+    m_ForkServerPid = -1;
+  }
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+HeadlessPipelineRunner::Result PipelineProcessPool::runJob(const QString& filePath, const QJsonObject& overrides, const MessageCallback& callback, const JobLimits& limits)
+{
+  HeadlessPipelineRunner::Result result;
+  result.filePath = filePath;
+
+  qint64 memoryMB = (limits.memoryMB > 0) ? limits.memoryMB : m_JobLimits.memoryMB;
+  int timeoutSec = (limits.timeoutSec > 0) ? limits.timeoutSec : m_JobLimits.timeoutSec;
+
+  QJsonObject request;
+  request["path"] = filePath;
+  request["overrides"] = overrides;
+  request["messages"] = static_cast<bool>(callback);
+  request["memoryMB"] = static_cast<double>(memoryMB);
+
+  QStringList crashes;
+  for(int attempt = 0; attempt < 2; attempt++)
+  {
+    Worker worker;
+    {
+      QMutexLocker lock(&m_Mutex);
+      while(m_IdleWorkers.isEmpty() && m_WorkerCount > 0)
+      {
+        m_WorkerAvailable.wait(&m_Mutex);
+      }
+      if(m_WorkerCount == 0)
+      {
+        result.errorCode = -1;
+        result.errors.push_back("No worker process is available");
+        return result;
+      }
+      worker = m_IdleWorkers.takeLast();
+    }
+
+    qint64 memory = 0;
+    bool recycle = false;
+    RunStatus status = runOnWorker(worker, request, callback, result, memory, recycle, timeoutSec);
+
+    QMutexLocker lock(&m_Mutex);
+    if(status == RunStatus::TimedOut)
+    {
+#if defined(Q_OS_UNIX)
+      ::kill(static_cast<pid_t>(worker.pid), SIGKILL);
+#endif
+      retireWorker(worker);
+    }
+    else if(status == RunStatus::Crashed)
+    {
+      crashes.push_back(retireWorker(worker));
+    }
+    else if(recycle || ++worker.jobCount >= m_MaxJobsPerWorker || (m_MaxWorkerMemory > 0 && memory > m_MaxWorkerMemory))
+    {
+      // Recycling the worker gives the next jobs a fresh heap
+      retireWorker(worker);
+    }
+
+    if(worker.pid < 0 && m_WorkerCount > 0 && !spawnWorker(worker))
+    {
+      qDebug() << "Could not start a replacement worker process";
+      m_WorkerCount--;
+    }
+    if(worker.pid >= 0)
+    {
+      m_IdleWorkers.push_back(worker);
+    }
+    m_WorkerAvailable.wakeAll();
+
+    if(status == RunStatus::Finished)
+    {
+      return result;
+    }
+    if(status == RunStatus::TimedOut)
+    {
+      // Running it again would only take as long
+      result.errorCode = -1;
+      result.errors = QStringList() << QString("The job exceeded its time limit of %1 s and was stopped").arg(timeoutSec);
+      return result;
+    }
+  }
+
+  // The job took down a fresh worker as well
+  result.errorCode = -1;
+  result.errors.clear();
+  foreach(QString crash, crashes)
+  {
+    result.errors.push_back("The worker process " + crash);
+  }
+  if(memoryMB > 0)
+  {
+    result.errors.push_back(QString("The job had a memory limit of %1 MB, which it may have exceeded").arg(memoryMB));
+  }
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineProcessPool::startForkServer()
+{
+#if defined(Q_OS_UNIX)
+  int sockets[2];
+  if(::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+  {
+    return false;
+  }
+
+  pid_t pid = ::fork();
+  if(pid < 0)
+  {
+    ::close(sockets[0]);
+    ::close(sockets[1]);
+    return false;
+  }
+  if(pid == 0)
+  {
+    ::close(sockets[0]);
+    forkServerMain(sockets[1]);
+  }
+
+  ::close(sockets[1]);
+  m_ForkServer = sockets[0];
+  m_ForkServerPid = pid;
+  return true;
+#else
+  return false;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineProcessPool::forkServerMain(int control)
+{
+#if defined(Q_OS_UNIX)
+  forever
+  {
+    QJsonObject request;
+    if(!readFrame(control, request))
+    {
+      // The pool was stopped. Workers that still run are reaped by init.
+      ::_exit(0);
+    }
+
+    QJsonObject reply;
+    if(request["command"].toString() == "wait")
+    {
+      int status = 0;
+      qint64 pid = static_cast<qint64>(request["pid"].toDouble());
+      if(::waitpid(static_cast<pid_t>(pid), &status, 0) > 0)
+      {
+        reply["ending"] = describeExit(pid, status);
+      }
+      writeFrame(control, reply);
+      continue;
+    }
+
+    // Only this process and the worker hold the ends of the worker's socket, so the worker
+    // sees the end of its input when the pool lets it go
+    int sockets[2];
+    pid_t pid = -1;
+    if(::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0)
+    {
+      pid = ::fork();
+      if(pid == 0)
+      {
+        ::close(control);
+        ::close(sockets[0]);
+        QVector<int> cpus;
+        foreach(const QJsonValue& cpu, request["cpus"].toArray())
+        {
+          cpus.push_back(cpu.toInt());
+        }
+        ApplyPlacement(cpus, request["niceness"].toInt(), request["ioPriority"].toInt(-1));
+        WorkerMain(sockets[1], sockets[1]);
+      }
+      ::close(sockets[1]);
+      if(pid < 0)
+      {
+        ::close(sockets[0]);
+      }
+    }
+
+    reply["pid"] = static_cast<double>(pid);
+    writeFrame(control, reply);
+    if(pid > 0)
+    {
+      sendDescriptor(control, sockets[0]);
+      ::close(sockets[0]);
+    }
+  }
+#else
+  Q_UNUSED(control)
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineProcessPool::spawnWorker(Worker& worker)
+{
+#if defined(Q_OS_UNIX)
+  QJsonObject request;
+  request["command"] = QString("spawn");
+  QJsonArray cpus;
+  foreach(int cpu, m_SlotCpus.isEmpty() ? QVector<int>() : m_SlotCpus[worker.slot % m_SlotCpus.size()])
+  {
+    cpus.append(cpu);
+  }
+  request["cpus"] = cpus;
+  request["niceness"] = m_Placement.niceness;
+  request["ioPriority"] = m_Placement.ioPriority;
+
+  QJsonObject reply;
+  if(m_ForkServer < 0 || !writeFrame(m_ForkServer, request) || !readFrame(m_ForkServer, reply))
+  {
+    return false;
+  }
+  qint64 pid = static_cast<qint64>(reply["pid"].toDouble(-1));
+  int fd = -1;
+  if(pid <= 0 || !receiveDescriptor(m_ForkServer, fd))
+  {
+    return false;
+  }
+
+  worker.pid = pid;
+  worker.fd = fd;
+  worker.jobCount = 0;
+  return true;
+#else
+  Q_UNUSED(worker)
+  return false;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineProcessPool::retireWorker(Worker& worker)
+{
+  QString ending;
+#if defined(Q_OS_UNIX)
+  ::close(worker.fd);
+
+  // The worker is a child of the fork server, which reaps it
+  QJsonObject request;
+  request["command"] = QString("wait");
+  request["pid"] = static_cast<double>(worker.pid);
+  QJsonObject reply;
+  if(m_ForkServer >= 0 && writeFrame(m_ForkServer, request) && readFrame(m_ForkServer, reply))
+  {
+    ending = reply["ending"].toString();
+  }
+#endif
+  int slot = worker.slot;
+  worker = Worker();
+  worker.slot = slot;
+  return ending;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineProcessPool::RunStatus PipelineProcessPool::runOnWorker(Worker& worker, const QJsonObject& request, const MessageCallback& callback, HeadlessPipelineRunner::Result& result,
+                                                                qint64& peakMemory, bool& recycle, int timeoutSec)
+{
+#if defined(Q_OS_UNIX)
+  QElapsedTimer timer;
+  timer.start();
+  qint64 deadlineMs = (timeoutSec > 0) ? timeoutSec * 1000LL : -1;
+
+  if(!writeFrame(worker.fd, request))
+  {
+    return RunStatus::Crashed;
+  }
+
+  forever
+  {
+    if(!waitReadable(worker.fd, deadlineMs, timer))
+    {
+      return RunStatus::TimedOut;
+    }
+
+    QJsonObject message;
+    if(!readFrame(worker.fd, message))
+    {
+      return RunStatus::Crashed;
+    }
+
+    if(message["type"].toString() == "message")
+    {
+      if(callback)
+      {
+        callback(message);
+      }
+      continue;
+    }
+
+    result.errorCode = message["errorCode"].toInt();
+    result.elapsedMs = static_cast<qint64>(message["elapsedMs"].toDouble());
+    result.errors.clear();
+    foreach(QJsonValue error, message["errors"].toArray())
+    {
+      result.errors.push_back(error.toString());
+    }
+    result.warnings.clear();
+    foreach(QJsonValue warning, message["warnings"].toArray())
+    {
+      result.warnings.push_back(warning.toString());
+    }
+    result.peakMemoryMB = static_cast<qint64>(message["peakMemory"].toDouble());
+    result.bytesRead = static_cast<qint64>(message["bytesRead"].toDouble());
+    result.bytesWritten = static_cast<qint64>(message["bytesWritten"].toDouble());
+    result.filterProfile.clear();
+    foreach(QJsonValue record, message["filterProfile"].toArray())
+    {
+      result.filterProfile.push_back(FilterProfiler::RecordFromJson(record.toObject()));
+    }
+    result.cachedFilters.clear();
+    foreach(QJsonValue index, message["cachedFilters"].toArray())
+    {
+      result.cachedFilters.push_back(index.toInt());
+    }
+    peakMemory = static_cast<qint64>(message["memory"].toDouble());
+    recycle = message["recycle"].toBool();
+    return RunStatus::Finished;
+  }
+#else
+  Q_UNUSED(worker)
+  Q_UNUSED(request)
+  Q_UNUSED(callback)
+  Q_UNUSED(result)
+  Q_UNUSED(peakMemory)
+  Q_UNUSED(recycle)
+  Q_UNUSED(timeoutSec)
+  return RunStatus::Crashed;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineProcessPool::WorkerMain(int fromParent, int toParent)
+{
+#if defined(Q_OS_UNIX)
+  // The limit the user set, which every job starts from
+  struct rlimit originalLimit;
+  getrlimit(RLIMIT_AS, &originalLimit);
+
+  forever
+  {
+    QJsonObject request;
+    if(!readFrame(fromParent, request))
+    {
+      // The pool let this worker go. Nothing of the parent's may be cleaned up here.
+      ::_exit(0);
+    }
+
+    HeadlessPipelineObserver::MessageCallback callback;
+    if(request["messages"].toBool())
+    {
+      callback = [toParent](const PipelineMessage& pm) { writeFrame(toParent, PipelineDaemon::MessageToJson(pm)); };
+    }
+
+    qint64 memoryMB = static_cast<qint64>(request["memoryMB"].toDouble());
+    bool recycle = false;
+    HeadlessPipelineRunner::Result result;
+    qint64 bytesReadBefore = 0;
+    qint64 bytesWrittenBefore = 0;
+    PipelineMetrics::ReadProcessIo(bytesReadBefore, bytesWrittenBefore);
+    resetPeakMemory();
+    limitAddressSpace(memoryMB, originalLimit);
+    try
+    {
+      result = HeadlessPipelineRunner::RunPipeline(request["path"].toString(), request["overrides"].toObject(), callback);
+    } catch(const std::bad_alloc&)
+    {
+      // What the pipeline left behind cannot be trusted, so this worker is replaced
+      recycle = true;
+    }
+    setrlimit(RLIMIT_AS, &originalLimit);
+
+    if(recycle)
+    {
+      result.filePath = request["path"].toString();
+      result.errorCode = -1;
+      result.errors.clear();
+      result.errors.push_back((memoryMB > 0) ? QString("The job exceeded its memory limit of %1 MB").arg(memoryMB) : QString("The job ran out of memory"));
+    }
+
+    qint64 bytesRead = 0;
+    qint64 bytesWritten = 0;
+    PipelineMetrics::ReadProcessIo(bytesRead, bytesWritten);
+    QJsonArray filterProfile;
+    for(const FilterProfiler::Record& record : result.filterProfile)
+    {
+      filterProfile.push_back(FilterProfiler::RecordToJson(record));
+    }
+    QJsonArray cachedFilters;
+    foreach(int index, result.cachedFilters)
+    {
+      cachedFilters.append(index);
+    }
+
+    QJsonObject response;
+    response["type"] = QString("result");
+    response["recycle"] = recycle;
+    response["errorCode"] = result.errorCode;
+    response["elapsedMs"] = static_cast<double>(result.elapsedMs);
+    response["errors"] = QJsonArray::fromStringList(result.errors);
+    response["warnings"] = QJsonArray::fromStringList(result.warnings);
+    response["memory"] = static_cast<double>(residentMemory());
+    response["peakMemory"] = static_cast<double>(PipelineMetrics::GetPeakMemory());
+    response["bytesRead"] = static_cast<double>(bytesRead - bytesReadBefore);
+    response["bytesWritten"] = static_cast<double>(bytesWritten - bytesWrittenBefore);
+    response["filterProfile"] = filterProfile;
+    response["cachedFilters"] = cachedFilters;
+    if(!writeFrame(toParent, response))
+    {
+      ::_exit(0);
+    }
+  }
+#else
+  Q_UNUSED(fromParent)
+  Q_UNUSED(toParent)
+#endif
+}
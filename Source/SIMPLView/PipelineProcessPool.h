@@ -0,0 +1,279 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+
+#include "SIMPLView/HeadlessPipelineRunner.h"
+
+/**
+ * @brief The PipelineProcessPool class executes pipeline jobs in separate worker processes so
+ * that a crashing filter only takes its own job down and every job starts with a fresh heap.
+ *
+ * start() forks a fork server after the plugins have been loaded, and every worker, the
+ * replacements included, is forked from it, so a worker starts with every filter registered and
+ * is never forked from a process that runs other threads. Jobs and results travel over
+ * sockets. A worker is replaced after getMaxJobsPerWorker() jobs or once its resident memory
+ * after a job passes getMaxWorkerMemory(). A job whose worker dies is run once more on a fresh
+ * worker.
+ *
+ * runJob() blocks and may be called from several threads at the same time; each call uses
+ * one idle worker. start() must be called before the process starts any thread of its own.
+ *
+ * Every job can be given a memory cap and a time limit (JobLimits). A job that runs out of
+ * memory or time fails with a message that says so. The workers themselves can be pinned to
+ * cores, one NUMA node per worker, and run with a lower CPU and I/O priority (Placement).
+ *
+ * Only available where fork() is (IsSupported()). Core pinning and I/O priority are Linux only.
+ */
+class PipelineProcessPool
+{
+public:
+  using MessageCallback = std::function<void(const QJsonObject&)>;
+
+  /**
+   * @brief The limits of one job. 0 means no limit.
+   */
+  struct JobLimits
+  {
+    qint64 memoryMB = 0;
+    int timeoutSec = 0;
+  };
+
+  /**
+   * @brief Where and how the worker processes run
+   */
+  struct Placement
+  {
+    QVector<int> cpus;
+    bool pinToNumaNodes = false;
+    int niceness = 0;
+    int ioPriority = -1;
+  };
+
+  PipelineProcessPool();
+  virtual ~PipelineProcessPool();
+
+  /**
+   * @brief IsSupported Returns false on platforms without fork()
+   * @return
+   */
+  static bool IsSupported();
+
+  /**
+   * @brief setMaxJobsPerWorker Sets after how many jobs a worker is replaced
+   * @param maxJobs
+   */
+  void setMaxJobsPerWorker(int maxJobs);
+
+  /**
+   * @brief getMaxJobsPerWorker
+   * @return
+   */
+  int getMaxJobsPerWorker() const;
+
+  /**
+   * @brief setMaxWorkerMemory Sets the resident memory in MB past which a worker is
+   * replaced, 0 for no limit
+   * @param megabytes
+   */
+  void setMaxWorkerMemory(qint64 megabytes);
+
+  /**
+   * @brief getMaxWorkerMemory
+   * @return
+   */
+  qint64 getMaxWorkerMemory() const;
+
+  /**
+   * @brief setJobLimits Sets the limits of the jobs that do not bring their own
+   * @param limits
+   */
+  void setJobLimits(const JobLimits& limits);
+
+  /**
+   * @brief getJobLimits
+   * @return
+   */
+  JobLimits getJobLimits() const;
+
+  /**
+   * @brief setPlacement Sets the cores the workers may use, whether each worker stays on the
+   * cores of one NUMA node, their nice value and their best-effort I/O priority (0-7, -1 to
+   * keep the default). Takes effect for the workers started afterwards.
+   * @param placement
+   */
+  void setPlacement(const Placement& placement);
+
+  /**
+   * @brief getPlacement
+   * @return
+   */
+  Placement getPlacement() const;
+
+  /**
+   * @brief ParseCpuList Reads a list of cores in the format of /sys and taskset: "0-3,8,10-11"
+   * @param text
+   * @return The cores in ascending order, each once. Empty if the list is malformed or names
+   * a core that an affinity mask cannot hold.
+   */
+  static QVector<int> ParseCpuList(const QString& text);
+
+  /**
+   * @brief GetNumaNodeCpus Returns the cores of every NUMA node, or nothing where this is not known
+   * @return
+   */
+  static QVector<QVector<int>> GetNumaNodeCpus();
+
+  /**
+   * @brief start Forks the fork server and the worker processes. No other thread may run yet.
+   * @param workerCount
+   * @return False if the workers could not be started
+   */
+  bool start(int workerCount);
+
+  /**
+   * @brief stop Lets the idle workers exit. Called by the destructor.
+   */
+  void stop();
+
+  /**
+   * @brief runJob Executes one pipeline file on a worker process
+   * @param filePath
+   * @param overrides See HeadlessPipelineRunner::ReadPipeline()
+   * @param callback Receives every pipeline message as converted by PipelineDaemon::MessageToJson(),
+   * may be empty
+   * @param limits Limits of this job; fields that are 0 fall back to getJobLimits()
+   * @return
+   */
+  HeadlessPipelineRunner::Result runJob(const QString& filePath, const QJsonObject& overrides = QJsonObject(), const MessageCallback& callback = MessageCallback(),
+                                        const JobLimits& limits = JobLimits());
+
+private:
+  enum class RunStatus
+  {
+    Finished,
+    Crashed,
+    TimedOut
+  };
+
+  struct Worker
+  {
+    int slot = 0;
+    qint64 pid = -1;
+    int fd = -1;
+    int jobCount = 0;
+  };
+
+  QMutex m_Mutex;
+  QWaitCondition m_WorkerAvailable;
+  QVector<Worker> m_IdleWorkers;
+  int m_ForkServer = -1;
+  qint64 m_ForkServerPid = -1;
+  int m_WorkerCount = 0;
+  int m_MaxJobsPerWorker = 50;
+  qint64 m_MaxWorkerMemory = 0;
+  JobLimits m_JobLimits;
+  Placement m_Placement;
+  QVector<QVector<int>> m_SlotCpus;
+
+  /**
+   * @brief startForkServer Forks the process that forks the workers. m_Mutex must be locked.
+   * @return
+   */
+  bool startForkServer();
+
+  /**
+   * @brief forkServerMain The loop of the fork server. It forks a worker for every "spawn"
+   * request and passes the worker's socket back, and reaps the worker on a "wait" request.
+   * Never returns.
+   * @param control
+   */
+  void forkServerMain(int control);
+
+  /**
+   * @brief spawnWorker Has the fork server fork a new worker. m_Mutex must be locked.
+   * @param worker
+   * @return
+   */
+  bool spawnWorker(Worker& worker);
+
+  /**
+   * @brief retireWorker Closes the socket of a worker and waits for it to exit
+   * @param worker
+   * @return A description of how the worker ended
+   */
+  QString retireWorker(Worker& worker);
+
+  /**
+   * @brief runOnWorker Sends the job to the worker and reads its messages until the result
+   * @param worker
+   * @param request
+   * @param callback
+   * @param result
+   * @param peakMemory Set to the resident memory of the worker in MB after the job
+   * @param recycle Set if the worker must not run another job
+   * @param timeoutSec 0 to wait for the result as long as it takes
+   * @return Whether the result arrived, the worker died or the time ran out
+   */
+  RunStatus runOnWorker(Worker& worker, const QJsonObject& request, const MessageCallback& callback, HeadlessPipelineRunner::Result& result, qint64& peakMemory, bool& recycle,
+                        int timeoutSec);
+
+  /**
+   * @brief ApplyPlacement Pins and deprioritizes a freshly forked worker before it starts any
+   * thread, so that every thread it starts later inherits the settings
+   * @param cpus
+   * @param niceness
+   * @param ioPriority
+   */
+  static void ApplyPlacement(const QVector<int>& cpus, int niceness, int ioPriority);
+
+  /**
+   * @brief WorkerMain The loop of a worker process. Never returns.
+   * @param fromParent
+   * @param toParent
+   */
+  static void WorkerMain(int fromParent, int toParent);
+
+  PipelineProcessPool(const PipelineProcessPool&) = delete; // Copy Constructor Not Implemented
+  void operator=(const PipelineProcessPool&) = delete;      // Move assignment Not Implemented
+};
@@ -0,0 +1,171 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PluginLoadReport.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTextStream>
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PluginLoadReport::PluginLoadReport() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PluginLoadReport::~PluginLoadReport() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PluginLoadReport::addFailure(const QString& filePath, const QString& errorString, qint64 loadTimeMs)
+{
+  Failure failure;
+  failure.filePath = filePath;
+  failure.errorString = errorString;
+  failure.loadTimeMs = loadTimeMs;
+  failure.missingLibrary = FindMissingLibrary(errorString);
+  if(failure.missingLibrary == QFileInfo(filePath).fileName())
+  {
+    // The plugin itself is what could not be opened
+    failure.missingLibrary.clear();
+  }
+  m_Failures.push_back(failure);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<PluginLoadReport::Failure> PluginLoadReport::getFailures() const
+{
+  return m_Failures;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PluginLoadReport::isEmpty() const
+{
+  return m_Failures.isEmpty();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PluginLoadReport::clear()
+{
+  m_Failures.clear();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PluginLoadReport::toText() const
+{
+  QString text;
+  QTextStream out(&text);
+  foreach(Failure failure, m_Failures)
+  {
+    out << QFileInfo(failure.filePath).fileName() << "\n";
+    out << "  Path: " << QDir::toNativeSeparators(failure.filePath) << "\n";
+    out << "  Error: " << failure.errorString << "\n";
+    if(!failure.missingLibrary.isEmpty())
+    {
+      out << "  Missing Library: " << failure.missingLibrary << "\n";
+    }
+    out << "  Time Spent: " << failure.loadTimeMs << " ms\n";
+  }
+  return text;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PluginLoadReport::appendToLog(const QString& filePath) const
+{
+  QFileInfo fi(filePath);
+  if(!QDir().mkpath(fi.absolutePath()))
+  {
+    return false;
+  }
+
+  QFile file(filePath);
+  if(!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+  {
+    return false;
+  }
+
+  QTextStream out(&file);
+  out << "[" << QDateTime::currentDateTime().toString(Qt::ISODate) << "] " << m_Failures.size() << " plugin(s) failed to load\n";
+  out << toText() << "\n";
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PluginLoadReport::GetLogFilePath()
+{
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/PluginLoadFailures.log";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PluginLoadReport::FindMissingLibrary(const QString& errorString)
+{
+  // Linux: "... (libFoo.so.1: cannot open shared object file: No such file or directory)"
+  static const QRegularExpression linuxExpression("([^\\s:()]+): cannot open shared object file");
+  // macOS: "... Library not loaded: @rpath/libFoo.dylib ..."
+  static const QRegularExpression macExpression("Library not loaded: (\\S+)");
+
+  QRegularExpressionMatch match = linuxExpression.match(errorString);
+  if(match.hasMatch())
+  {
+    return match.captured(1);
+  }
+  match = macExpression.match(errorString);
+  if(match.hasMatch())
+  {
+    return match.captured(1);
+  }
+  return QString();
+}
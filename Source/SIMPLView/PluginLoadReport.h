@@ -0,0 +1,116 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+/**
+ * @brief The PluginLoadReport class collects the plugins that failed to load so that they can
+ * be reported together once loading is done, instead of stopping the startup for each one.
+ */
+class PluginLoadReport
+{
+public:
+  /**
+   * @brief A plugin library that could not be opened
+   */
+  struct Failure
+  {
+    QString filePath;
+    QString errorString;
+    qint64 loadTimeMs = 0;
+    QString missingLibrary;
+  };
+
+  PluginLoadReport();
+  virtual ~PluginLoadReport();
+
+  /**
+   * @brief addFailure
+   * @param filePath
+   * @param errorString The error string of the QPluginLoader
+   * @param loadTimeMs The time spent trying to open the library
+   */
+  void addFailure(const QString& filePath, const QString& errorString, qint64 loadTimeMs);
+
+  /**
+   * @brief getFailures
+   * @return
+   */
+  QVector<Failure> getFailures() const;
+
+  /**
+   * @brief isEmpty
+   * @return
+   */
+  bool isEmpty() const;
+
+  /**
+   * @brief clear
+   */
+  void clear();
+
+  /**
+   * @brief toText Returns a readable report with one paragraph per failure
+   * @return
+   */
+  QString toText() const;
+
+  /**
+   * @brief appendToLog Appends the time stamped report to the log file
+   * @param filePath
+   * @return
+   */
+  bool appendToLog(const QString& filePath) const;
+
+  /**
+   * @brief GetLogFilePath Returns the log file in the application data directory
+   * @return
+   */
+  static QString GetLogFilePath();
+
+  /**
+   * @brief FindMissingLibrary Returns the dependent library named in the error string of a
+   * QPluginLoader, or an empty string if the platform does not name it (Windows)
+   * @param errorString
+   * @return
+   */
+  static QString FindMissingLibrary(const QString& errorString);
+
+private:
+  QVector<Failure> m_Failures;
+};
@@ -0,0 +1,456 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PluginManifest.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+#include "SIMPLView/SIMPLViewVersion.h"
+
+namespace
+{
+const int k_ManifestVersion = 2;
+
+const QString k_Version("Version");
+const QString k_ApplicationVersion("ApplicationVersion");
+const QString k_Directories("Directories");
+const QString k_Plugins("Plugins");
+const QString k_Path("Path");
+const QString k_Size("Size");
+const QString k_LastModified("LastModified");
+const QString k_Files("Files");
+const QString k_Sha1("Sha1");
+const QString k_PluginName("PluginName");
+const QString k_Filters("Filters");
+const QString k_FiltersKnown("FiltersKnown");
+const QString k_ClassName("ClassName");
+const QString k_Uuid("Uuid");
+const QString k_HumanLabel("HumanLabel");
+const QString k_Group("Group");
+const QString k_SubGroup("SubGroup");
+const QString k_CompiledLibraryName("CompiledLibraryName");
+const QString k_BrandingString("BrandingString");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PluginManifest::PluginManifest() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PluginManifest::~PluginManifest() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PluginManifest::GetUserManifestFilePath()
+{
+  QString dirPath = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+  return dirPath + "/PluginManifest.json";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PluginManifest::GetInstallManifestFileName()
+{
+  return QString("PluginManifest.json");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QByteArray PluginManifest::ComputeHash(const QString& filePath)
+{
+  QFile file(filePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return QByteArray();
+  }
+
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  if(!hash.addData(&file))
+  {
+    return QByteArray();
+  }
+  return hash.result().toHex();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 PluginManifest::LastModified(const QFileInfo& fi)
+{
+  return fi.lastModified().toMSecsSinceEpoch();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PluginManifest::readFile(const QString& filePath)
+{
+  QFile file(filePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return false;
+  }
+
+  QJsonParseError parseError;
+  QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+  if(parseError.error != QJsonParseError::NoError || !doc.isObject())
+  {
+    qDebug() << "Ignoring unreadable plugin manifest" << filePath << ":" << parseError.errorString();
+    return false;
+  }
+
+  QJsonObject root = doc.object();
+  if(root[k_Version].toInt() != k_ManifestVersion)
+  {
+    return false;
+  }
+
+  // Another build may load plugins differently, so everything it recorded is rescanned
+  if(root[k_ApplicationVersion].toString() != SIMPLView::Version::Complete())
+  {
+    qDebug() << "Ignoring plugin manifest" << filePath << "written by version" << root[k_ApplicationVersion].toString();
+    return false;
+  }
+
+  // Relative paths are relative to the directory that holds the manifest
+  QDir manifestDir = QFileInfo(filePath).absoluteDir();
+
+  QJsonArray dirArray = root[k_Directories].toArray();
+  for(const QJsonValue& dirValue : dirArray)
+  {
+    QJsonObject dirObj = dirValue.toObject();
+    DirectoryEntry dirEntry;
+    dirEntry.dirPath = QDir::cleanPath(manifestDir.absoluteFilePath(dirObj[k_Path].toString()));
+    dirEntry.lastModified = static_cast<qint64>(dirObj[k_LastModified].toDouble(-1));
+    QJsonArray files = dirObj[k_Files].toArray();
+    for(const QJsonValue& fileValue : files)
+    {
+      dirEntry.fileNames.push_back(fileValue.toString());
+    }
+
+    if(!m_Directories.contains(dirEntry.dirPath))
+    {
+      m_Directories.insert(dirEntry.dirPath, dirEntry);
+    }
+  }
+
+  QJsonArray pluginArray = root[k_Plugins].toArray();
+  for(const QJsonValue& pluginValue : pluginArray)
+  {
+    QJsonObject pluginObj = pluginValue.toObject();
+    PluginEntry entry;
+    entry.filePath = QDir::cleanPath(manifestDir.absoluteFilePath(pluginObj[k_Path].toString()));
+    entry.size = static_cast<qint64>(pluginObj[k_Size].toDouble(-1));
+    entry.lastModified = static_cast<qint64>(pluginObj[k_LastModified].toDouble(-1));
+    entry.sha1 = pluginObj[k_Sha1].toString().toLatin1();
+    entry.pluginName = pluginObj[k_PluginName].toString();
+    entry.filtersKnown = pluginObj[k_FiltersKnown].toBool(false);
+
+    QJsonArray filterArray = pluginObj[k_Filters].toArray();
+    for(const QJsonValue& filterValue : filterArray)
+    {
+      QJsonObject filterObj = filterValue.toObject();
+      FilterEntry filter;
+      filter.className = filterObj[k_ClassName].toString();
+      filter.uuid = QUuid(filterObj[k_Uuid].toString());
+      filter.humanLabel = filterObj[k_HumanLabel].toString();
+      filter.group = filterObj[k_Group].toString();
+      filter.subGroup = filterObj[k_SubGroup].toString();
+      filter.compiledLibraryName = filterObj[k_CompiledLibraryName].toString();
+      filter.brandingString = filterObj[k_BrandingString].toString();
+      entry.filters.push_back(filter);
+    }
+
+    if(!m_Plugins.contains(entry.filePath))
+    {
+      m_Plugins.insert(entry.filePath, entry);
+    }
+  }
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PluginManifest::writeFile(const QString& filePath) const
+{
+  QFileInfo fi(filePath);
+  QDir manifestDir = fi.absoluteDir();
+  if(!manifestDir.exists() && !manifestDir.mkpath("."))
+  {
+    return false;
+  }
+
+  auto relativePath = [&manifestDir](const QString& path) {
+    QString relPath = manifestDir.relativeFilePath(path);
+    return relPath.startsWith("..") ? path : relPath;
+  };
+
+  QJsonArray dirArray;
+  for(const DirectoryEntry& dirEntry : m_Directories)
+  {
+    QJsonObject dirObj;
+    dirObj[k_Path] = relativePath(dirEntry.dirPath);
+    dirObj[k_LastModified] = static_cast<double>(dirEntry.lastModified);
+    dirObj[k_Files] = QJsonArray::fromStringList(dirEntry.fileNames);
+    dirArray.push_back(dirObj);
+  }
+
+  QJsonArray pluginArray;
+  for(const PluginEntry& entry : m_Plugins)
+  {
+    QJsonObject pluginObj;
+    pluginObj[k_Path] = relativePath(entry.filePath);
+    pluginObj[k_Size] = static_cast<double>(entry.size);
+    pluginObj[k_LastModified] = static_cast<double>(entry.lastModified);
+    pluginObj[k_Sha1] = QString::fromLatin1(entry.sha1);
+    pluginObj[k_PluginName] = entry.pluginName;
+    pluginObj[k_FiltersKnown] = entry.filtersKnown;
+
+    QJsonArray filterArray;
+    for(const FilterEntry& filter : entry.filters)
+    {
+      QJsonObject filterObj;
+      filterObj[k_ClassName] = filter.className;
+      filterObj[k_Uuid] = filter.uuid.toString();
+      filterObj[k_HumanLabel] = filter.humanLabel;
+      filterObj[k_Group] = filter.group;
+      filterObj[k_SubGroup] = filter.subGroup;
+      filterObj[k_CompiledLibraryName] = filter.compiledLibraryName;
+      filterObj[k_BrandingString] = filter.brandingString;
+      filterArray.push_back(filterObj);
+    }
+    pluginObj[k_Filters] = filterArray;
+    pluginArray.push_back(pluginObj);
+  }
+
+  QJsonObject root;
+  root[k_Version] = k_ManifestVersion;
+  root[k_ApplicationVersion] = SIMPLView::Version::Complete();
+  root[k_Directories] = dirArray;
+  root[k_Plugins] = pluginArray;
+
+  QSaveFile file(filePath);
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+  file.write(QJsonDocument(root).toJson());
+  return file.commit();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList PluginManifest::findPluginFiles(const QStringList& pluginDirs, bool (*nameFilter)(const QString&))
+{
+  QStringList pluginFilePaths;
+
+  foreach(QString pluginDirString, pluginDirs)
+  {
+    QFileInfo dirInfo(pluginDirString);
+    if(!dirInfo.isDir())
+    {
+      continue;
+    }
+
+    QString dirPath = QDir::cleanPath(dirInfo.absoluteFilePath());
+    qint64 lastModified = LastModified(dirInfo);
+
+    DirectoryEntry& dirEntry = m_Directories[dirPath];
+    if(dirEntry.dirPath.isEmpty() || dirEntry.lastModified != lastModified)
+    {
+      qDebug() << "Plugin Directory being Searched: " << pluginDirString;
+      dirEntry.dirPath = dirPath;
+      dirEntry.lastModified = lastModified;
+      dirEntry.fileNames.clear();
+
+      QDir aPluginDir(dirPath);
+      foreach(QString fileName, aPluginDir.entryList(QDir::Files))
+      {
+        if(nameFilter(fileName))
+        {
+          dirEntry.fileNames.push_back(fileName);
+        }
+      }
+      m_Dirty = true;
+    }
+
+    foreach(QString fileName, dirEntry.fileNames)
+    {
+      pluginFilePaths << dirPath + "/" + fileName;
+    }
+  }
+
+  return pluginFilePaths;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PluginManifest::isCurrent(const QString& filePath)
+{
+  if(!m_Plugins.contains(filePath))
+  {
+    return false;
+  }
+
+  PluginEntry& entry = m_Plugins[filePath];
+  QFileInfo fi(filePath);
+  if(!fi.exists())
+  {
+    return false;
+  }
+
+  qint64 lastModified = LastModified(fi);
+  if(entry.size == fi.size() && entry.lastModified == lastModified)
+  {
+    return true;
+  }
+
+  if(entry.size != fi.size() || entry.sha1.isEmpty())
+  {
+    return false;
+  }
+
+  // Same size but a new time stamp, which is what copying or re-installing does
+  if(ComputeHash(filePath) != entry.sha1)
+  {
+    return false;
+  }
+
+  entry.lastModified = lastModified;
+  m_Dirty = true;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PluginManifest::contains(const QString& filePath) const
+{
+  return m_Plugins.contains(filePath);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PluginManifest::PluginEntry PluginManifest::getEntry(const QString& filePath) const
+{
+  return m_Plugins.value(filePath);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PluginManifest::updateEntry(const QString& filePath, const QString& pluginName, const QVector<FilterEntry>& filters, bool filtersKnown)
+{
+  QFileInfo fi(filePath);
+
+  PluginEntry& entry = m_Plugins[filePath];
+  qint64 lastModified = LastModified(fi);
+  bool fileChanged = (entry.size != fi.size() || entry.lastModified != lastModified || entry.sha1.isEmpty());
+
+  entry.filePath = filePath;
+  entry.size = fi.size();
+  entry.lastModified = lastModified;
+  if(fileChanged)
+  {
+    entry.sha1 = ComputeHash(filePath);
+  }
+  entry.pluginName = pluginName;
+
+  // Do not forget the filters that a previous launch recorded if this launch
+  // only opened the plugin without registering it
+  if(filtersKnown || fileChanged)
+  {
+    entry.filters = filters;
+    entry.filtersKnown = filtersKnown;
+  }
+  m_Dirty = true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PluginManifest::removeMissingEntries(const QStringList& filePaths)
+{
+  QStringList stalePaths;
+  for(const PluginEntry& entry : m_Plugins)
+  {
+    if(!filePaths.contains(entry.filePath))
+    {
+      stalePaths.push_back(entry.filePath);
+    }
+  }
+
+  foreach(QString stalePath, stalePaths)
+  {
+    m_Plugins.remove(stalePath);
+    m_Dirty = true;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<PluginManifest::PluginEntry> PluginManifest::getEntries() const
+{
+  return m_Plugins.values().toVector();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PluginManifest::isDirty() const
+{
+  return m_Dirty;
+}
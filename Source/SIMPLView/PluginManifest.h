@@ -0,0 +1,209 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QMap>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+
+/**
+ * @brief The PluginManifest class is an on-disk description of the .guiplugin files that
+ * were found the last time SIMPLView started. Each plugin is keyed by its path, size,
+ * modification time and content hash and records the plugin name along with the class
+ * names and UUIDs of the filters that it registers. This allows SIMPLView to find the
+ * plugin files without listing the plugin directories and to know which plugin a file
+ * contains without having to open the library.
+ *
+ * A plugin file that is unchanged since the manifest was written can be described by
+ * its entry alone, which is what lazy plugin activation relies on.
+ */
+class PluginManifest
+{
+public:
+  PluginManifest();
+  virtual ~PluginManifest();
+
+  /**
+   * @brief The FilterEntry struct describes one filter that a plugin registers. Besides the
+   * class name and UUID it holds everything the filter library needs to list the filter
+   * before its plugin has been opened.
+   */
+  struct FilterEntry
+  {
+    QString className;
+    QUuid uuid;
+    QString humanLabel;
+    QString group;
+    QString subGroup;
+    QString compiledLibraryName;
+    QString brandingString;
+  };
+
+  /**
+   * @brief The PluginEntry struct describes one plugin file
+   */
+  struct PluginEntry
+  {
+    QString filePath;
+    qint64 size = -1;
+    qint64 lastModified = -1;
+    QByteArray sha1;
+    QString pluginName;
+    QVector<FilterEntry> filters;
+    bool filtersKnown = false;
+  };
+
+  /**
+   * @brief The DirectoryEntry struct caches the plugin file names found in a directory
+   */
+  struct DirectoryEntry
+  {
+    QString dirPath;
+    qint64 lastModified = -1;
+    QStringList fileNames;
+  };
+
+  /**
+   * @brief GetUserManifestFilePath Returns the location of the per-user manifest that is
+   * updated incrementally by each launch
+   * @return
+   */
+  static QString GetUserManifestFilePath();
+
+  /**
+   * @brief GetInstallManifestFileName Returns the file name of the manifest that is written
+   * into the plugin directory when a package is created
+   * @return
+   */
+  static QString GetInstallManifestFileName();
+
+  /**
+   * @brief ComputeHash Computes the SHA-1 hash of the contents of a file
+   * @param filePath
+   * @return The hex encoded hash or an empty array if the file could not be read
+   */
+  static QByteArray ComputeHash(const QString& filePath);
+
+  /**
+   * @brief readFile Reads a manifest from disk and merges its entries into this manifest.
+   * Entries that already exist are NOT replaced. A manifest written by another version of
+   * SIMPLView is ignored.
+   * @param filePath
+   * @return False if the file is missing, unreadable or from another version
+   */
+  bool readFile(const QString& filePath);
+
+  /**
+   * @brief writeFile Atomically writes this manifest to disk. Paths inside the directory
+   * holding the manifest are written relative to that directory so the manifest stays
+   * valid when an installation is moved.
+   * @param filePath
+   * @return
+   */
+  bool writeFile(const QString& filePath) const;
+
+  /**
+   * @brief findPluginFiles Returns the plugin files inside each of the directories. A
+   * directory is only listed again if its modification time differs from the cached one.
+   * @param pluginDirs
+   * @param nameFilter Returns true for file names that should be loaded
+   * @return
+   */
+  QStringList findPluginFiles(const QStringList& pluginDirs, bool (*nameFilter)(const QString&));
+
+  /**
+   * @brief isCurrent Returns true if the entry for the file still describes the file on disk.
+   * The size and modification time are compared first; if those changed the content hash is
+   * used so that a file that was only touched (copied, re-installed) is still current.
+   * @param filePath
+   * @return
+   */
+  bool isCurrent(const QString& filePath);
+
+  /**
+   * @brief contains
+   * @param filePath
+   * @return
+   */
+  bool contains(const QString& filePath) const;
+
+  /**
+   * @brief getEntry
+   * @param filePath
+   * @return
+   */
+  PluginEntry getEntry(const QString& filePath) const;
+
+  /**
+   * @brief updateEntry Records what was found by opening the plugin at filePath
+   * @param filePath
+   * @param pluginName
+   * @param filters
+   * @param filtersKnown False if the plugin was opened but its filters were not registered
+   */
+  void updateEntry(const QString& filePath, const QString& pluginName, const QVector<FilterEntry>& filters, bool filtersKnown);
+
+  /**
+   * @brief removeMissingEntries Drops every plugin entry whose path is not in filePaths
+   * @param filePaths
+   */
+  void removeMissingEntries(const QStringList& filePaths);
+
+  /**
+   * @brief getEntries
+   * @return
+   */
+  QVector<PluginEntry> getEntries() const;
+
+  /**
+   * @brief isDirty Returns true if the manifest changed since it was read
+   * @return
+   */
+  bool isDirty() const;
+
+private:
+  QMap<QString, PluginEntry> m_Plugins;
+  QMap<QString, DirectoryEntry> m_Directories;
+  bool m_Dirty = false;
+
+  static qint64 LastModified(const QFileInfo& fi);
+
+  PluginManifest(const PluginManifest&) = delete; // Copy Constructor Not Implemented
+  void operator=(const PluginManifest&) = delete; // Move assignment Not Implemented
+};
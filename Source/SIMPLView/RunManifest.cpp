@@ -0,0 +1,385 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "RunManifest.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+#include "SIMPLib/Plugin/ISIMPLibPlugin.h"
+#include "SIMPLib/Plugin/PluginManager.h"
+#include "SIMPLib/Utilities/SIMPLDataPathValidator.h"
+
+#include "SIMPLView/HeadlessPipelineRunner.h"
+#include "SIMPLView/PluginManifest.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+RunManifest::FileEntry statFile(const QString& filePath)
+{
+  QFileInfo fi(filePath);
+  RunManifest::FileEntry entry;
+  entry.path = fi.absoluteFilePath();
+  if(fi.exists())
+  {
+    entry.size = fi.size();
+    entry.lastModified = fi.lastModified().toMSecsSinceEpoch();
+  }
+  return entry;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonArray entriesToJson(const QVector<RunManifest::FileEntry>& entries)
+{
+  QJsonArray array;
+  for(const RunManifest::FileEntry& entry : entries)
+  {
+    QJsonObject object;
+    object["path"] = entry.path;
+    object["size"] = static_cast<double>(entry.size);
+    object["lastModified"] = static_cast<double>(entry.lastModified);
+    object["sha1"] = QString::fromLatin1(entry.sha1);
+    array.push_back(object);
+  }
+  return array;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<RunManifest::FileEntry> entriesFromJson(const QJsonArray& array)
+{
+  QVector<RunManifest::FileEntry> entries;
+  foreach(QJsonValue value, array)
+  {
+    QJsonObject object = value.toObject();
+    RunManifest::FileEntry entry;
+    entry.path = object["path"].toString();
+    entry.size = static_cast<qint64>(object["size"].toDouble(-1));
+    entry.lastModified = static_cast<qint64>(object["lastModified"].toDouble());
+    entry.sha1 = object["sha1"].toString().toLatin1();
+    entries.push_back(entry);
+  }
+  return entries;
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+RunManifest::RunManifest() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+RunManifest::~RunManifest() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString RunManifest::GetDefaultDirectory()
+{
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/RunManifests";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString RunManifest::GetFilePath(const QString& manifestDir, const QString& pipelineFile, const QJsonObject& overrides)
+{
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  hash.addData(QFileInfo(pipelineFile).absoluteFilePath().toUtf8());
+  hash.addData(QJsonDocument(overrides).toJson(QJsonDocument::Compact));
+  return QDir(manifestDir).filePath(QString::fromLatin1(hash.result().toHex()) + ".json");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString RunManifest::ResolvePath(const QString& path)
+{
+#if defined SIMPL_RELATIVE_PATH_CHECK
+  return QFileInfo(SIMPLDataPathValidator::Instance()->convertToAbsolutePath(path)).absoluteFilePath();
+#else
+  return QFileInfo(path).absoluteFilePath();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// File list parameters keep their paths one level down, so nested objects are searched
+// as well.
+// -----------------------------------------------------------------------------
+bool RunManifest::CollectPaths(const QJsonObject& parameters, QStringList& inputs, QStringList& outputs)
+{
+  static const QRegularExpression pathKey("File|Path|Dir|Folder", QRegularExpression::CaseInsensitiveOption);
+
+  bool classified = true;
+  for(QJsonObject::const_iterator param = parameters.constBegin(); param != parameters.constEnd(); ++param)
+  {
+    if(param.value().isObject())
+    {
+      classified = CollectPaths(param.value().toObject(), inputs, outputs) && classified;
+      continue;
+    }
+
+    // Array and container names are not paths, even when a file of that name happens to exist
+    QString value = param.value().toString();
+    if(value.isEmpty() || (!QFileInfo(value).isAbsolute() && !param.key().contains(pathKey)))
+    {
+      continue;
+    }
+
+    QFileInfo fi(ResolvePath(value));
+    if(param.key().contains("Output"))
+    {
+      outputs.push_back(fi.absoluteFilePath());
+    }
+    else if(param.key().contains("Input"))
+    {
+      if(fi.isDir())
+      {
+        foreach(QFileInfo child, QDir(fi.absoluteFilePath()).entryInfoList(QDir::Files, QDir::Name))
+        {
+          inputs.push_back(child.absoluteFilePath());
+        }
+      }
+      else
+      {
+        // A missing input is recorded as well, so that its appearance counts as a change
+        inputs.push_back(fi.absoluteFilePath());
+      }
+    }
+    else if(fi.exists())
+    {
+      // A file that the parameter name does not say is read or written, like a writer
+      // whose key lacks "Output". Settings such as an extension or a prefix do not exist.
+      classified = false;
+    }
+  }
+  return classified;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+RunManifest RunManifest::Capture(const QString& pipelineFile, const QJsonObject& overrides, bool hashInputs)
+{
+  RunManifest manifest;
+
+  QFileInfo fi(pipelineFile);
+  if(fi.suffix().compare("json", Qt::CaseInsensitive) == 0)
+  {
+    QFile file(pipelineFile);
+    if(file.open(QIODevice::ReadOnly))
+    {
+      QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+      HeadlessPipelineRunner::ApplyOverrides(root, overrides);
+      manifest.m_PipelineHash = QCryptographicHash::hash(QJsonDocument(root).toJson(QJsonDocument::Compact), QCryptographicHash::Sha1).toHex();
+      // A path that cannot be told apart as an input or an output makes every run necessary
+      manifest.m_Complete = true;
+      QStringList inputs;
+      QStringList outputs;
+      for(QJsonObject::const_iterator filter = root.constBegin(); filter != root.constEnd(); ++filter)
+      {
+        manifest.m_Complete = CollectPaths(filter.value().toObject(), inputs, outputs) && manifest.m_Complete;
+      }
+      inputs.removeDuplicates();
+      outputs.removeDuplicates();
+
+      foreach(QString input, inputs)
+      {
+        FileEntry entry = statFile(input);
+        if(hashInputs)
+        {
+          entry.sha1 = PluginManifest::ComputeHash(input);
+        }
+        manifest.m_Inputs.push_back(entry);
+      }
+      foreach(QString output, outputs)
+      {
+        FileEntry entry = statFile(output);
+        if(entry.size >= 0)
+        {
+          manifest.m_Outputs.push_back(entry);
+        }
+      }
+    }
+  }
+  else
+  {
+    // The parameters of a .dream3d pipeline are not read here, so its inputs are unknown
+    manifest.m_PipelineHash = PluginManifest::ComputeHash(pipelineFile);
+  }
+
+  QVector<ISIMPLibPlugin*> plugins = PluginManager::Instance()->getPluginsVector();
+  for(ISIMPLibPlugin* plugin : plugins)
+  {
+    manifest.m_PluginVersions.insert(plugin->getPluginFileName(), plugin->getVersion());
+  }
+  return manifest;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool RunManifest::readFile(const QString& filePath)
+{
+  QFile file(filePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return false;
+  }
+
+  QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+  if(root.isEmpty())
+  {
+    return false;
+  }
+
+  m_Complete = root["complete"].toBool();
+  m_PipelineHash = root["pipelineHash"].toString().toLatin1();
+  m_Inputs = entriesFromJson(root["inputs"].toArray());
+  m_Outputs = entriesFromJson(root["outputs"].toArray());
+  m_PluginVersions.clear();
+  QJsonObject plugins = root["plugins"].toObject();
+  for(QJsonObject::const_iterator iter = plugins.constBegin(); iter != plugins.constEnd(); ++iter)
+  {
+    m_PluginVersions.insert(iter.key(), iter.value().toString());
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool RunManifest::writeFile(const QString& filePath) const
+{
+  QJsonObject root;
+  root["complete"] = m_Complete;
+  root["pipelineHash"] = QString::fromLatin1(m_PipelineHash);
+  root["inputs"] = entriesToJson(m_Inputs);
+  root["outputs"] = entriesToJson(m_Outputs);
+  QJsonObject plugins;
+  for(QMap<QString, QString>::const_iterator iter = m_PluginVersions.constBegin(); iter != m_PluginVersions.constEnd(); ++iter)
+  {
+    plugins[iter.key()] = iter.value();
+  }
+  root["plugins"] = plugins;
+  root["recorded"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+
+  QDir().mkpath(QFileInfo(filePath).absolutePath());
+  QSaveFile file(filePath);
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+  file.write(QJsonDocument(root).toJson());
+  return file.commit();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString RunManifest::findChange(const RunManifest& current) const
+{
+  if(!current.m_Complete || !m_Complete)
+  {
+    return "The inputs of the pipeline are not known";
+  }
+  if(m_PipelineHash != current.m_PipelineHash)
+  {
+    return "The pipeline changed";
+  }
+
+  for(QMap<QString, QString>::const_iterator iter = current.m_PluginVersions.constBegin(); iter != current.m_PluginVersions.constEnd(); ++iter)
+  {
+    if(m_PluginVersions.value(iter.key()) != iter.value())
+    {
+      return QString("The plugin %1 is now version %2").arg(iter.key()).arg(iter.value());
+    }
+  }
+  if(m_PluginVersions.size() != current.m_PluginVersions.size())
+  {
+    return "A plugin is no longer loaded";
+  }
+
+  QMap<QString, FileEntry> recordedInputs;
+  for(const FileEntry& entry : m_Inputs)
+  {
+    recordedInputs.insert(entry.path, entry);
+  }
+  for(const FileEntry& entry : current.m_Inputs)
+  {
+    if(!recordedInputs.contains(entry.path))
+    {
+      return QString("The input %1 is new").arg(QDir::toNativeSeparators(entry.path));
+    }
+    FileEntry recorded = recordedInputs.take(entry.path);
+    if(entry.size != recorded.size)
+    {
+      return QString("The input %1 changed").arg(QDir::toNativeSeparators(entry.path));
+    }
+    if(entry.lastModified != recorded.lastModified && PluginManifest::ComputeHash(entry.path) != recorded.sha1)
+    {
+      return QString("The input %1 changed").arg(QDir::toNativeSeparators(entry.path));
+    }
+  }
+  if(!recordedInputs.isEmpty())
+  {
+    return QString("The input %1 is missing").arg(QDir::toNativeSeparators(recordedInputs.firstKey()));
+  }
+
+  for(const FileEntry& entry : m_Outputs)
+  {
+    if(!QFileInfo::exists(entry.path))
+    {
+      return QString("The output %1 is missing").arg(QDir::toNativeSeparators(entry.path));
+    }
+  }
+  return QString();
+}
@@ -0,0 +1,147 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMap>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+/**
+ * @brief The RunManifest class records what a successful headless run of a pipeline depended
+ * on: the pipeline itself, its input files, the versions of the loaded plugins and the files
+ * it wrote. A later run of the same pipeline can be skipped when none of these changed and
+ * the outputs still exist, like make does with its targets.
+ *
+ * Inputs and outputs are found through the parameters of a .json pipeline, see
+ * CollectPaths(). Relative paths are resolved like the filters resolve them. A pipeline with
+ * a path that is neither an input nor an output is never skipped. An input whose time stamp
+ * changed but whose size did not is compared by its SHA-1, so copying a data set again does
+ * not trigger a run.
+ */
+class RunManifest
+{
+public:
+  /**
+   * @brief The FileEntry struct describes one input or output file
+   */
+  struct FileEntry
+  {
+    QString path;
+    qint64 size = -1;
+    qint64 lastModified = 0;
+    QByteArray sha1;
+  };
+
+  RunManifest();
+  virtual ~RunManifest();
+
+  /**
+   * @brief GetDefaultDirectory Returns where the manifests are kept unless told otherwise
+   * @return
+   */
+  static QString GetDefaultDirectory();
+
+  /**
+   * @brief GetFilePath Returns the manifest file of a pipeline run with the given overrides
+   * @param manifestDir
+   * @param pipelineFile
+   * @param overrides
+   * @return
+   */
+  static QString GetFilePath(const QString& manifestDir, const QString& pipelineFile, const QJsonObject& overrides);
+
+  /**
+   * @brief Capture Describes the current state of a pipeline's dependencies
+   * @param pipelineFile
+   * @param overrides See HeadlessPipelineRunner::ApplyOverrides()
+   * @param hashInputs Whether to compute the SHA-1 of every input, which is only needed for
+   * a manifest that is written
+   * @return
+   */
+  static RunManifest Capture(const QString& pipelineFile, const QJsonObject& overrides, bool hashInputs);
+
+  /**
+   * @brief CollectPaths Sorts the paths in a filter's parameters into inputs and outputs. A
+   * parameter holds a path if its value is absolute or its name mentions a file, path,
+   * directory or folder. Names that contain "Output" are outputs and names that contain
+   * "Input" are inputs; directories add the files they contain as inputs.
+   * @param parameters
+   * @param inputs Receives absolute paths
+   * @param outputs Receives absolute paths
+   * @return False if a parameter names an existing file that is neither an input nor an
+   * output, in which case nothing may be concluded from the paths
+   */
+  static bool CollectPaths(const QJsonObject& parameters, QStringList& inputs, QStringList& outputs);
+
+  /**
+   * @brief ResolvePath Makes a path from a filter parameter absolute the way the filters do,
+   * against the data directory where relative paths are supported
+   * @param path
+   * @return
+   */
+  static QString ResolvePath(const QString& path);
+
+  /**
+   * @brief readFile
+   * @param filePath
+   * @return False if there is no readable manifest
+   */
+  bool readFile(const QString& filePath);
+
+  /**
+   * @brief writeFile
+   * @param filePath
+   * @return
+   */
+  bool writeFile(const QString& filePath) const;
+
+  /**
+   * @brief findChange Compares this recorded manifest with the current state
+   * @param current As returned by Capture()
+   * @return Why the pipeline has to run, or an empty string if it is up to date
+   */
+  QString findChange(const RunManifest& current) const;
+
+private:
+  bool m_Complete = false;
+  QByteArray m_PipelineHash;
+  QVector<FileEntry> m_Inputs;
+  QVector<FileEntry> m_Outputs;
+  QMap<QString, QString> m_PluginVersions;
+};
@@ -34,16 +34,13 @@
 * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "SIMPLViewApplication.h"
 
-#if !defined(_MSC_VER)
-#include <unistd.h>
-#endif
-
-#include <ctime>
 #include <iostream>
+#include <memory>
 
-#include <QtCore/QPluginLoader>
+#include <QtCore/QDebug>
 #include <QtCore/QProcess>
 #include <QtCore/QThread>
+#include <QtCore/QTimer>
 
 #include <QtGui/QBitmap>
 #include <QtGui/QBitmap>
@@ -77,11 +74,16 @@
 #include "SVWidgetsLib/Dialogs/UpdateCheckDialog.h"
 #include "SVWidgetsLib/Widgets/BookmarksToolboxWidget.h"
 #include "SVWidgetsLib/Widgets/PipelineModel.h"
-#include "SVWidgetsLib/Widgets/SVStyle.h"
 
 #include "SIMPLView/AboutSIMPLView.h"
+#include "SIMPLView/DeferredTaskScheduler.h"
 #include "SIMPLView/SIMPLView_UI.h"
+#include "SIMPLView/SIMPLViewPluginLoader.h"
+#include "SIMPLView/SIMPLViewSettings.h"
+#include "SIMPLView/SingleInstanceServer.h"
 #include "SIMPLView/SIMPLViewVersion.h"
+#include "SIMPLView/StartupTrace.h"
+#include "SIMPLView/ThemeCache.h"
 #include "SIMPLView/SIMPLViewConstants.h"
 
 #include "BrandedStrings.h"
@@ -117,18 +119,14 @@ SIMPLViewApplication::SIMPLViewApplication(int& argc, char** argv)
 , m_SplashScreen(nullptr)
 , m_minSplashTime(3)
 {
-  // Automatically check for updates at startup if the user has indicated that preference before
-  checkForUpdatesAtStartup();
-
-  // Initialize the Default Stylesheet
-  SVStyle* style = SVStyle::Instance();
-  QString defaultLoadedThemePath = BrandedStrings::DefaultStyleDirectory + "/" + BrandedStrings::DefaultLoadedTheme + ".json";
-  style->loadStyleSheet(defaultLoadedThemePath);
-
+  // This also loads the saved theme, or the default one
   readSettings();
 
   // Create the default menu bar
-  createDefaultMenuBar();
+  {
+    STARTUP_TRACE_SCOPE("createDefaultMenuBar");
+    createDefaultMenuBar();
+  }
 
   // If on Mac, add custom actions to a dock menu
 #if defined(Q_OS_MAC)
@@ -139,8 +137,11 @@ SIMPLViewApplication::SIMPLViewApplication(int& argc, char** argv)
   QtSRecentFileList* recentsList = QtSRecentFileList::Instance();
   QObject::connect(recentsList, &QtSRecentFileList::fileListChanged, this, &SIMPLViewApplication::updateRecentFileList);
 
-  QSharedPointer<QtSSettings> prefs = QSharedPointer<QtSSettings>(new QtSSettings());
-  QtSRecentFileList::Instance()->readList(prefs.data());
+  // Work that the first window does not need waits until it has been painted
+  m_DeferredTasks = new DeferredTaskScheduler(this);
+  connect(m_DeferredTasks, &DeferredTaskScheduler::finished, [] { StartupTrace::Instance()->write(); });
+  connect(this, &QApplication::aboutToQuit, this, &SIMPLViewApplication::clearWindowPool);
+  addDeferredStartupTasks();
 }
 
 // -----------------------------------------------------------------------------
@@ -151,19 +152,16 @@ SIMPLViewApplication::~SIMPLViewApplication()
   delete this->m_SplashScreen;
   this->m_SplashScreen = nullptr;
 
-  for(int i = 0; i < m_PluginLoaders.size(); i++)
-  {
-    delete m_PluginLoaders[i];
-  }
-
   writeSettings();
 
-  QtSSettings prefs;
-  if(prefs.value("Program Mode", QString("")) == "Clear Cache")
+  // Clearing the cache drops the settings that were just written as well
+  SIMPLViewSettings* settings = SIMPLViewSettings::Instance();
+  if(settings->value("Program Mode", QString("")).toString() == "Clear Cache")
   {
-    prefs.clear();
-    prefs.setValue("Program Mode", QString("Standard"));
+    settings->clear();
+    settings->setValue("Program Mode", QString("Standard"));
   }
+  settings->flush();
 }
 
 // -----------------------------------------------------------------------------
@@ -183,6 +181,7 @@ void delay(int seconds)
 // -----------------------------------------------------------------------------
 bool SIMPLViewApplication::initialize(int argc, char* argv[])
 {
+  STARTUP_TRACE_SCOPE("SIMPLViewApplication::initialize");
 
   Q_UNUSED(argc)
   Q_UNUSED(argv)
@@ -205,8 +204,17 @@ bool SIMPLViewApplication::initialize(int argc, char* argv[])
   this->m_SplashScreen = new QSplashScreen(pixmap);
   this->m_SplashScreen->show();
 
-  // start timer;
-  std::clock_t startClock = std::clock();
+  // if official release, enforce the minimum duration for splash screen. The time runs
+  // while the plugins load and the first window is built instead of being slept away.
+  QString releaseType = QString::fromLatin1(SIMPLViewProj_RELEASE_TYPE);
+  if(m_ShowSplash && releaseType.compare("Official") == 0)
+  {
+    m_SplashTimeElapsed = false;
+    QTimer::singleShot(m_minSplashTime * 1000, this, [this] {
+      m_SplashTimeElapsed = true;
+      finishStartup();
+    });
+  }
 
   QDir dir(QApplication::applicationDirPath());
 
@@ -226,33 +234,24 @@ bool SIMPLViewApplication::initialize(int argc, char* argv[])
 #endif
   QApplication::addLibraryPath(dir.absolutePath());
 
-  QMetaObjectUtilities::RegisterMetaTypes();
-
-  // Load application plugins.
-  QVector<ISIMPLibPlugin*> plugins = loadPlugins();
-
-  // give GUI components time to update before the mainwindow is shown
-  QApplication::instance()->processEvents();
-  if(m_ShowSplash)
   {
-    //   delay(1);
-    // if official release, enforce the minimum duration for splash screen
-    QString releaseType = QString::fromLatin1(SIMPLViewProj_RELEASE_TYPE);
-    if(releaseType.compare("Official") == 0)
-    {
-      double splashDuration = (std::clock() - startClock) / (double)CLOCKS_PER_SEC;
-      if(splashDuration < m_minSplashTime)
-      {
-        QString msg = QObject::tr("");
-        this->m_SplashScreen->showMessage(msg, Qt::AlignVCenter | Qt::AlignRight, Qt::white);
+    STARTUP_TRACE_SCOPE("QMetaObjectUtilities::RegisterMetaTypes");
+    QMetaObjectUtilities::RegisterMetaTypes();
+  }
 
-        unsigned long extendedDuration = static_cast<unsigned long>((m_minSplashTime - splashDuration) * 1000);
-        QThread::msleep(extendedDuration);
-      }
-    }
-    this->m_SplashScreen->finish(nullptr);
+  // Start loading the application plugins. They are registered from the event loop
+  // while main() builds the first window.
+  {
+    STARTUP_TRACE_SCOPE("Start Loading Plugins");
+    loadPlugins();
   }
-  QApplication::instance()->processEvents();
+
+#if !defined(Q_OS_MAC)
+  // Later launches hand their files to this instance. macOS does this with QEvent::FileOpen.
+  m_InstanceServer = new SingleInstanceServer(this);
+  connect(m_InstanceServer, &SingleInstanceServer::filesReceived, this, &SIMPLViewApplication::openForwardedFiles);
+  m_InstanceServer->listen();
+#endif
 
   return true;
 }
@@ -260,193 +259,127 @@ bool SIMPLViewApplication::initialize(int argc, char* argv[])
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-QVector<ISIMPLibPlugin*> SIMPLViewApplication::loadPlugins()
+void SIMPLViewApplication::startFirstInstance(const QString& filePath)
 {
-  QStringList pluginDirs;
-  pluginDirs << applicationDirPath();
-
-  QDir aPluginDir = QDir(applicationDirPath());
-  qDebug() << "Loading " << BrandedStrings::ApplicationName << " Plugins....";
-  QString thePath;
-
-#if defined(Q_OS_WIN)
-  if(aPluginDir.cd("Plugins"))
   {
-    thePath = aPluginDir.absolutePath();
-    pluginDirs << thePath;
+    STARTUP_TRACE_SCOPE("Build First Window");
+    m_FirstInstance = getNewSIMPLViewInstance();
   }
-#elif defined(Q_OS_MAC)
-  // Look to see if we are inside an .app package or inside the 'tools' directory
-  if(aPluginDir.dirName() == "MacOS")
+
+  if(!filePath.isEmpty())
   {
-    aPluginDir.cdUp();
-    thePath = aPluginDir.absolutePath() + "/Plugins";
-    qDebug() << "  Adding Path " << thePath;
-    pluginDirs << thePath;
-    aPluginDir.cdUp();
-    aPluginDir.cdUp();
-    // We need this because Apple (in their infinite wisdom) changed how the current working directory is set in OS X 10.9 and above. Thanks Apple.
-    chdir(aPluginDir.absolutePath().toLatin1().constData());
+    m_PendingFilePaths.push_back(filePath);
   }
-  if(aPluginDir.dirName() == "bin")
+
+  finishStartup();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::finishStartup()
+{
+  if(m_StartupFinished || !m_SplashTimeElapsed || m_FirstInstance.isNull())
   {
-    aPluginDir.cdUp();
-    // We need this because Apple (in their infinite wisdom) changed how the current working directory is set in OS X 10.9 and above. Thanks Apple.
-    chdir(aPluginDir.absolutePath().toLatin1().constData());
+    return;
   }
-  // aPluginDir.cd("Plugins");
-  thePath = aPluginDir.absolutePath() + "/Plugins";
-  qDebug() << "  Adding Path " << thePath;
-  pluginDirs << thePath;
-
-// This is here for Xcode compatibility
-#ifdef CMAKE_INTDIR
-  aPluginDir.cdUp();
-  thePath = aPluginDir.absolutePath() + "/Plugins/" + CMAKE_INTDIR;
-  pluginDirs << thePath;
-#endif
-#else
-  // We are on Linux - I think
-  // Try the current location of where the application was launched from which is
-  // typically the case when debugging from a build tree
-  if(aPluginDir.cd("Plugins"))
+  m_StartupFinished = true;
+
+  STARTUP_TRACE_SCOPE("First Show");
+
+  // The plugins keep loading behind the window. Its filter toolboxes are filled in
+  // finishPluginLoading().
+  m_FirstInstance->show();
+  if(m_ShowSplash)
   {
-    thePath = aPluginDir.absolutePath();
-    pluginDirs << thePath;
-    aPluginDir.cdUp(); // Move back up a directory level
+    m_SplashScreen->finish(m_FirstInstance);
   }
-
-  if(thePath.isEmpty())
+  if(!m_PluginsLoaded)
   {
-    // Now try moving up a directory which is what should happen when running from a
-    // proper distribution of SIMPLView
-    aPluginDir.cdUp();
-    if(aPluginDir.cd("Plugins"))
-    {
-      thePath = aPluginDir.absolutePath();
-      pluginDirs << thePath;
-      aPluginDir.cdUp(); // Move back up a directory level
-      int no_error = chdir(aPluginDir.absolutePath().toLatin1().constData());
-      if(no_error < 0)
-      {
-        qDebug() << "Could not set the working directory.";
-      }
-    }
+    m_FirstInstance->setStatusBarMessage(tr("Loading plugins..."));
   }
-#endif
 
-  QByteArray pluginEnvPath = qgetenv("SIMPL_PLUGIN_PATH");
-  qDebug() << "SIMPL_PLUGIN_PATH:" << pluginEnvPath;
+  openPendingFiles();
+}
 
-  char sep = ';';
-#if defined(Q_OS_WIN)
-  sep = ':';
-#endif
-  QList<QByteArray> envPaths = pluginEnvPath.split(sep);
-  foreach(QByteArray envPath, envPaths)
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::finishPluginLoading()
+{
+  m_PluginsLoaded = true;
+
+  // The windows were built before all of the filters were registered
+  QVector<ISIMPLibPlugin*> plugins = PluginManager::Instance()->getPluginsVector();
+  foreach(SIMPLView_UI* instance, m_SIMPLViewInstances)
   {
-    if(envPath.size() > 0)
-    {
-      pluginDirs << QString::fromLatin1(envPath);
-    }
+    instance->setLoadedPlugins(plugins);
+    instance->refreshFilterToolboxes();
   }
-
-  int dupes = pluginDirs.removeDuplicates();
-  qDebug() << "Removed " << dupes << " duplicate Plugin Paths";
-  QStringList pluginFilePaths;
-
-  foreach(QString pluginDirString, pluginDirs)
+  if(m_StartupFinished && !m_FirstInstance.isNull())
   {
-    qDebug() << "Plugin Directory being Searched: " << pluginDirString;
-    aPluginDir = QDir(pluginDirString);
-    foreach(QString fileName, aPluginDir.entryList(QDir::Files))
-    {
-//   qDebug() << "File: " << fileName() << "\n";
-#ifdef QT_DEBUG
-      if(fileName.endsWith("_debug.guiplugin", Qt::CaseSensitive))
-#else
-      if(fileName.endsWith(".guiplugin", Qt::CaseSensitive)            // We want ONLY Release plugins
-         && !fileName.endsWith("_debug.guiplugin", Qt::CaseSensitive)) // so ignore these plugins
-#endif
-      {
-        pluginFilePaths << aPluginDir.absoluteFilePath(fileName);
-        // qWarning(aPluginDir.absoluteFilePath(fileName).toLatin1(), "%s");
-        // qDebug() << "Adding " << aPluginDir.absoluteFilePath(fileName)() << "\n";
-      }
-    }
+    m_FirstInstance->setStatusBarMessage(tr("Plugins loaded"));
   }
 
-  FilterManager* filterManager = FilterManager::Instance();
-  FilterWidgetManager* fwm = FilterWidgetManager::Instance();
-
-  // THIS IS A VERY IMPORTANT LINE: It will register all the known filters in the dream3d library. This
-  // will NOT however get filters from plugins. We are going to have to figure out how to compile filters
-  // into their own plugin and load the plugins from a command line.
-  filterManager->RegisterKnownFilters(filterManager);
+  openPendingFiles();
+}
 
-  PluginManager* pluginManager = PluginManager::Instance();
-  QList<PluginProxy::Pointer> proxies = AboutPlugins::readPluginCache();
-  QMap<QString, bool> loadingMap;
-  for(QList<PluginProxy::Pointer>::iterator nameIter = proxies.begin(); nameIter != proxies.end(); nameIter++)
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::openPendingFiles()
+{
+  // A pipeline can only be read once every filter is registered
+  if(!m_StartupFinished || !m_PluginsLoaded)
   {
-    PluginProxy::Pointer proxy = *nameIter;
-    loadingMap.insert(proxy->getPluginName(), proxy->getEnabled());
+    return;
   }
 
-  // Now that we have a sorted list of plugins, go ahead and load them all from the
-  // file system and add each to the toolbar and menu
-  foreach(QString path, pluginFilePaths)
+  // Open pipeline if SIMPLView was opened from a compatible file. The first one goes
+  // into the window that is already on screen, unless it was closed meanwhile.
+  QStringList filePaths = m_PendingFilePaths;
+  m_PendingFilePaths.clear();
+  for(int i = 0; i < filePaths.size(); i++)
   {
-    qDebug() << "Plugin Being Loaded:" << path;
-    QApplication::instance()->processEvents();
-    QPluginLoader* loader = new QPluginLoader(path);
-    QFileInfo fi(path);
-    QString fileName = fi.fileName();
-    QObject* plugin = loader->instance();
-    qDebug() << "    Pointer: " << plugin << "\n";
-    if(plugin)
+    if(i == 0 && !m_FirstInstance.isNull())
     {
-      ISIMPLibPlugin* ipPlugin = qobject_cast<ISIMPLibPlugin*>(plugin);
-      if(ipPlugin)
+      QFileInfo fi(filePaths[i]);
+      if(fi.exists())
       {
-        QString pluginName = ipPlugin->getPluginFileName();
-        if(loadingMap.value(pluginName, true) == true)
-        {
-          QString msg = QObject::tr("Loading Plugin %1  ").arg(fileName);
-          this->m_SplashScreen->showMessage(msg, Qt::AlignVCenter | Qt::AlignRight, Qt::white);
-          // ISIMPLibPlugin::Pointer ipPluginPtr(ipPlugin);
-          ipPlugin->registerFilterWidgets(fwm);
-          ipPlugin->registerFilters(filterManager);
-          ipPlugin->setDidLoad(true);
-        }
-        else
-        {
-          ipPlugin->setDidLoad(false);
-        }
-
-        ipPlugin->setLocation(path);
-        pluginManager->addPlugin(ipPlugin);
+        m_FirstInstance->openPipeline(QDir::toNativeSeparators(filePaths[i]));
       }
-      m_PluginLoaders.push_back(loader);
     }
     else
     {
-      m_SplashScreen->hide();
-      QString message("The plugin did not load with the following error\n\n");
-      message.append(loader->errorString());
-      message.append("\n\n");
-      message.append("Possible causes include missing libraries that plugin depends on.");
-      QMessageBox box(QMessageBox::Critical, tr("Plugin Load Error"), tr(message.toStdString().c_str()));
-      box.setStandardButtons(QMessageBox::Ok | QMessageBox::Default);
-      box.setDefaultButton(QMessageBox::Ok);
-      box.setWindowFlags(box.windowFlags() | Qt::WindowStaysOnTopHint);
-      box.exec();
-      m_SplashScreen->show();
-      delete loader;
+      newInstanceFromFile(filePaths[i]);
     }
   }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::loadPlugins()
+{
+  m_PluginLoader = new SIMPLViewPluginLoader(this);
+  m_PluginLoader->setLazyActivation(m_LazyPluginActivation);
 
-  return pluginManager->getPluginsVector();
+  connect(m_PluginLoader, &SIMPLViewPluginLoader::pluginLoading, this, [this](const QString& fileName) {
+    if(m_StartupFinished)
+    {
+      return;
+    }
+    QString msg = QObject::tr("Loading Plugin %1  ").arg(fileName);
+    this->m_SplashScreen->showMessage(msg, Qt::AlignVCenter | Qt::AlignRight, Qt::white);
+  });
+
+  // Failures are collected by the loader and reported together once the first window
+  // is on screen, so a broken plugin never blocks the startup
+  connect(m_PluginLoader, &SIMPLViewPluginLoader::pluginFailedToLoad, this, [this] { queuePluginLoadReport(); });
+
+  connect(m_PluginLoader, &SIMPLViewPluginLoader::pluginsLoaded, this, &SIMPLViewApplication::finishPluginLoading);
+
+  m_PluginLoader->loadPluginsAsync();
 }
 
 // -----------------------------------------------------------------------------
@@ -513,8 +446,7 @@ void SIMPLViewApplication::listenClearRecentFilesTriggered()
   recents->clear();
 
   // Write out the empty list
-  QSharedPointer<QtSSettings> prefs = QSharedPointer<QtSSettings>(new QtSSettings());
-  recents->writeList(prefs.data());
+  SIMPLViewSettings::Instance()->writeWith([recents](QtSSettings* prefs) { recents->writeList(prefs); });
 }
 
 // -----------------------------------------------------------------------------
@@ -538,10 +470,10 @@ void SIMPLViewApplication::listenClearSIMPLViewCacheTriggered()
 
   if(response == QMessageBox::Yes)
   {
-    QSharedPointer<QtSSettings> prefs = QSharedPointer<QtSSettings>(new QtSSettings());
-
     // Set a flag in the preferences file, so that we know that we are in "Clear Cache" mode
+    SIMPLViewSettings* prefs = SIMPLViewSettings::Instance();
     prefs->setValue("Program Mode", QString("Clear Cache"));
+    prefs->flush();
 
     QMessageBox cacheClearedBox;
     QString title = QString("The cache has been cleared successfully. Please restart %1 for the changes to take effect.").arg(BrandedStrings::ApplicationName);
@@ -641,12 +573,12 @@ void SIMPLViewApplication::listenCheckForUpdatesTriggered()
   d.setUpdateWebSite(SIMPLView::UpdateWebsite::UpdateWebSite);
   d.setApplicationName(BrandedStrings::ApplicationName);
 
-  // Read from the QtSSettings Pref file the information that we need
-  QtSSettings prefs;
-  prefs.beginGroup(SIMPLView::UpdateWebsite::VersionCheckGroupName);
-  QDateTime dateTime = prefs.value(SIMPLView::UpdateWebsite::LastVersionCheck, QDateTime::currentDateTime()).toDateTime();
+  // Read from the preferences the information that we need
+  SIMPLViewSettings* prefs = SIMPLViewSettings::Instance();
+  prefs->beginGroup(SIMPLView::UpdateWebsite::VersionCheckGroupName);
+  QDateTime dateTime = prefs->value(SIMPLView::UpdateWebsite::LastVersionCheck, QDateTime::currentDateTime()).toDateTime();
   d.setLastCheckDateTime(dateTime);
-  prefs.endGroup();
+  prefs->endGroup();
 
   // Now display the dialog box
   d.exec();
@@ -691,11 +623,11 @@ void SIMPLViewApplication::checkForUpdatesAtStartup()
   UpdateCheckDialog d(data);
   if(d.getAutomaticallyBtn()->isChecked())
   {
-    QtSSettings updatePrefs;
+    SIMPLViewSettings* updatePrefs = SIMPLViewSettings::Instance();
 
-    updatePrefs.beginGroup(UpdateCheckDialog::GetUpdatePreferencesGroup());
-    QDate lastUpdateCheckDate = updatePrefs.value(UpdateCheckDialog::GetUpdateCheckKey(), QString("")).toDate();
-    updatePrefs.endGroup();
+    updatePrefs->beginGroup(UpdateCheckDialog::GetUpdatePreferencesGroup());
+    QDate lastUpdateCheckDate = updatePrefs->value(UpdateCheckDialog::GetUpdateCheckKey(), QString("")).toDate();
+    updatePrefs->endGroup();
 
     QDate systemDate;
     QDate currentDateToday = systemDate.currentDate();
@@ -746,6 +678,13 @@ void SIMPLViewApplication::versionCheckReply(UpdateCheckData* dataObj)
 // -----------------------------------------------------------------------------
 void SIMPLViewApplication::listenDisplayPluginInfoDialogTriggered()
 {
+  // Disabled plugins that the manifest let us skip at startup still have to be
+  // listed in the dialog so that they can be enabled again
+  if(m_PluginLoader != nullptr)
+  {
+    m_PluginLoader->loadSkippedPlugins();
+  }
+
   AboutPlugins dialog(nullptr);
   dialog.exec();
 
@@ -802,6 +741,37 @@ SIMPLView_UI* SIMPLViewApplication::newInstanceFromFile(const QString& filePath)
 //
 // -----------------------------------------------------------------------------
 SIMPLView_UI* SIMPLViewApplication::getNewSIMPLViewInstance()
+{
+  SIMPLView_UI* newInstance = nullptr;
+  if(!m_WindowPool.isEmpty())
+  {
+    // Hand out a window that was built ahead of time and build its replacement later
+    newInstance = m_WindowPool.takeFirst();
+    newInstance->setLoadedPlugins(PluginManager::Instance()->getPluginsVector());
+    newInstance->setPooled(false);
+  }
+  else
+  {
+    newInstance = createSIMPLViewInstance();
+  }
+  refillWindowPool();
+
+  if (m_ActiveWindow)
+  {
+    newInstance->move(m_ActiveWindow->x() + 45, m_ActiveWindow->y() + 45);
+  }
+
+  m_ActiveWindow = newInstance;
+
+  connect(newInstance, SIGNAL(dream3dWindowChangedState(SIMPLView_UI*)), this, SLOT(dream3dWindowChanged(SIMPLView_UI*)));
+
+  return newInstance;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SIMPLView_UI* SIMPLViewApplication::createSIMPLViewInstance()
 {
   PluginManager* pluginManager = PluginManager::Instance();
   QVector<ISIMPLibPlugin*> plugins = pluginManager->getPluginsVector();
@@ -812,16 +782,41 @@ SIMPLView_UI* SIMPLViewApplication::getNewSIMPLViewInstance()
   newInstance->setAttribute(Qt::WA_DeleteOnClose);
   newInstance->setWindowTitle("[*]Untitled Pipeline - " + BrandedStrings::ApplicationName);
 
-  if (m_ActiveWindow)
+  return newInstance;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::refillWindowPool()
+{
+  // The pool is filled once the first window is on screen, one window per idle pass
+  if(m_WindowPoolRefillQueued || !m_DeferredTasks->isStarted() || m_WindowPool.size() >= m_WindowPoolSize)
   {
-    newInstance->move(m_ActiveWindow->x() + 45, m_ActiveWindow->y() + 45);
+    return;
   }
 
-  m_ActiveWindow = newInstance;
-
-  connect(newInstance, SIGNAL(dream3dWindowChangedState(SIMPLView_UI*)), this, SLOT(dream3dWindowChanged(SIMPLView_UI*)));
+  m_WindowPoolRefillQueued = true;
+  m_DeferredTasks->addTask("Build Pooled Window", DeferredTaskScheduler::Priority::Low, [this] {
+    m_WindowPoolRefillQueued = false;
+    if(m_WindowPool.size() < m_WindowPoolSize)
+    {
+      SIMPLView_UI* instance = createSIMPLViewInstance();
+      instance->setPooled(true);
+      m_WindowPool.push_back(instance);
+    }
+    refillWindowPool();
+  });
+}
 
-  return newInstance;
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::clearWindowPool()
+{
+  QList<SIMPLView_UI*> pool = m_WindowPool;
+  m_WindowPool.clear();
+  qDeleteAll(pool);
 }
 
 // -----------------------------------------------------------------------------
@@ -850,7 +845,7 @@ void SIMPLViewApplication::listenExitApplicationTriggered()
   for(int i = 0; i < m_SIMPLViewInstances.size(); i++)
   {
     SIMPLView_UI* dream3dWindow = m_SIMPLViewInstances[i];
-    if(nullptr != dream3dWindow)
+    if(nullptr != dream3dWindow && !dream3dWindow->isPooled())
     {
       if(dream3dWindow->close() == false)
       {
@@ -898,6 +893,136 @@ QList<SIMPLView_UI*> SIMPLViewApplication::getSIMPLViewInstances()
 void SIMPLViewApplication::registerSIMPLViewWindow(SIMPLView_UI* window)
 {
   m_SIMPLViewInstances.push_back(window);
+
+  if(!m_FirstWindowPainted)
+  {
+    window->installEventFilter(this);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLViewApplication::eventFilter(QObject* watched, QEvent* event)
+{
+  if(event->type() == QEvent::Paint && !m_FirstWindowPainted)
+  {
+    m_FirstWindowPainted = true;
+    foreach(SIMPLView_UI* instance, m_SIMPLViewInstances)
+    {
+      instance->removeEventFilter(this);
+    }
+
+    // Let the paint finish before starting any work
+    QTimer::singleShot(0, this, &SIMPLViewApplication::firstWindowPainted);
+  }
+
+  return QApplication::eventFilter(watched, event);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::firstWindowPainted()
+{
+  StartupTrace* trace = StartupTrace::Instance();
+  trace->addInstant("First Paint");
+  trace->write();
+
+  m_DeferredTasks->start();
+  queuePluginLoadReport();
+  refillWindowPool();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::queuePluginLoadReport()
+{
+  if(m_PluginLoadReportQueued || !m_DeferredTasks->isStarted() || m_PluginLoader == nullptr || m_PluginLoader->getLoadReport().isEmpty())
+  {
+    return;
+  }
+
+  m_PluginLoadReportQueued = true;
+  m_DeferredTasks->addTask("Report Plugin Load Failures", DeferredTaskScheduler::Priority::Normal, [this] {
+    m_PluginLoadReportQueued = false;
+    showPluginLoadReport();
+  });
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::showPluginLoadReport()
+{
+  PluginLoadReport report = m_PluginLoader->getLoadReport();
+  m_PluginLoader->clearLoadReport();
+  if(report.isEmpty())
+  {
+    return;
+  }
+
+  QString logFilePath = PluginLoadReport::GetLogFilePath();
+  report.appendToLog(logFilePath);
+
+  QString text = tr("%1 plugin(s) did not load. Possible causes include missing libraries that the plugins depend on.").arg(report.getFailures().size());
+  QString infoText = tr("The details were also written to %1").arg(QDir::toNativeSeparators(logFilePath));
+
+  // Not modal, so that the window stays usable
+  QMessageBox* box = new QMessageBox(QMessageBox::Critical, tr("Plugin Load Error"), text, QMessageBox::Ok, m_ActiveWindow);
+  box->setInformativeText(infoText);
+  box->setDetailedText(report.toText());
+  box->setAttribute(Qt::WA_DeleteOnClose);
+  box->setModal(false);
+  box->show();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::addDeferredStartupTasks()
+{
+  using Priority = DeferredTaskScheduler::Priority;
+
+  // The prefs file has been read by the time the first window is built. Filling the
+  // recent files menu and the bookmarks is what is deferred.
+  m_DeferredTasks->addTask("Read Recent Files and Bookmarks", Priority::High, [this] {
+    SIMPLViewSettings::Instance()->readWith([this](QtSSettings* prefs) {
+      QtSRecentFileList::Instance()->readList(prefs);
+      foreach(SIMPLView_UI* instance, m_SIMPLViewInstances)
+      {
+        instance->readBookmarksSettings(prefs);
+      }
+    });
+    m_RecentFilesLoaded = true;
+    m_BookmarksLoaded = true;
+    updateRecentFileList(QString());
+  });
+
+  // The plugins used by the recent pipelines are the ones most likely to be needed
+  // next, so open them now instead of when the first of their filters is created
+  m_DeferredTasks->addTask("Preload Recent Pipeline Plugins", Priority::Normal, [this] {
+    if(m_PluginLoader != nullptr)
+    {
+      m_PluginLoader->preloadPluginsForPipelines(QtSRecentFileList::Instance()->fileList());
+    }
+  });
+
+  // Automatically check for updates at startup if the user has indicated that preference before
+  m_DeferredTasks->addTask("Check For Updates", Priority::Low, [this] { checkForUpdatesAtStartup(); });
+
+#ifdef SIMPL_USE_MKDOCS
+  m_DeferredTasks->addTask("Start Documentation Server", Priority::Low, [] { QtSDocServer::Instance(); });
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLViewApplication::areBookmarksLoaded() const
+{
+  return m_BookmarksLoaded;
 }
 
 // -----------------------------------------------------------------------------
@@ -906,6 +1031,7 @@ void SIMPLViewApplication::registerSIMPLViewWindow(SIMPLView_UI* window)
 void SIMPLViewApplication::unregisterSIMPLViewWindow(SIMPLView_UI* window)
 {
   m_SIMPLViewInstances.removeAll(window);
+  m_WindowPool.removeAll(window);
 
   if (m_SIMPLViewInstances.isEmpty())
   {
@@ -914,7 +1040,8 @@ void SIMPLViewApplication::unregisterSIMPLViewWindow(SIMPLView_UI* window)
 
 #if defined(Q_OS_MAC)
 #else
-  if (m_SIMPLViewInstances.size() <= 0)
+  // The hidden windows in the pool do not keep the application running
+  if (m_SIMPLViewInstances.size() <= m_WindowPool.size())
   {
     quit();
   }
@@ -932,13 +1059,60 @@ bool SIMPLViewApplication::event(QEvent* event)
     QFileOpenEvent* openEvent = static_cast<QFileOpenEvent*>(event);
     QString filePath = openEvent->file();
 
-    newInstanceFromFile(filePath);
+    // Files that arrive while starting up are opened once the plugins are registered
+    if(m_StartupFinished && m_PluginsLoaded)
+    {
+      newInstanceFromFile(filePath);
+    }
+    else
+    {
+      m_PendingFilePaths.push_back(filePath);
+    }
   }
   #endif
 
   return QApplication::event(event);
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::openForwardedFiles(const QStringList& filePaths)
+{
+  // A launch without files asks for a window. The first window is still to come while
+  // starting up, and a new one picks up the plugins once they are registered.
+  if(filePaths.isEmpty())
+  {
+    if(m_StartupFinished)
+    {
+      SIMPLView_UI* instance = getNewSIMPLViewInstance();
+      instance->show();
+      instance->raise();
+      instance->activateWindow();
+    }
+    return;
+  }
+
+  // Files that arrive while starting up are opened once the plugins are registered
+  if(!m_StartupFinished || !m_PluginsLoaded)
+  {
+    m_PendingFilePaths.append(filePaths);
+    return;
+  }
+
+  SIMPLView_UI* instance = nullptr;
+  foreach(QString filePath, filePaths)
+  {
+    instance = newInstanceFromFile(filePath);
+  }
+
+  if(instance != nullptr)
+  {
+    instance->raise();
+    instance->activateWindow();
+  }
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -952,13 +1126,14 @@ void SIMPLViewApplication::setActiveWindow(SIMPLView_UI* instance)
 // -----------------------------------------------------------------------------
 void SIMPLViewApplication::writeSettings()
 {
-  QSharedPointer<QtSSettings> prefs = QSharedPointer<QtSSettings>(new QtSSettings());
+  SIMPLViewSettings* prefs = SIMPLViewSettings::Instance();
 
   prefs->beginGroup("Application Settings");
 
-  SVStyle* styles = SVStyle::Instance();
-  QString themeFilePath = styles->getCurrentThemeFilePath();
+  QString themeFilePath = ThemeCache::Instance()->getCurrentThemeFilePath();
   prefs->setValue("Theme File Path", themeFilePath);
+  prefs->setValue("Lazy Plugin Activation", m_LazyPluginActivation);
+  prefs->setValue("Window Pool Size", m_WindowPoolSize);
 
   #if defined SIMPL_RELATIVE_PATH_CHECK
   SIMPLDataPathValidator* validator = SIMPLDataPathValidator::Instance();
@@ -968,10 +1143,17 @@ void SIMPLViewApplication::writeSettings()
 
   prefs->endGroup();
 
-  BookmarksModel* model = BookmarksModel::Instance();
-  model->writeBookmarksToPrefsFile();
+  // Lists that were never read must not overwrite the saved ones
+  if(m_BookmarksLoaded)
+  {
+    BookmarksModel* model = BookmarksModel::Instance();
+    model->writeBookmarksToPrefsFile();
+  }
 
-  QtSRecentFileList::Instance()->writeList(prefs.data());
+  if(m_RecentFilesLoaded)
+  {
+    prefs->writeWith([](QtSSettings* recentPrefs) { QtSRecentFileList::Instance()->writeList(recentPrefs); });
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -979,18 +1161,30 @@ void SIMPLViewApplication::writeSettings()
 // -----------------------------------------------------------------------------
 void SIMPLViewApplication::readSettings()
 {
-  QSharedPointer<QtSSettings> prefs = QSharedPointer<QtSSettings>(new QtSSettings());
+  STARTUP_TRACE_SCOPE("SIMPLViewApplication::readSettings");
+
+  SIMPLViewSettings* prefs = SIMPLViewSettings::Instance();
 
   prefs->beginGroup("Application Settings");
 
-  SVStyle* styles = SVStyle::Instance();
+  // Only one theme is loaded at startup: the saved one if it is still valid and the
+  // default one otherwise
+  ThemeCache* themeCache = ThemeCache::Instance();
+  QString defaultLoadedThemePath = BrandedStrings::DefaultStyleDirectory + "/" + BrandedStrings::DefaultLoadedTheme + ".json";
   QString themeFilePath = prefs->value("Theme File Path", QString()).toString();
   QFileInfo fi(themeFilePath);
-  if (themeFilePath.isEmpty() == false && BrandedStrings::LoadedThemeNames.contains(fi.baseName()))
+  if(themeFilePath.isEmpty() || !BrandedStrings::LoadedThemeNames.contains(fi.baseName()) || !themeCache->loadTheme(themeFilePath))
   {
-    styles->loadStyleSheet(themeFilePath);
+    themeCache->loadTheme(defaultLoadedThemePath);
   }
 
+  // On by default: plugins that are unchanged since the manifest was written are opened
+  // when one of their filters is first used. Turning it off restores the eager loading.
+  m_LazyPluginActivation = prefs->value("Lazy Plugin Activation", true).toBool();
+
+  // Each pooled window holds a full set of widgets, so the pool is kept small
+  m_WindowPoolSize = qBound(0, prefs->value("Window Pool Size", 1).toInt(), 4);
+
   #if defined SIMPL_RELATIVE_PATH_CHECK
   SIMPLDataPathValidator* validator = SIMPLDataPathValidator::Instance();
   QString dataDir = prefs->value("Data Directory", QString()).toString();
@@ -1218,16 +1412,16 @@ void SIMPLViewApplication::createDefaultMenuBar()
 // -----------------------------------------------------------------------------
 QMenu* SIMPLViewApplication::createThemeMenu(QActionGroup* actionGroup, QWidget* parent)
 {
-  SVStyle* style = SVStyle::Instance();
+  ThemeCache* themeCache = ThemeCache::Instance();
 
   QMenu* menuThemes = new QMenu("Themes", parent);
 
   QString themePath = ":/SIMPL/StyleSheets/Default.json";
   QAction* action = menuThemes->addAction("Default", [=] {
-    style->loadStyleSheet(themePath);
+    themeCache->loadTheme(themePath);
   });
   action->setCheckable(true);
-  if(themePath == style->getCurrentThemeFilePath())
+  if(themePath == themeCache->getCurrentThemeFilePath())
   {
     action->setChecked(true);
   }
@@ -1238,10 +1432,10 @@ QMenu* SIMPLViewApplication::createThemeMenu(QActionGroup* actionGroup, QWidget*
   {
     QString themePath = BrandedStrings::DefaultStyleDirectory + QDir::separator() + themeNames[i] + ".json";
     QAction* action = menuThemes->addAction(themeNames[i], [=] {
-      style->loadStyleSheet(themePath);
+      themeCache->loadTheme(themePath);
     });
     action->setCheckable(true);
-    if(themePath == style->getCurrentThemeFilePath())
+    if(themePath == themeCache->getCurrentThemeFilePath())
     {
       action->setChecked(true);
     }
@@ -35,6 +35,7 @@
 
 #pragma once
 
+#include <QtCore/QPointer>
 #include <QtCore/QSet>
 #include <QtCore/QSharedPointer>
 
@@ -48,7 +49,9 @@
 
 class QSplashScreen;
 class SIMPLView_UI;
-class QPluginLoader;
+class SIMPLViewPluginLoader;
+class DeferredTaskScheduler;
+class SingleInstanceServer;
 class ISIMPLibPlugin;
 class SIMPLViewToolbox;
 class SVPipelineFilterWidget;
@@ -80,6 +83,14 @@ public:
 
   bool initialize(int argc, char* argv[]);
 
+  /**
+   * @brief startFirstInstance Builds the first window while the plugins are still loading.
+   * The window is shown, and the pipeline file opened, once the plugins are registered and
+   * the minimum splash time has passed.
+   * @param filePath The pipeline to open or an empty string
+   */
+  void startFirstInstance(const QString& filePath);
+
   /**
    * @brief readSettings
    */
@@ -115,6 +126,14 @@ public:
    */
   bool event(QEvent* event);
 
+  /**
+   * @brief eventFilter Watches for the first paint of the first window
+   * @param watched
+   * @param event
+   * @return
+   */
+  bool eventFilter(QObject* watched, QEvent* event) override;
+
   /**
    * @brief getRecentFilesMenu
    * @return
@@ -145,6 +164,43 @@ public slots:
   */
   void updateRecentFileList(const QString& file);
 
+  /**
+   * @brief openForwardedFiles Opens the files that another launch forwarded to this
+   * instance, or a new window if there are none. A request for a new window during startup
+   * is met by the first window.
+   * @param filePaths
+   */
+  void openForwardedFiles(const QStringList& filePaths);
+
+  /**
+   * @brief areBookmarksLoaded Returns true once the bookmarks have been read from the prefs file
+   * @return
+   */
+  bool areBookmarksLoaded() const;
+
+protected slots:
+  /**
+   * @brief firstWindowPainted Starts the work that can wait until the first window is on screen
+   */
+  void firstWindowPainted();
+
+  /**
+   * @brief finishStartup Shows the first window once it is built and the splash screen has
+   * been up long enough. The plugins may still be loading.
+   */
+  void finishStartup();
+
+  /**
+   * @brief finishPluginLoading Fills the filter toolboxes of the windows once every plugin
+   * has been registered and opens the files that were waiting for them
+   */
+  void finishPluginLoading();
+
+  /**
+   * @brief clearWindowPool Deletes the hidden windows that were never handed out
+   */
+  void clearWindowPool();
+
 protected:
   // This is a set of all SIMPLView instances currently available
   QList<SIMPLView_UI*> m_SIMPLViewInstances;
@@ -156,13 +212,64 @@ protected:
 
   bool m_ShowSplash;
   QSplashScreen* m_SplashScreen;
-  QVector<QPluginLoader*> m_PluginLoaders;
+  SIMPLViewPluginLoader* m_PluginLoader = nullptr;
+  bool m_LazyPluginActivation = true;
+  bool m_FirstWindowPainted = false;
+  bool m_SplashTimeElapsed = true;
+  bool m_StartupFinished = false;
+  bool m_PluginsLoaded = false;
+  QPointer<SIMPLView_UI> m_FirstInstance;
+  QStringList m_PendingFilePaths;
+  DeferredTaskScheduler* m_DeferredTasks = nullptr;
+  SingleInstanceServer* m_InstanceServer = nullptr;
+  bool m_RecentFilesLoaded = false;
+  bool m_BookmarksLoaded = false;
+  QList<SIMPLView_UI*> m_WindowPool;
+  int m_WindowPoolSize = 1;
+  bool m_WindowPoolRefillQueued = false;
+  bool m_PluginLoadReportQueued = false;
+
+  /**
+   * @brief loadPlugins Starts loading the plugins in the background. finishPluginLoading()
+   * is called when they are all registered.
+   */
+  void loadPlugins();
+
+  /**
+   * @brief openPendingFiles Opens the files that were passed on the command line or
+   * forwarded while starting up, once the first window is shown and the plugins are loaded
+   */
+  void openPendingFiles();
 
   /**
-   * @brief loadPlugins
+   * @brief addDeferredStartupTasks Adds the startup work that runs after the first window
+   * has been painted
+   */
+  void addDeferredStartupTasks();
+
+  /**
+   * @brief createSIMPLViewInstance Builds a new hidden window
    * @return
    */
-  QVector<ISIMPLibPlugin*> loadPlugins();
+  SIMPLView_UI* createSIMPLViewInstance();
+
+  /**
+   * @brief refillWindowPool Queues the building of hidden windows until the pool holds the
+   * number of windows set by the "Window Pool Size" preference
+   */
+  void refillWindowPool();
+
+  /**
+   * @brief queuePluginLoadReport Queues showPluginLoadReport() once the first window has
+   * been painted, if any plugin failed to load
+   */
+  void queuePluginLoadReport();
+
+  /**
+   * @brief showPluginLoadReport Shows the plugins that failed to load in one message box
+   * that does not block the application and appends them to the log file
+   */
+  void showPluginLoadReport();
 
   /**
    * @brief checkForUpdatesAtStartup
@@ -0,0 +1,961 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "SIMPLViewPluginLoader.h"
+
+#include <future>
+
+#if !defined(_MSC_VER)
+#include <unistd.h>
+#endif
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFuture>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMap>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QPluginLoader>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Plugin/ISIMPLibPlugin.h"
+#include "SIMPLib/Plugin/PluginManager.h"
+#include "SIMPLib/Plugin/PluginProxy.h"
+
+#include "SVWidgetsLib/Core/FilterWidgetManager.h"
+#include "SVWidgetsLib/Dialogs/AboutPlugins.h"
+
+#include "SIMPLView/LazyFilterFactory.h"
+#include "SIMPLView/StartupTrace.h"
+
+#include "BrandedStrings.h"
+
+namespace Detail
+{
+/**
+ * @brief The result of opening a single plugin library on one of the worker threads
+ */
+struct PluginInstance
+{
+  QPluginLoader* loader = nullptr;
+  QObject* instance = nullptr;
+  qint64 loadTimeMs = 0;
+};
+
+// -----------------------------------------------------------------------------
+// This runs on a worker thread. Reading the plugin meta data first pulls the whole
+// file through the (possibly remote) file system in parallel with the other
+// plugins; the dlopen() inside instance() then finds the pages already cached.
+// -----------------------------------------------------------------------------
+PluginInstance instantiatePlugin(const QString& path)
+{
+  STARTUP_TRACE_SCOPE("Open Plugin", QFileInfo(path).fileName());
+
+  QThread* mainThread = QCoreApplication::instance()->thread();
+  QElapsedTimer timer;
+  timer.start();
+
+  PluginInstance result;
+  result.loader = new QPluginLoader(path);
+  result.loader->metaData();
+  result.instance = result.loader->instance();
+  result.loadTimeMs = timer.elapsed();
+
+  // Both objects were created on this worker thread. Hand them over to the main
+  // thread so they are registered and destroyed from the thread that owns them.
+  // The root instance is shared between loaders of the same file and may already
+  // live on the main thread if the plugin was activated in the meantime.
+  if(result.instance != nullptr && result.instance->thread() == QThread::currentThread())
+  {
+    result.instance->moveToThread(mainThread);
+  }
+  result.loader->moveToThread(mainThread);
+
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+// Collects the factories that one plugin registers, so that the manifest records exactly
+// the filters of that plugin whatever else is registered meanwhile
+// -----------------------------------------------------------------------------
+class PluginFilterCollector : public FilterManager
+{
+public:
+  PluginFilterCollector() = default;
+  ~PluginFilterCollector() override = default;
+};
+
+// -----------------------------------------------------------------------------
+// Waits for the future while keeping the splash screen and event loop alive
+// -----------------------------------------------------------------------------
+void waitForPlugin(const QFuture<PluginInstance>& future)
+{
+  if(future.isFinished())
+  {
+    return;
+  }
+
+  QEventLoop loop;
+  QFutureWatcher<PluginInstance> watcher;
+  QObject::connect(&watcher, &QFutureWatcher<PluginInstance>::finished, &loop, &QEventLoop::quit);
+  watcher.setFuture(future);
+  if(!future.isFinished())
+  {
+    loop.exec();
+  }
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SIMPLViewPluginLoader::SIMPLViewPluginLoader(QObject* parent)
+: QObject(parent)
+{
+  connect(this, &SIMPLViewPluginLoader::activationRequested, this, &SIMPLViewPluginLoader::registerActivatedPlugin, Qt::QueuedConnection);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SIMPLViewPluginLoader::~SIMPLViewPluginLoader()
+{
+  // Release the threads that are still waiting for a plugin
+  {
+    QMutexLocker lock(&m_DeferredMutex);
+    for(const std::shared_ptr<PendingActivation>& activation : m_PendingActivations)
+    {
+      activation->promise.set_value(false);
+      delete activation->pluginInstance.loader;
+    }
+    m_PendingActivations.clear();
+  }
+
+  for(int i = 0; i < m_PluginLoaders.size(); i++)
+  {
+    delete m_PluginLoaders[i];
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewPluginLoader::setRegisterFilterWidgets(bool value)
+{
+  m_RegisterFilterWidgets = value;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewPluginLoader::setUseLoadingPreferences(bool value)
+{
+  m_UseLoadingPreferences = value;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewPluginLoader::setUseUserManifest(bool value)
+{
+  m_UseUserManifest = value;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewPluginLoader::setLazyActivation(bool value)
+{
+  m_LazyActivation = value;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const PluginManifest& SIMPLViewPluginLoader::getManifest() const
+{
+  return m_Manifest;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLViewPluginLoader::IsPluginFileName(const QString& fileName)
+{
+#ifdef QT_DEBUG
+  return fileName.endsWith("_debug.guiplugin", Qt::CaseSensitive);
+#else
+  return fileName.endsWith(".guiplugin", Qt::CaseSensitive)            // We want ONLY Release plugins
+         && !fileName.endsWith("_debug.guiplugin", Qt::CaseSensitive); // so ignore these plugins
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList SIMPLViewPluginLoader::GetPluginDirectories()
+{
+  QStringList pluginDirs;
+  pluginDirs << QCoreApplication::applicationDirPath();
+
+  QDir aPluginDir = QDir(QCoreApplication::applicationDirPath());
+  qDebug() << "Loading " << BrandedStrings::ApplicationName << " Plugins....";
+  QString thePath;
+
+#if defined(Q_OS_WIN)
+  if(aPluginDir.cd("Plugins"))
+  {
+    thePath = aPluginDir.absolutePath();
+    pluginDirs << thePath;
+  }
+#elif defined(Q_OS_MAC)
+  // Look to see if we are inside an .app package or inside the 'tools' directory
+  if(aPluginDir.dirName() == "MacOS")
+  {
+    aPluginDir.cdUp();
+    thePath = aPluginDir.absolutePath() + "/Plugins";
+    qDebug() << "  Adding Path " << thePath;
+    pluginDirs << thePath;
+    aPluginDir.cdUp();
+    aPluginDir.cdUp();
+    // We need this because Apple (in their infinite wisdom) changed how the current working directory is set in OS X 10.9 and above. Thanks Apple.
+    chdir(aPluginDir.absolutePath().toLatin1().constData());
+  }
+  if(aPluginDir.dirName() == "bin")
+  {
+    aPluginDir.cdUp();
+    // We need this because Apple (in their infinite wisdom) changed how the current working directory is set in OS X 10.9 and above. Thanks Apple.
+    chdir(aPluginDir.absolutePath().toLatin1().constData());
+  }
+  // aPluginDir.cd("Plugins");
+  thePath = aPluginDir.absolutePath() + "/Plugins";
+  qDebug() << "  Adding Path " << thePath;
+  pluginDirs << thePath;
+
+// This is here for Xcode compatibility
+#ifdef CMAKE_INTDIR
+  aPluginDir.cdUp();
+  thePath = aPluginDir.absolutePath() + "/Plugins/" + CMAKE_INTDIR;
+  pluginDirs << thePath;
+#endif
+#else
+  // We are on Linux - I think
+  // Try the current location of where the application was launched from which is
+  // typically the case when debugging from a build tree
+  if(aPluginDir.cd("Plugins"))
+  {
+    thePath = aPluginDir.absolutePath();
+    pluginDirs << thePath;
+    aPluginDir.cdUp(); // Move back up a directory level
+  }
+
+  if(thePath.isEmpty())
+  {
+    // Now try moving up a directory which is what should happen when running from a
+    // proper distribution of SIMPLView
+    aPluginDir.cdUp();
+    if(aPluginDir.cd("Plugins"))
+    {
+      thePath = aPluginDir.absolutePath();
+      pluginDirs << thePath;
+      aPluginDir.cdUp(); // Move back up a directory level
+      int no_error = chdir(aPluginDir.absolutePath().toLatin1().constData());
+      if(no_error < 0)
+      {
+        qDebug() << "Could not set the working directory.";
+      }
+    }
+  }
+#endif
+
+  QByteArray pluginEnvPath = qgetenv("SIMPL_PLUGIN_PATH");
+  qDebug() << "SIMPL_PLUGIN_PATH:" << pluginEnvPath;
+
+  char sep = ';';
+#if defined(Q_OS_WIN)
+  sep = ':';
+#endif
+  QList<QByteArray> envPaths = pluginEnvPath.split(sep);
+  foreach(QByteArray envPath, envPaths)
+  {
+    if(envPath.size() > 0)
+    {
+      pluginDirs << QString::fromLatin1(envPath);
+    }
+  }
+
+  int dupes = pluginDirs.removeDuplicates();
+  qDebug() << "Removed " << dupes << " duplicate Plugin Paths";
+
+  return pluginDirs;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList SIMPLViewPluginLoader::preparePlugins()
+{
+  QStringList pluginDirs = GetPluginDirectories();
+
+  // The per-user manifest wins over the manifests that were written into the
+  // plugin directories when the package was built
+  if(m_UseUserManifest)
+  {
+    m_Manifest.readFile(PluginManifest::GetUserManifestFilePath());
+  }
+  foreach(QString pluginDirString, pluginDirs)
+  {
+    m_Manifest.readFile(pluginDirString + "/" + PluginManifest::GetInstallManifestFileName());
+  }
+
+  QStringList pluginFilePaths = m_Manifest.findPluginFiles(pluginDirs, IsPluginFileName);
+  m_Manifest.removeMissingEntries(pluginFilePaths);
+
+  FilterManager* filterManager = FilterManager::Instance();
+
+  // THIS IS A VERY IMPORTANT LINE: It will register all the known filters in the dream3d library. This
+  // will NOT however get filters from plugins. We are going to have to figure out how to compile filters
+  // into their own plugin and load the plugins from a command line.
+  filterManager->RegisterKnownFilters(filterManager);
+
+  m_LoadingMap.clear();
+  if(m_UseLoadingPreferences)
+  {
+    QList<PluginProxy::Pointer> proxies = AboutPlugins::readPluginCache();
+    for(QList<PluginProxy::Pointer>::iterator nameIter = proxies.begin(); nameIter != proxies.end(); nameIter++)
+    {
+      PluginProxy::Pointer proxy = *nameIter;
+      m_LoadingMap.insert(proxy->getPluginName(), proxy->getEnabled());
+    }
+  }
+
+  // A disabled plugin only needs to be opened to find out its name. If the manifest
+  // already knows the name of an unchanged plugin file, leave the library alone.
+  // With lazy activation the same goes for enabled plugins whose filters are known.
+  QStringList filesToOpen;
+  foreach(QString path, pluginFilePaths)
+  {
+    if(m_Manifest.isCurrent(path))
+    {
+      PluginManifest::PluginEntry entry = m_Manifest.getEntry(path);
+      if(!entry.pluginName.isEmpty() && m_LoadingMap.value(entry.pluginName, true) == false)
+      {
+        qDebug() << "Plugin Skipped (disabled):" << path;
+        m_SkippedPluginPaths.push_back(path);
+        continue;
+      }
+      if(m_LazyActivation && entry.filtersKnown)
+      {
+        qDebug() << "Plugin Deferred:" << path;
+        registerProxies(entry);
+        QMutexLocker lock(&m_DeferredMutex);
+        m_DeferredPluginPaths.push_back(path);
+        continue;
+      }
+    }
+    filesToOpen.push_back(path);
+  }
+
+  return filesToOpen;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLViewPluginLoader::isEnabled(const QString& pluginName) const
+{
+  return m_LoadingMap.value(pluginName, true);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLViewPluginLoader::takeDeferredPlugin(const QString& filePath)
+{
+  QMutexLocker lock(&m_DeferredMutex);
+  return m_DeferredPluginPaths.removeAll(filePath) > 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewPluginLoader::finishLoading()
+{
+  if(m_UseUserManifest && m_Manifest.isDirty())
+  {
+    m_Manifest.writeFile(PluginManifest::GetUserManifestFilePath());
+  }
+  m_FinishedLoading = true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<ISIMPLibPlugin*> SIMPLViewPluginLoader::loadPlugins()
+{
+  QStringList filesToOpen = preparePlugins();
+  openPlugins(filesToOpen, [this](const QString& pluginName) { return isEnabled(pluginName); });
+  finishLoading();
+
+  return PluginManager::Instance()->getPluginsVector();
+}
+
+/**
+ * @brief A plugin that a worker thread opened and that waits to be registered
+ */
+struct SIMPLViewPluginLoader::PendingActivation
+{
+  Detail::PluginInstance pluginInstance;
+  std::promise<bool> promise;
+  std::shared_future<bool> result;
+};
+
+/**
+ * @brief The state of a loadPluginsAsync() call
+ */
+struct SIMPLViewPluginLoader::AsyncLoadState
+{
+  QThreadPool pool;
+  QStringList filePaths;
+  QVector<QFuture<Detail::PluginInstance>> futures;
+  int nextPlugin = 0;
+  bool registering = false;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewPluginLoader::loadPluginsAsync()
+{
+  m_AsyncLoad = std::make_shared<AsyncLoadState>();
+  m_AsyncLoad->pool.setMaxThreadCount(qMax(4, QThread::idealThreadCount()));
+  m_AsyncLoad->filePaths = preparePlugins();
+
+  foreach(QString path, m_AsyncLoad->filePaths)
+  {
+    QFuture<Detail::PluginInstance> future = QtConcurrent::run(&m_AsyncLoad->pool, Detail::instantiatePlugin, path);
+    m_AsyncLoad->futures.push_back(future);
+
+    QFutureWatcher<Detail::PluginInstance>* watcher = new QFutureWatcher<Detail::PluginInstance>(this);
+    connect(watcher, &QFutureWatcher<Detail::PluginInstance>::finished, this, [this, watcher] {
+      watcher->deleteLater();
+      registerFinishedPlugins();
+    });
+    watcher->setFuture(future);
+  }
+
+  // Nothing to open, but the caller still expects the signal from the event loop
+  if(m_AsyncLoad->filePaths.isEmpty())
+  {
+    QTimer::singleShot(0, this, &SIMPLViewPluginLoader::registerFinishedPlugins);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Registers the opened plugins in the order of the plugin paths, so the registry
+// ends up the same as with loadPlugins(). A plugin that finishes opening early
+// waits for the ones before it.
+// -----------------------------------------------------------------------------
+void SIMPLViewPluginLoader::registerFinishedPlugins()
+{
+  std::shared_ptr<AsyncLoadState> state = m_AsyncLoad;
+  if(state == nullptr || state->registering)
+  {
+    return;
+  }
+
+  state->registering = true;
+  while(state->nextPlugin < state->futures.size() && state->futures[state->nextPlugin].isFinished())
+  {
+    QString path = state->filePaths[state->nextPlugin];
+    Detail::PluginInstance pluginInstance = state->futures[state->nextPlugin].result();
+    state->nextPlugin++;
+
+    qDebug() << "Plugin Being Loaded:" << path;
+    bool registerFilters = true;
+    ISIMPLibPlugin* ipPlugin = qobject_cast<ISIMPLibPlugin*>(pluginInstance.instance);
+    if(ipPlugin)
+    {
+      registerFilters = isEnabled(ipPlugin->getPluginFileName());
+    }
+    registerPlugin(path, pluginInstance, registerFilters);
+  }
+  state->registering = false;
+
+  if(state->nextPlugin == state->futures.size())
+  {
+    m_AsyncLoad.reset();
+    finishLoading();
+    emit pluginsLoaded();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLViewPluginLoader::isFinishedLoading() const
+{
+  return m_FinishedLoading;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewPluginLoader::loadSkippedPlugins()
+{
+  // The Plugin Information dialog lists everything in the PluginManager, so the
+  // deferred plugins have to be activated as well
+  QStringList deferredPaths;
+  {
+    QMutexLocker lock(&m_DeferredMutex);
+    deferredPaths.swap(m_DeferredPluginPaths);
+  }
+  if(!deferredPaths.isEmpty())
+  {
+    openPlugins(deferredPaths, [](const QString&) { return true; });
+  }
+
+  if(m_SkippedPluginPaths.isEmpty())
+  {
+    return;
+  }
+
+  QStringList skippedPaths = m_SkippedPluginPaths;
+  m_SkippedPluginPaths.clear();
+  openPlugins(skippedPaths, [](const QString&) { return false; });
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PluginLoadReport SIMPLViewPluginLoader::getLoadReport() const
+{
+  return m_LoadReport;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewPluginLoader::clearLoadReport()
+{
+  m_LoadReport.clear();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLViewPluginLoader::activatePlugin(const QString& filePath)
+{
+  if(QThread::currentThread() != thread())
+  {
+    return activatePluginFromWorker(filePath);
+  }
+
+  bool pending = false;
+  {
+    QMutexLocker lock(&m_DeferredMutex);
+    pending = m_PendingActivations.contains(filePath);
+  }
+  if(pending)
+  {
+    // A worker already opened the library and its request is still in the queue
+    return registerActivatedPlugin(filePath);
+  }
+
+  if(!takeDeferredPlugin(filePath))
+  {
+    // Already active. If the library failed to load, the caller still finds only
+    // the proxy in the FilterManager.
+    return true;
+  }
+
+  Detail::PluginInstance pluginInstance = Detail::instantiatePlugin(filePath);
+  return registerPlugin(filePath, pluginInstance, true);
+}
+
+// -----------------------------------------------------------------------------
+// The library is opened on the calling thread. Only the registration is queued to the
+// thread of the loader, which fulfills the promise that every caller for this plugin
+// waits on.
+// -----------------------------------------------------------------------------
+bool SIMPLViewPluginLoader::activatePluginFromWorker(const QString& filePath)
+{
+  std::shared_future<bool> result;
+  {
+    QMutexLocker lock(&m_DeferredMutex);
+    if(m_PendingActivations.contains(filePath))
+    {
+      result = m_PendingActivations[filePath]->result;
+    }
+    else if(!m_DeferredPluginPaths.contains(filePath))
+    {
+      return true;
+    }
+  }
+
+  if(!result.valid())
+  {
+    Detail::PluginInstance pluginInstance = Detail::instantiatePlugin(filePath);
+
+    bool requested = false;
+    {
+      QMutexLocker lock(&m_DeferredMutex);
+      if(m_PendingActivations.contains(filePath))
+      {
+        // Another thread opened it at the same time
+        result = m_PendingActivations[filePath]->result;
+      }
+      else if(m_DeferredPluginPaths.removeAll(filePath) > 0)
+      {
+        std::shared_ptr<PendingActivation> activation = std::make_shared<PendingActivation>();
+        activation->pluginInstance = pluginInstance;
+        activation->result = activation->promise.get_future().share();
+        m_PendingActivations.insert(filePath, activation);
+        result = activation->result;
+        requested = true;
+      }
+    }
+
+    if(!requested)
+    {
+      // Deleting the loader does not unload the library
+      delete pluginInstance.loader;
+      if(!result.valid())
+      {
+        return true;
+      }
+    }
+    else
+    {
+      emit activationRequested(filePath);
+    }
+  }
+  return result.get();
+}
+
+// -----------------------------------------------------------------------------
+// The activation stays pending until the proxies have been replaced, so that a thread
+// that creates another filter of the plugin meanwhile waits for it as well.
+// -----------------------------------------------------------------------------
+bool SIMPLViewPluginLoader::registerActivatedPlugin(const QString& filePath)
+{
+  std::shared_ptr<PendingActivation> activation;
+  {
+    QMutexLocker lock(&m_DeferredMutex);
+    activation = m_PendingActivations.value(filePath);
+  }
+  if(activation == nullptr)
+  {
+    // Already registered by a direct call from this thread
+    return true;
+  }
+
+  bool registered = registerPlugin(filePath, activation->pluginInstance, true);
+  {
+    QMutexLocker lock(&m_DeferredMutex);
+    m_PendingActivations.remove(filePath);
+  }
+  activation->promise.set_value(registered);
+  return registered;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewPluginLoader::preloadPluginsForPipelines(const QStringList& pipelineFilePaths)
+{
+  QStringList deferredPaths;
+  {
+    QMutexLocker lock(&m_DeferredMutex);
+    deferredPaths = m_DeferredPluginPaths;
+  }
+  if(deferredPaths.isEmpty() || pipelineFilePaths.isEmpty())
+  {
+    return;
+  }
+
+  QMap<QString, QString> pluginPathByFilter;
+  foreach(QString path, deferredPaths)
+  {
+    PluginManifest::PluginEntry entry = m_Manifest.getEntry(path);
+    for(const PluginManifest::FilterEntry& filter : entry.filters)
+    {
+      pluginPathByFilter.insert(filter.className, path);
+    }
+  }
+
+  // Reading the pipeline files and opening the libraries both happen on worker
+  // threads. Only the registration comes back to this thread.
+  QFutureWatcher<QStringList>* pipelineWatcher = new QFutureWatcher<QStringList>(this);
+  connect(pipelineWatcher, &QFutureWatcher<QStringList>::finished, this, [this, pipelineWatcher] {
+    QStringList pluginPaths = pipelineWatcher->result();
+    pipelineWatcher->deleteLater();
+
+    foreach(QString path, pluginPaths)
+    {
+      {
+        QMutexLocker lock(&m_DeferredMutex);
+        if(!m_DeferredPluginPaths.contains(path))
+        {
+          continue;
+        }
+      }
+
+      QFutureWatcher<Detail::PluginInstance>* pluginWatcher = new QFutureWatcher<Detail::PluginInstance>(this);
+      connect(pluginWatcher, &QFutureWatcher<Detail::PluginInstance>::finished, this, [this, pluginWatcher, path] {
+        Detail::PluginInstance pluginInstance = pluginWatcher->result();
+        pluginWatcher->deleteLater();
+
+        if(takeDeferredPlugin(path))
+        {
+          registerPlugin(path, pluginInstance, true);
+        }
+        else
+        {
+          // A filter from this plugin was created while it was being opened. Deleting
+          // the loader does not unload the library.
+          delete pluginInstance.loader;
+        }
+      });
+      pluginWatcher->setFuture(QtConcurrent::run(Detail::instantiatePlugin, path));
+    }
+  });
+
+  pipelineWatcher->setFuture(QtConcurrent::run([pipelineFilePaths, pluginPathByFilter] {
+    QStringList pluginPaths;
+    foreach(QString pipelineFilePath, pipelineFilePaths)
+    {
+      QStringList filterClassNames = ReadPipelineFilterClassNames(pipelineFilePath);
+      foreach(QString className, filterClassNames)
+      {
+        QString pluginPath = pluginPathByFilter.value(className);
+        if(!pluginPath.isEmpty() && !pluginPaths.contains(pluginPath))
+        {
+          pluginPaths.push_back(pluginPath);
+        }
+      }
+    }
+    return pluginPaths;
+  }));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList SIMPLViewPluginLoader::ReadPipelineFilterClassNames(const QString& filePath)
+{
+  QStringList filterClassNames;
+
+  // Pipelines stored inside .dream3d files would need the HDF5 reader, which is not
+  // worth the cost for a preload hint
+  if(!filePath.endsWith(".json", Qt::CaseInsensitive))
+  {
+    return filterClassNames;
+  }
+
+  QFile file(filePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return filterClassNames;
+  }
+
+  QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+  QJsonObject root = doc.object();
+  for(QJsonObject::iterator iter = root.begin(); iter != root.end(); ++iter)
+  {
+    QString className = iter.value().toObject()["Filter_Name"].toString();
+    if(!className.isEmpty())
+    {
+      filterClassNames.push_back(className);
+    }
+  }
+
+  return filterClassNames;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewPluginLoader::registerProxies(const PluginManifest::PluginEntry& entry)
+{
+  FilterManager* filterManager = FilterManager::Instance();
+  for(const PluginManifest::FilterEntry& filter : entry.filters)
+  {
+    filterManager->addFilterFactory(filter.className, LazyFilterFactory::New(filter, entry.filePath, this));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewPluginLoader::openPlugins(const QStringList& filePaths, std::function<bool(const QString&)> shouldRegister)
+{
+  // Open every plugin library concurrently. Only the QPluginLoader/instance() step
+  // runs on the worker threads; registration with the filter and widget managers
+  // happens below on this thread, in the same order as filePaths, so the
+  // resulting registry is identical to loading the plugins one after another.
+  QThreadPool loaderPool;
+  loaderPool.setMaxThreadCount(qMax(4, QThread::idealThreadCount()));
+
+  QVector<QFuture<Detail::PluginInstance>> pendingPlugins;
+  pendingPlugins.reserve(filePaths.size());
+  foreach(QString path, filePaths)
+  {
+    pendingPlugins.push_back(QtConcurrent::run(&loaderPool, Detail::instantiatePlugin, path));
+  }
+
+  // Now that we have a sorted list of plugins, go ahead and register them and add
+  // each to the toolbar and menu as soon as its library has been opened
+  for(int i = 0; i < filePaths.size(); i++)
+  {
+    QString path = filePaths[i];
+    qDebug() << "Plugin Being Loaded:" << path;
+    Detail::waitForPlugin(pendingPlugins[i]);
+    Detail::PluginInstance pluginInstance = pendingPlugins[i].result();
+
+    bool registerFilters = true;
+    ISIMPLibPlugin* ipPlugin = qobject_cast<ISIMPLibPlugin*>(pluginInstance.instance);
+    if(ipPlugin)
+    {
+      registerFilters = shouldRegister(ipPlugin->getPluginFileName());
+    }
+    registerPlugin(path, pluginInstance, registerFilters);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLViewPluginLoader::registerPlugin(const QString& path, const Detail::PluginInstance& pluginInstance, bool registerFilters)
+{
+  QPluginLoader* loader = pluginInstance.loader;
+  QObject* plugin = pluginInstance.instance;
+  FilterManager* filterManager = FilterManager::Instance();
+  PluginManager* pluginManager = PluginManager::Instance();
+
+  QFileInfo fi(path);
+  QString fileName = fi.fileName();
+  STARTUP_TRACE_SCOPE("Register Plugin", fileName);
+  qDebug() << "    Pointer: " << plugin << "\n";
+  if(plugin == nullptr)
+  {
+    // Failures are collected and reported together so that a broken plugin does not
+    // stop the startup
+    QString errorString = loader->errorString();
+    m_LoadReport.addFailure(path, errorString, pluginInstance.loadTimeMs);
+    emit pluginFailedToLoad(path, errorString);
+    delete loader;
+    return false;
+  }
+
+  m_PluginLoaders.push_back(loader);
+
+  ISIMPLibPlugin* ipPlugin = qobject_cast<ISIMPLibPlugin*>(plugin);
+  if(ipPlugin == nullptr)
+  {
+    return false;
+  }
+
+  QString pluginName = ipPlugin->getPluginFileName();
+  if(registerFilters)
+  {
+    emit pluginLoading(fileName);
+    if(m_RegisterFilterWidgets)
+    {
+      ipPlugin->registerFilterWidgets(FilterWidgetManager::Instance());
+    }
+
+    // The plugin registers with a collector first, so the manifest records the filters
+    // it provides and not whatever else changed in the FilterManager meanwhile. Adding
+    // them to the FilterManager replaces our lazy proxies.
+    Detail::PluginFilterCollector collector;
+    ipPlugin->registerFilters(&collector);
+    ipPlugin->setDidLoad(true);
+
+    QVector<PluginManifest::FilterEntry> filters;
+    FilterManager::Collection factories = collector.getFactories();
+    for(FilterManager::Collection::iterator iter = factories.begin(); iter != factories.end(); ++iter)
+    {
+      IFilterFactory::Pointer factory = iter.value();
+      filterManager->addFilterFactory(iter.key(), factory);
+
+      PluginManifest::FilterEntry filter;
+      filter.className = iter.key();
+      filter.uuid = factory->getUuid();
+      filter.humanLabel = factory->getFilterHumanLabel();
+      filter.group = factory->getFilterGroup();
+      filter.subGroup = factory->getFilterSubGroup();
+      filter.compiledLibraryName = factory->getCompiledLibraryName();
+      filter.brandingString = factory->getBrandingString();
+      filters.push_back(filter);
+    }
+    m_Manifest.updateEntry(path, pluginName, filters, true);
+  }
+  else
+  {
+    ipPlugin->setDidLoad(false);
+
+    // Keep the filters of a disabled plugin that were recorded while it was enabled
+    // so that enabling it again does not require opening it at startup
+    if(!m_Manifest.isCurrent(path) || !m_Manifest.getEntry(path).filtersKnown)
+    {
+      m_Manifest.updateEntry(path, pluginName, QVector<PluginManifest::FilterEntry>(), false);
+    }
+  }
+
+  ipPlugin->setLocation(path);
+  pluginManager->addPlugin(ipPlugin);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLViewPluginLoader::writeManifest(const QString& filePath)
+{
+  return m_Manifest.writeFile(filePath);
+}
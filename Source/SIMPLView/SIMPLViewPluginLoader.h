@@ -0,0 +1,313 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "SIMPLView/PluginLoadReport.h"
+#include "SIMPLView/PluginManifest.h"
+
+class QPluginLoader;
+class ISIMPLibPlugin;
+
+namespace Detail
+{
+struct PluginInstance;
+}
+
+/**
+ * @brief The SIMPLViewPluginLoader class finds, opens and registers the SIMPLView plugins. It
+ * does not create any widgets so that it can be used before the first window exists and by
+ * the command line modes of the application.
+ */
+class SIMPLViewPluginLoader : public QObject
+{
+  Q_OBJECT
+
+public:
+  SIMPLViewPluginLoader(QObject* parent = nullptr);
+  ~SIMPLViewPluginLoader() override;
+
+  /**
+   * @brief GetPluginDirectories Returns the directories that are searched for plugins. Depending
+   * on the platform this also changes the current working directory to the top level of the
+   * installation.
+   * @return
+   */
+  static QStringList GetPluginDirectories();
+
+  /**
+   * @brief IsPluginFileName Returns true if the file name is a plugin for this build type
+   * @param fileName
+   * @return
+   */
+  static bool IsPluginFileName(const QString& fileName);
+
+  /**
+   * @brief setRegisterFilterWidgets Sets whether the filter parameter widgets of each plugin
+   * are registered. The command line modes do not need them.
+   * @param value
+   */
+  void setRegisterFilterWidgets(bool value);
+
+  /**
+   * @brief setUseLoadingPreferences Sets whether the plugins that were disabled in the
+   * Plugin Information dialog are skipped. The default is true.
+   * @param value
+   */
+  void setUseLoadingPreferences(bool value);
+
+  /**
+   * @brief setUseUserManifest Sets whether the manifest in the user's data folder is read
+   * before and updated after loading the plugins. The default is true.
+   * @param value
+   */
+  void setUseUserManifest(bool value);
+
+  /**
+   * @brief setLazyActivation Sets whether enabled plugins that are unchanged since the
+   * manifest was written are opened on demand. Their filters are registered as
+   * LazyFilterFactory proxies and the library is opened when the first of them is
+   * created. The default is false.
+   * @param value
+   */
+  void setLazyActivation(bool value);
+
+  /**
+   * @brief loadPlugins Loads the plugins and registers their filters with the FilterManager
+   * @return
+   */
+  QVector<ISIMPLibPlugin*> loadPlugins();
+
+  /**
+   * @brief loadPluginsAsync Starts loading the plugins and returns. The libraries are opened
+   * on worker threads and registered on this thread from the event loop as they become
+   * ready. pluginsLoaded() is emitted once every plugin has been registered.
+   */
+  void loadPluginsAsync();
+
+  /**
+   * @brief isFinishedLoading Returns true once loadPlugins() or loadPluginsAsync() is done
+   * @return
+   */
+  bool isFinishedLoading() const;
+
+  /**
+   * @brief loadSkippedPlugins Opens the plugins that loadPlugins() did not need to open.
+   * Deferred plugins are activated. Disabled plugins are added to the PluginManager, but
+   * their filters are not registered.
+   */
+  void loadSkippedPlugins();
+
+  /**
+   * @brief activatePlugin Opens a deferred plugin and registers its real filter factories
+   * in place of the proxies. Does nothing if the plugin is already active. Filters are
+   * created on the threads that execute pipelines. Such a thread opens the library itself
+   * and then waits until the thread of the loader, which is where every other plugin is
+   * registered, has processed the queued registration. That thread must therefore not
+   * block on a pipeline thread while plugins are deferred.
+   * @param filePath
+   * @return False if the plugin library could not be opened
+   */
+  bool activatePlugin(const QString& filePath);
+
+  /**
+   * @brief preloadPluginsForPipelines Activates, in the background, the deferred plugins
+   * whose filters are used by the given pipeline files
+   * @param pipelineFilePaths
+   */
+  void preloadPluginsForPipelines(const QStringList& pipelineFilePaths);
+
+  /**
+   * @brief ReadPipelineFilterClassNames Returns the filter class names used by a .json
+   * pipeline file without instantiating any of the filters
+   * @param filePath
+   * @return
+   */
+  static QStringList ReadPipelineFilterClassNames(const QString& filePath);
+
+  /**
+   * @brief writeManifest Writes the current manifest to the given file
+   * @param filePath
+   * @return
+   */
+  bool writeManifest(const QString& filePath);
+
+  /**
+   * @brief getManifest
+   * @return
+   */
+  const PluginManifest& getManifest() const;
+
+  /**
+   * @brief getLoadReport Returns the plugins that failed to load since the report was last cleared
+   * @return
+   */
+  PluginLoadReport getLoadReport() const;
+
+  /**
+   * @brief clearLoadReport
+   */
+  void clearLoadReport();
+
+signals:
+  /**
+   * @brief pluginsLoaded Emitted when loadPluginsAsync() has registered every plugin
+   */
+  void pluginsLoaded();
+
+  /**
+   * @brief pluginLoading Emitted before the filters of a plugin are registered
+   * @param fileName
+   */
+  void pluginLoading(const QString& fileName);
+
+  /**
+   * @brief pluginFailedToLoad Emitted when a plugin library could not be opened
+   * @param filePath
+   * @param errorString
+   */
+  void pluginFailedToLoad(const QString& filePath, const QString& errorString);
+
+  /**
+   * @brief activationRequested Queues the registration of a plugin that a worker thread
+   * opened to the thread of the loader
+   * @param filePath
+   */
+  void activationRequested(const QString& filePath);
+
+private:
+  QVector<QPluginLoader*> m_PluginLoaders;
+  PluginManifest m_Manifest;
+  QStringList m_SkippedPluginPaths;
+  QStringList m_DeferredPluginPaths;
+  mutable QMutex m_DeferredMutex;
+  bool m_RegisterFilterWidgets = true;
+  bool m_UseLoadingPreferences = true;
+  bool m_UseUserManifest = true;
+  bool m_LazyActivation = false;
+  bool m_FinishedLoading = false;
+  QMap<QString, bool> m_LoadingMap;
+  PluginLoadReport m_LoadReport;
+
+  struct AsyncLoadState;
+  std::shared_ptr<AsyncLoadState> m_AsyncLoad;
+
+  struct PendingActivation;
+  QMap<QString, std::shared_ptr<PendingActivation>> m_PendingActivations;
+
+  /**
+   * @brief preparePlugins Reads the manifests, finds the plugin files, registers the
+   * filters built into SIMPLib and the lazy proxies, and reads the loading preferences
+   * @return The plugin files that have to be opened
+   */
+  QStringList preparePlugins();
+
+  /**
+   * @brief isEnabled Returns false if the plugin was disabled in the Plugin Information dialog
+   * @param pluginName
+   * @return
+   */
+  bool isEnabled(const QString& pluginName) const;
+
+  /**
+   * @brief takeDeferredPlugin Removes the plugin from the deferred plugins
+   * @param filePath
+   * @return False if the plugin was not deferred
+   */
+  bool takeDeferredPlugin(const QString& filePath);
+
+  /**
+   * @brief activatePluginFromWorker Implements activatePlugin() for threads other than the
+   * thread of the loader
+   * @param filePath
+   * @return
+   */
+  bool activatePluginFromWorker(const QString& filePath);
+
+  /**
+   * @brief registerActivatedPlugin Registers a plugin that a worker opened and wakes up
+   * the threads that wait for it
+   * @param filePath
+   * @return
+   */
+  bool registerActivatedPlugin(const QString& filePath);
+
+  /**
+   * @brief finishLoading Writes the user manifest if anything changed
+   */
+  void finishLoading();
+
+  /**
+   * @brief registerFinishedPlugins Registers the asynchronously opened plugins that are ready
+   */
+  void registerFinishedPlugins();
+
+  /**
+   * @brief openPlugins Opens the plugin libraries concurrently and hands each one to the
+   * registration function on this thread in the order of filePaths
+   * @param filePaths
+   * @param shouldRegister Returns whether the filters of the named plugin should be registered
+   */
+  void openPlugins(const QStringList& filePaths, std::function<bool(const QString&)> shouldRegister);
+
+  /**
+   * @brief registerPlugin Adds an opened plugin to the PluginManager and, if requested,
+   * registers its filters and filter widgets and records them in the manifest. A plugin
+   * whose library failed to load is added to the load report.
+   * @param path
+   * @param pluginInstance
+   * @param registerFilters
+   * @return
+   */
+  bool registerPlugin(const QString& path, const Detail::PluginInstance& pluginInstance, bool registerFilters);
+
+  /**
+   * @brief registerProxies Registers a LazyFilterFactory for each filter of the plugin entry
+   * @param entry
+   */
+  void registerProxies(const PluginManifest::PluginEntry& entry);
+
+  SIMPLViewPluginLoader(const SIMPLViewPluginLoader&) = delete; // Copy Constructor Not Implemented
+  void operator=(const SIMPLViewPluginLoader&) = delete;        // Move assignment Not Implemented
+};
@@ -0,0 +1,479 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "SIMPLViewSettings.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTemporaryFile>
+
+#include "SVWidgetsLib/QtSupport/QtSSettings.h"
+
+#include "SIMPLView/StartupTrace.h"
+
+namespace
+{
+const int k_DefaultIdleFlushDelay = 500;
+const int k_DefaultMaxFlushDelay = 5000;
+
+// -----------------------------------------------------------------------------
+// Converts a value to the form QtSSettings writes it in
+// -----------------------------------------------------------------------------
+QJsonValue encodeValue(const QVariant& value)
+{
+  if(value.type() == QVariant::ByteArray)
+  {
+    return QString::fromLatin1(value.toByteArray().toBase64());
+  }
+  if(value.type() == QVariant::StringList)
+  {
+    return QJsonArray::fromStringList(value.toStringList());
+  }
+  return QJsonValue::fromVariant(value);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonValue findValue(const QJsonObject& contents, const QStringList& path)
+{
+  QJsonObject group = contents;
+  for(int i = 0; i < path.size() - 1; i++)
+  {
+    QJsonValue child = group.value(path[i]);
+    if(!child.isObject())
+    {
+      return QJsonValue(QJsonValue::Undefined);
+    }
+    group = child.toObject();
+  }
+  return group.value(path.last());
+}
+
+// -----------------------------------------------------------------------------
+// An undefined value removes the key
+// -----------------------------------------------------------------------------
+void replaceValue(QJsonObject& contents, const QStringList& path, const QJsonValue& value)
+{
+  if(path.size() == 1)
+  {
+    if(value.isUndefined())
+    {
+      contents.remove(path.first());
+    }
+    else
+    {
+      contents.insert(path.first(), value);
+    }
+    return;
+  }
+
+  QJsonObject group = contents.value(path.first()).toObject();
+  replaceValue(group, path.mid(1), value);
+  contents.insert(path.first(), group);
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SIMPLViewSettings::SIMPLViewSettings(QObject* parent)
+: QObject(parent)
+{
+  m_IdleTimer.setSingleShot(true);
+  m_IdleTimer.setInterval(k_DefaultIdleFlushDelay);
+  connect(&m_IdleTimer, &QTimer::timeout, this, &SIMPLViewSettings::flush);
+
+  m_MaxDelayTimer.setSingleShot(true);
+  m_MaxDelayTimer.setInterval(k_DefaultMaxFlushDelay);
+  connect(&m_MaxDelayTimer, &QTimer::timeout, this, &SIMPLViewSettings::flush);
+
+  if(QCoreApplication::instance() != nullptr)
+  {
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &SIMPLViewSettings::flushAtExit);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SIMPLViewSettings::~SIMPLViewSettings() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SIMPLViewSettings* SIMPLViewSettings::Instance()
+{
+  static SIMPLViewSettings* self = nullptr;
+  if(self == nullptr)
+  {
+    self = new SIMPLViewSettings(QCoreApplication::instance());
+  }
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString SIMPLViewSettings::GetFilePath()
+{
+  static QString filePath;
+  if(filePath.isEmpty())
+  {
+    QtSSettings prefs;
+    filePath = prefs.fileName();
+  }
+  return filePath;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject SIMPLViewSettings::ReadFile(const QString& filePath)
+{
+  QFile file(filePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return QJsonObject();
+  }
+  return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewSettings::load()
+{
+  if(m_Loaded)
+  {
+    return;
+  }
+
+  STARTUP_TRACE_SCOPE("SIMPLViewSettings Read");
+  m_FilePath = GetFilePath();
+  m_Contents = ReadFile(m_FilePath);
+  m_ContentsRevision++;
+  m_Loaded = true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewSettings::beginGroup(const QString& prefix)
+{
+  m_Groups.push_back(prefix);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewSettings::endGroup()
+{
+  if(!m_Groups.isEmpty())
+  {
+    m_Groups.pop_back();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList SIMPLViewSettings::keyPath(const QString& key) const
+{
+  return QStringList(m_Groups) << key;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLViewSettings::contains(const QString& key)
+{
+  load();
+  return !findValue(m_Contents, keyPath(key)).isUndefined();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVariant SIMPLViewSettings::value(const QString& key, const QVariant& defaultValue)
+{
+  load();
+  QJsonValue value = findValue(m_Contents, keyPath(key));
+  if(value.isUndefined())
+  {
+    return defaultValue;
+  }
+  if(defaultValue.type() == QVariant::ByteArray)
+  {
+    return QByteArray::fromBase64(value.toString().toLatin1());
+  }
+  return value.toVariant();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewSettings::setValue(const QString& key, const QVariant& value)
+{
+  load();
+  storeValue(keyPath(key), encodeValue(value));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewSettings::storeValue(const QStringList& path, const QJsonValue& value)
+{
+  m_RequestedWriteCount++;
+  if(findValue(m_Contents, path) == value)
+  {
+    return;
+  }
+
+  replaceValue(m_Contents, path, value);
+  m_ContentsRevision++;
+  PendingValue pending;
+  pending.path = path;
+  pending.value = value;
+  m_PendingValues.insert(path.join('/'), pending);
+
+  m_IdleTimer.start();
+  if(!m_MaxDelayTimer.isActive())
+  {
+    m_MaxDelayTimer.start();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewSettings::clear()
+{
+  load();
+  m_Contents = QJsonObject();
+  m_ContentsRevision++;
+  m_PendingValues.clear();
+  m_ClearPending = true;
+  m_RequestedWriteCount++;
+
+  m_IdleTimer.start();
+  if(!m_MaxDelayTimer.isActive())
+  {
+    m_MaxDelayTimer.start();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewSettings::storeChanges(const QStringList& path, const QJsonObject& before, const QJsonObject& after)
+{
+  for(QJsonObject::const_iterator iter = after.constBegin(); iter != after.constEnd(); ++iter)
+  {
+    QJsonValue previous = before.value(iter.key());
+    if(previous.isObject() && iter.value().isObject())
+    {
+      storeChanges(QStringList(path) << iter.key(), previous.toObject(), iter.value().toObject());
+    }
+    else if(previous != iter.value())
+    {
+      storeValue(QStringList(path) << iter.key(), iter.value());
+    }
+  }
+  for(QJsonObject::const_iterator iter = before.constBegin(); iter != before.constEnd(); ++iter)
+  {
+    if(!after.contains(iter.key()))
+    {
+      storeValue(QStringList(path) << iter.key(), QJsonValue(QJsonValue::Undefined));
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// QtSSettings only works on files, so the widgets get one on a scratch copy. Most
+// calls come from windows that read the same values, so the copy is reused until
+// the values change.
+// -----------------------------------------------------------------------------
+QtSSettings* SIMPLViewSettings::scratchSettings()
+{
+  load();
+  if(m_Scratch && m_ScratchRevision == m_ContentsRevision)
+  {
+    return m_Scratch.get();
+  }
+
+  m_Scratch.reset();
+  if(!m_ScratchFile)
+  {
+    m_ScratchFile.reset(new QTemporaryFile(QDir::temp().filePath("SIMPLViewSettings-XXXXXX.json")));
+  }
+  if(!m_ScratchFile->open())
+  {
+    qDebug() << "Could not create a scratch copy of the preferences";
+    m_ScratchFile.reset();
+    return nullptr;
+  }
+  m_ScratchFile->resize(0);
+  m_ScratchFile->write(QJsonDocument(m_Contents).toJson());
+  m_ScratchFile->close();
+
+  m_Scratch.reset(new QtSSettings(m_ScratchFile->fileName()));
+  m_ScratchRevision = m_ContentsRevision;
+  return m_Scratch.get();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewSettings::readWith(const std::function<void(QtSSettings*)>& reader)
+{
+  QtSSettings* scratch = scratchSettings();
+  if(scratch == nullptr)
+  {
+    return;
+  }
+  reader(scratch);
+}
+
+// -----------------------------------------------------------------------------
+// The writer changes the scratch copy, so it already holds the new values
+// afterwards and does not need to be written again
+// -----------------------------------------------------------------------------
+void SIMPLViewSettings::writeWith(const std::function<void(QtSSettings*)>& writer)
+{
+  QtSSettings* scratch = scratchSettings();
+  if(scratch == nullptr)
+  {
+    return;
+  }
+  writer(scratch);
+
+  QJsonObject before = m_Contents;
+  storeChanges(QStringList(), before, ReadFile(m_ScratchFile->fileName()));
+  m_ScratchRevision = m_ContentsRevision;
+}
+
+// -----------------------------------------------------------------------------
+// The pending values are applied to what is in the file now, which a widget from
+// SVWidgetsLib may have written to directly, and the result replaces the file in a
+// single atomic write.
+// -----------------------------------------------------------------------------
+bool SIMPLViewSettings::flush()
+{
+  m_IdleTimer.stop();
+  m_MaxDelayTimer.stop();
+  if(m_PendingValues.isEmpty() && !m_ClearPending)
+  {
+    return true;
+  }
+
+  QJsonObject contents = m_ClearPending ? QJsonObject() : ReadFile(m_FilePath);
+  foreach(const PendingValue& pending, m_PendingValues)
+  {
+    replaceValue(contents, pending.path, pending.value);
+  }
+
+  QDir().mkpath(QFileInfo(m_FilePath).absolutePath());
+  QSaveFile file(m_FilePath);
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    qDebug() << "Could not write the preferences file" << m_FilePath;
+    return false;
+  }
+  file.write(QJsonDocument(contents).toJson());
+  if(!file.commit())
+  {
+    qDebug() << "Could not write the preferences file" << m_FilePath;
+    return false;
+  }
+
+  if(contents != m_Contents)
+  {
+    m_Contents = contents;
+    m_ContentsRevision++;
+  }
+  m_PendingValues.clear();
+  m_ClearPending = false;
+  m_PhysicalWriteCount++;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewSettings::flushAtExit()
+{
+  flush();
+  qDebug() << "Preferences:" << m_RequestedWriteCount << "writes requested," << m_PhysicalWriteCount << "written to the file," << getSavedWriteCount() << "saved";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewSettings::setFlushDelays(int idleMsec, int maxMsec)
+{
+  m_IdleTimer.setInterval(idleMsec);
+  m_MaxDelayTimer.setInterval(maxMsec);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int SIMPLViewSettings::getRequestedWriteCount() const
+{
+  return m_RequestedWriteCount;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int SIMPLViewSettings::getPhysicalWriteCount() const
+{
+  return m_PhysicalWriteCount;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int SIMPLViewSettings::getSavedWriteCount() const
+{
+  return m_RequestedWriteCount - m_PhysicalWriteCount;
+}
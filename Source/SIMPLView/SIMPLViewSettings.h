@@ -0,0 +1,247 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+#include <QtCore/QVariant>
+
+class QTemporaryFile;
+class QtSSettings;
+
+/**
+ * @brief The SIMPLViewSettings class is the one in-memory view of the preferences file that
+ * the SIMPLView application and its windows read from and write to. Values are read from
+ * the file once. Writes are kept in memory and written back together: after the writes have
+ * stopped for a short time, at the latest a few seconds after the first of them, and when the
+ * application quits. The preferences file is replaced atomically so that a crash during a
+ * write cannot leave a truncated file behind.
+ *
+ * The widgets from SVWidgetsLib only take a QtSSettings, which only works on a file. readWith()
+ * and writeWith() hand them one on a scratch copy of the values in memory. The copy is kept and
+ * only written again after the values have changed, so most calls do not touch the disk. What a
+ * widget writes becomes a pending value like any other. Values are stored the way QtSSettings
+ * stores them, so both read the same file.
+ */
+class SIMPLViewSettings : public QObject
+{
+  Q_OBJECT
+
+public:
+  ~SIMPLViewSettings() override;
+
+  /**
+   * @brief Instance
+   * @return
+   */
+  static SIMPLViewSettings* Instance();
+
+  /**
+   * @brief GetFilePath Returns the path of the preferences file
+   * @return
+   */
+  static QString GetFilePath();
+
+  /**
+   * @brief ReadFile Parses a preferences file. May be called from any thread.
+   * @param filePath
+   * @return An empty object if the file does not exist or cannot be parsed
+   */
+  static QJsonObject ReadFile(const QString& filePath);
+
+  /**
+   * @brief beginGroup Works like QtSSettings::beginGroup
+   * @param prefix
+   */
+  void beginGroup(const QString& prefix);
+
+  /**
+   * @brief endGroup Works like QtSSettings::endGroup
+   */
+  void endGroup();
+
+  /**
+   * @brief contains
+   * @param key
+   * @return
+   */
+  bool contains(const QString& key);
+
+  /**
+   * @brief value Returns the value for the key in the current group. Pass a QByteArray as
+   * the default value to read a QByteArray.
+   * @param key
+   * @param defaultValue
+   * @return
+   */
+  QVariant value(const QString& key, const QVariant& defaultValue = QVariant());
+
+  /**
+   * @brief setValue Stores the value in memory and schedules a flush
+   * @param key
+   * @param value
+   */
+  void setValue(const QString& key, const QVariant& value);
+
+  /**
+   * @brief clear Removes every value, including the ones in the file, and schedules a flush
+   */
+  void clear();
+
+  /**
+   * @brief readWith Passes a QtSSettings that holds the current values, pending ones included,
+   * to a widget that reads its settings from it. The groups of this object do not apply.
+   * @param reader
+   */
+  void readWith(const std::function<void(QtSSettings*)>& reader);
+
+  /**
+   * @brief writeWith Like readWith(), and every value the writer changes is stored as with
+   * setValue()
+   * @param writer
+   */
+  void writeWith(const std::function<void(QtSSettings*)>& writer);
+
+  /**
+   * @brief flush Writes every pending value to the preferences file now
+   * @return
+   */
+  bool flush();
+
+  /**
+   * @brief setFlushDelays Sets how long after the last write, and at most after the first
+   * unflushed write, the pending values are written
+   * @param idleMsec
+   * @param maxMsec
+   */
+  void setFlushDelays(int idleMsec, int maxMsec);
+
+  /**
+   * @brief getRequestedWriteCount Returns how many times a value was written
+   * @return
+   */
+  int getRequestedWriteCount() const;
+
+  /**
+   * @brief getPhysicalWriteCount Returns how many times the preferences file was written
+   * @return
+   */
+  int getPhysicalWriteCount() const;
+
+  /**
+   * @brief getSavedWriteCount Returns how many writes of the preferences file were saved
+   * by coalescing
+   * @return
+   */
+  int getSavedWriteCount() const;
+
+protected:
+  SIMPLViewSettings(QObject* parent = nullptr);
+
+private:
+  struct PendingValue
+  {
+    QStringList path;
+    QJsonValue value;
+  };
+
+  QString m_FilePath;
+  bool m_Loaded = false;
+  QJsonObject m_Contents;
+  QStringList m_Groups;
+  QMap<QString, PendingValue> m_PendingValues;
+  bool m_ClearPending = false;
+  QTimer m_IdleTimer;
+  QTimer m_MaxDelayTimer;
+  int m_RequestedWriteCount = 0;
+  int m_PhysicalWriteCount = 0;
+  int m_ContentsRevision = 0;
+  int m_ScratchRevision = -1;
+  std::unique_ptr<QTemporaryFile> m_ScratchFile;
+  std::unique_ptr<QtSSettings> m_Scratch;
+
+  /**
+   * @brief load Reads the preferences file unless it has been read
+   */
+  void load();
+
+  /**
+   * @brief keyPath Returns the key prefixed with the current groups
+   * @param key
+   * @return
+   */
+  QStringList keyPath(const QString& key) const;
+
+  /**
+   * @brief storeValue Stores a value that is already in the form of the file and schedules
+   * a flush. An undefined value removes the key.
+   * @param path
+   * @param value
+   */
+  void storeValue(const QStringList& path, const QJsonValue& value);
+
+  /**
+   * @brief storeChanges Stores every value that differs between two versions of a group
+   * @param path
+   * @param before
+   * @param after
+   */
+  void storeChanges(const QStringList& path, const QJsonObject& before, const QJsonObject& after);
+
+  /**
+   * @brief scratchSettings Returns the QtSSettings on the scratch copy, writing the copy
+   * again only if the values have changed since it was last written
+   * @return Null if the scratch copy could not be written
+   */
+  QtSSettings* scratchSettings();
+
+  /**
+   * @brief flushAtExit Flushes the pending values and logs how many writes of the
+   * preferences file were saved by coalescing
+   */
+  void flushAtExit();
+
+  SIMPLViewSettings(const SIMPLViewSettings&) = delete; // Copy Constructor Not Implemented
+  void operator=(const SIMPLViewSettings&) = delete;    // Move assignment Not Implemented
+};
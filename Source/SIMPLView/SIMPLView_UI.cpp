@@ -46,12 +46,14 @@
 #include <QtCore/QProcess>
 #include <QtCore/QString>
 #include <QtCore/QThread>
+#include <QtCore/QTimer>
 #include <QtCore/QUrl>
 #include <QtGui/QClipboard>
 #include <QtGui/QCloseEvent>
 #include <QtGui/QDesktopServices>
 #include <QtWidgets/QCheckBox>
 #include <QtWidgets/QFileDialog>
+#include <QtWidgets/QLabel>
 #include <QtWidgets/QListWidget>
 #include <QtWidgets/QScrollBar>
 #include <QtWidgets/QShortcut>
@@ -100,10 +102,13 @@
 #endif
 
 #include "SIMPLView/AboutSIMPLView.h"
+#include "SIMPLView/FilterProfileOverlay.h"
 #include "SIMPLView/SIMPLView.h"
 #include "SIMPLView/SIMPLViewApplication.h"
 #include "SIMPLView/SIMPLViewConstants.h"
 #include "SIMPLView/SIMPLViewVersion.h"
+#include "SIMPLView/SIMPLViewSettings.h"
+#include "SIMPLView/StartupTrace.h"
 
 #include "BrandedStrings.h"
 
@@ -117,18 +122,30 @@ SIMPLView_UI::SIMPLView_UI(QWidget* parent)
 , m_FilterWidgetManager(nullptr)
 , m_LastOpenedFilePath(QDir::homePath())
 {
+  STARTUP_TRACE_SCOPE("SIMPLView_UI Constructor");
+
   // Register all of the Filters we know about - the rest will be loaded through plugins
   //  which all should have been loaded by now.
   m_FilterManager = FilterManager::Instance();
   // m_FilterManager->RegisterKnownFilters(m_FilterManager);
 
-  // Register all the known filterWidgets
+  // Register all the known filterWidgets. The FilterWidgetManager is shared by every
+  // window so this only needs to happen for the first one.
   m_FilterWidgetManager = FilterWidgetManager::Instance();
-  m_FilterWidgetManager->RegisterKnownFilterWidgets();
+  static bool filterWidgetsRegistered = false;
+  if(!filterWidgetsRegistered)
+  {
+    STARTUP_TRACE_SCOPE("RegisterKnownFilterWidgets");
+    m_FilterWidgetManager->RegisterKnownFilterWidgets();
+    filterWidgetsRegistered = true;
+  }
 
   // Calls the Parent Class to do all the Widget Initialization that were created
   // using the QDesigner program
-  m_Ui->setupUi(this);
+  {
+    STARTUP_TRACE_SCOPE("setupUi");
+    m_Ui->setupUi(this);
+  }
 
   dream3dApp->registerSIMPLViewWindow(this);
 
@@ -157,7 +174,11 @@ SIMPLView_UI::SIMPLView_UI(QWidget* parent)
 // -----------------------------------------------------------------------------
 SIMPLView_UI::~SIMPLView_UI()
 {
-  writeSettings();
+  // A window that was never shown would overwrite the settings of the real ones
+  if(!m_Pooled)
+  {
+    writeSettings();
+  }
 
   dream3dApp->unregisterSIMPLViewWindow(this);
 
@@ -176,9 +197,9 @@ void SIMPLView_UI::resizeEvent(QResizeEvent* event)
 
   emit parentResized();
 
-  // We need to write the window settings so that any new windows will open with these window settings
-  QSharedPointer<QtSSettings> prefs = QSharedPointer<QtSSettings>(new QtSSettings());
-  writeWindowSettings(prefs.data());
+  // We need to write the window settings so that any new windows will open with these window settings.
+  // A drag resize sends many of these events, so the settings store coalesces the writes.
+  writeWindowSettings(SIMPLViewSettings::Instance());
 }
 
 // -----------------------------------------------------------------------------
@@ -356,53 +377,92 @@ void SIMPLView_UI::closeEvent(QCloseEvent* event)
 // -----------------------------------------------------------------------------
 void SIMPLView_UI::readSettings()
 {
-  QSharedPointer<QtSSettings> prefs = QSharedPointer<QtSSettings>(new QtSSettings());
+  STARTUP_TRACE_SCOPE("SIMPLView_UI::readSettings");
+
+  SIMPLViewSettings* settings = SIMPLViewSettings::Instance();
 
   // Have the pipeline builder read its settings from the prefs file
-  readWindowSettings(prefs.data());
-  readVersionSettings(prefs.data());
+  readWindowSettings(settings);
+  readVersionSettings(settings);
 
   // Read dock widget settings
-  prefs->beginGroup(SIMPLView::DockWidgetSettings::GroupName);
+  settings->beginGroup(SIMPLView::DockWidgetSettings::GroupName);
 
-  prefs->beginGroup(SIMPLView::DockWidgetSettings::IssuesDockGroupName);
-  readDockWidgetSettings(prefs.data(), m_Ui->issuesDockWidget);
-  prefs->endGroup();
+  settings->beginGroup(SIMPLView::DockWidgetSettings::IssuesDockGroupName);
+  readDockWidgetSettings(settings, m_Ui->issuesDockWidget);
+  settings->endGroup();
 
-  prefs->beginGroup(SIMPLView::DockWidgetSettings::StandardOutputGroupName);
-  readDockWidgetSettings(prefs.data(), m_Ui->stdOutDockWidget);
-  prefs->endGroup();
+  settings->beginGroup(SIMPLView::DockWidgetSettings::StandardOutputGroupName);
+  readDockWidgetSettings(settings, m_Ui->stdOutDockWidget);
+  settings->endGroup();
 
-  prefs->endGroup();
+  settings->endGroup();
 
-  prefs->beginGroup("ToolboxSettings");
+  // The toolbox widgets only take a QtSSettings
+  settings->readWith([this](QtSSettings* prefs) {
+    // The bookmarks are read after the first window has been painted
+    if(dream3dApp->areBookmarksLoaded())
+    {
+      readBookmarksSettings(prefs);
+    }
 
-  // Read dock widget settings
-  prefs->beginGroup("Bookmarks Widget");
-  m_Ui->bookmarksWidget->readSettings(prefs.data());
-  prefs->endGroup();
+    prefs->beginGroup("ToolboxSettings");
 
-  prefs->beginGroup("Filter List Widget");
-  m_Ui->filterListWidget->readSettings(prefs.data());
-  prefs->endGroup();
+    prefs->beginGroup("Filter List Widget");
+    m_Ui->filterListWidget->readSettings(prefs);
+    prefs->endGroup();
 
-  prefs->beginGroup("Filter Library Widget");
-  m_Ui->filterLibraryWidget->readSettings(prefs.data());
-  prefs->endGroup();
+    prefs->beginGroup("Filter Library Widget");
+    m_Ui->filterLibraryWidget->readSettings(prefs);
+    prefs->endGroup();
+
+    prefs->endGroup();
+  });
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::setPooled(bool pooled)
+{
+  if(m_Pooled && !pooled)
+  {
+    // The window settings may have changed since this window was built
+    readWindowSettings(SIMPLViewSettings::Instance());
+  }
+  m_Pooled = pooled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLView_UI::isPooled() const
+{
+  return m_Pooled;
+}
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::readBookmarksSettings(QtSSettings* prefs)
+{
+  prefs->beginGroup("ToolboxSettings");
+  prefs->beginGroup("Bookmarks Widget");
+  m_Ui->bookmarksWidget->readSettings(prefs);
+  prefs->endGroup();
   prefs->endGroup();
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void SIMPLView_UI::readWindowSettings(QtSSettings* prefs)
+void SIMPLView_UI::readWindowSettings(SIMPLViewSettings* prefs)
 {
   bool ok = false;
   prefs->beginGroup("WindowSettings");
   if(prefs->contains(QString("MainWindowGeometry")))
   {
-    QByteArray geo_data = prefs->value("MainWindowGeometry", QByteArray());
+    QByteArray geo_data = prefs->value("MainWindowGeometry", QByteArray()).toByteArray();
     ok = restoreGeometry(geo_data);
     if(!ok)
     {
@@ -413,7 +473,7 @@ void SIMPLView_UI::readWindowSettings(QtSSettings* prefs)
 
   if(prefs->contains(QString("MainWindowState")))
   {
-    QByteArray layout_data = prefs->value("MainWindowState", QByteArray());
+    QByteArray layout_data = prefs->value("MainWindowState", QByteArray()).toByteArray();
     restoreState(layout_data);
   }
 
@@ -423,7 +483,7 @@ void SIMPLView_UI::readWindowSettings(QtSSettings* prefs)
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void SIMPLView_UI::readDockWidgetSettings(QtSSettings* prefs, QDockWidget* dw)
+void SIMPLView_UI::readDockWidgetSettings(SIMPLViewSettings* prefs, QDockWidget* dw)
 {
   restoreDockWidget(dw);
 
@@ -435,7 +495,7 @@ void SIMPLView_UI::readDockWidgetSettings(QtSSettings* prefs, QDockWidget* dw)
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void SIMPLView_UI::readVersionSettings(QtSSettings* prefs)
+void SIMPLView_UI::readVersionSettings(SIMPLViewSettings* prefs)
 {
 }
 
@@ -444,23 +504,23 @@ void SIMPLView_UI::readVersionSettings(QtSSettings* prefs)
 // -----------------------------------------------------------------------------
 void SIMPLView_UI::writeSettings()
 {
-  QSharedPointer<QtSSettings> prefs = QSharedPointer<QtSSettings>(new QtSSettings());
+  SIMPLViewSettings* prefs = SIMPLViewSettings::Instance();
 
   // Have the pipeline builder write its settings to the prefs file
-  writeWindowSettings(prefs.data());
+  writeWindowSettings(prefs);
   // Have the version check widet write its preferences.
-  writeVersionCheckSettings(prefs.data());
+  writeVersionCheckSettings(prefs);
 
   prefs->beginGroup("DockWidgetSettings");
 
   prefs->beginGroup("Issues Dock Widget");
-  writeDockWidgetSettings(prefs.data(), m_Ui->issuesDockWidget);
-  //writeHideDockSettings(prefs.data(), m_HideErrorTable);
+  writeDockWidgetSettings(prefs, m_Ui->issuesDockWidget);
+  //writeHideDockSettings(prefs, m_HideErrorTable);
   prefs->endGroup();
 
   prefs->beginGroup("Standard Output Dock Widget");
-  writeDockWidgetSettings(prefs.data(), m_Ui->stdOutDockWidget);
-  //writeHideDockSettings(prefs.data(), m_HideStdOutput);
+  writeDockWidgetSettings(prefs, m_Ui->stdOutDockWidget);
+  //writeHideDockSettings(prefs, m_HideStdOutput);
   prefs->endGroup();
 
   prefs->endGroup();
@@ -469,14 +529,14 @@ void SIMPLView_UI::writeSettings()
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void SIMPLView_UI::writeVersionCheckSettings(QtSSettings* prefs)
+void SIMPLView_UI::writeVersionCheckSettings(SIMPLViewSettings* prefs)
 {
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void SIMPLView_UI::writeWindowSettings(QtSSettings* prefs)
+void SIMPLView_UI::writeWindowSettings(SIMPLViewSettings* prefs)
 {
   prefs->beginGroup("WindowSettings");
   QByteArray geo_data = saveGeometry();
@@ -490,7 +550,7 @@ void SIMPLView_UI::writeWindowSettings(QtSSettings* prefs)
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void SIMPLView_UI::writeDockWidgetSettings(QtSSettings* prefs, QDockWidget* dw)
+void SIMPLView_UI::writeDockWidgetSettings(SIMPLViewSettings* prefs, QDockWidget* dw)
 {
   prefs->setValue(dw->objectName(), dw->isHidden());
 }
@@ -500,6 +560,8 @@ void SIMPLView_UI::writeDockWidgetSettings(QtSSettings* prefs, QDockWidget* dw)
 // -----------------------------------------------------------------------------
 void SIMPLView_UI::setupGui()
 {
+  STARTUP_TRACE_SCOPE("SIMPLView_UI::setupGui");
+
   SVPipelineView* viewWidget = m_Ui->pipelineListWidget->getPipelineView();
 
   PipelineItemDelegate* delegate = new PipelineItemDelegate(viewWidget);
@@ -511,6 +573,16 @@ void SIMPLView_UI::setupGui()
 
   viewWidget->setModel(model);
 
+  m_ProfileOverlay = new FilterProfileOverlay(viewWidget);
+
+  // The expected time left of a running pipeline, from the PerformanceHistory
+  m_EtaLabel = new QLabel(this);
+  m_EtaLabel->hide();
+  statusBar()->addPermanentWidget(m_EtaLabel);
+  m_EtaTimer = new QTimer(this);
+  m_EtaTimer->setInterval(1000);
+  connect(m_EtaTimer, &QTimer::timeout, this, &SIMPLView_UI::updateEta);
+
   // Set the IssuesWidget as a PipelineMessageObserver Object.
   viewWidget->addPipelineMessageObserver(m_Ui->issuesWidget);
 
@@ -583,6 +655,13 @@ void SIMPLView_UI::createSIMPLViewMenuSystem()
   m_ActionCheckForUpdates = new QAction("Check For Updates", this);
   m_ActionPluginInformation = new QAction("Plugin Information", this);
   m_ActionClearCache = new QAction("Clear Cache", this);
+  m_ActionShowFilterProfile = new QAction("Show Filter Profile", this);
+  m_ActionShowFilterProfile->setCheckable(true);
+  m_ActionShowFilterProfile->setChecked(true);
+  m_ActionExportProfileTrace = new QAction("Export Filter Profile as Trace...", this);
+  m_ActionExportProfileTrace->setEnabled(false);
+  m_ActionExportProfileCsv = new QAction("Export Filter Profile as CSV...", this);
+  m_ActionExportProfileCsv->setEnabled(false);
 
   // SIMPLView_UI Actions
   connect(m_ActionNew, &QAction::triggered, dream3dApp, &SIMPLViewApplication::listenNewInstanceTriggered);
@@ -596,6 +675,9 @@ void SIMPLView_UI::createSIMPLViewMenuSystem()
   connect(m_ActionShowSIMPLViewHelp, &QAction::triggered, dream3dApp, &SIMPLViewApplication::listenShowSIMPLViewHelpTriggered);
   connect(m_ActionPluginInformation, &QAction::triggered, dream3dApp, &SIMPLViewApplication::listenDisplayPluginInfoDialogTriggered);
   connect(m_ActionClearCache, &QAction::triggered, dream3dApp, &SIMPLViewApplication::listenClearSIMPLViewCacheTriggered);
+  connect(m_ActionShowFilterProfile, &QAction::toggled, m_ProfileOverlay, &FilterProfileOverlay::setVisible);
+  connect(m_ActionExportProfileTrace, &QAction::triggered, [=] { exportFilterProfile(true); });
+  connect(m_ActionExportProfileCsv, &QAction::triggered, [=] { exportFilterProfile(false); });
 
   m_ActionNew->setShortcut(QKeySequence::New);
   m_ActionOpen->setShortcut(QKeySequence::Open);
@@ -673,6 +755,10 @@ void SIMPLView_UI::createSIMPLViewMenuSystem()
   // Create Pipeline Menu
   m_SIMPLViewMenu->addMenu(m_MenuPipeline);
   m_MenuPipeline->addAction(actionClearPipeline);
+  m_MenuPipeline->addSeparator();
+  m_MenuPipeline->addAction(m_ActionShowFilterProfile);
+  m_MenuPipeline->addAction(m_ActionExportProfileTrace);
+  m_MenuPipeline->addAction(m_ActionExportProfileCsv);
 
   // Create Help Menu
   m_SIMPLViewMenu->addMenu(m_MenuHelp);
@@ -737,6 +823,7 @@ void SIMPLView_UI::connectSignalsSlots()
 
   /* Pipeline List Widget Connections */
   connect(m_Ui->pipelineListWidget, &PipelineListWidget::pipelineCanceled, pipelineView, &SVPipelineView::cancelPipeline);
+  connect(m_Ui->pipelineListWidget, &PipelineListWidget::pipelineCanceled, [=] { m_RunCanceled = true; });
 
   /* Pipeline View Connections */
   connect(pipelineView->selectionModel(), &QItemSelectionModel::selectionChanged, this, &SIMPLView_UI::filterSelectionChanged);
@@ -752,6 +839,7 @@ void SIMPLView_UI::connectSignalsSlots()
 
   // Connection that displays issues in the Issue Table when the preflight is finished
   connect(pipelineView, &SVPipelineView::preflightFinished, [=](FilterPipeline::Pointer pipeline, int err) {
+    m_PreflightPipeline = pipeline;
     m_Ui->dataBrowserWidget->refreshData();
     m_Ui->issuesWidget->displayCachedMessages();
     m_Ui->pipelineListWidget->preflightFinished(pipeline, err);
@@ -854,6 +942,15 @@ void SIMPLView_UI::setLoadedPlugins(QVector<ISIMPLibPlugin*> plugins)
   m_LoadedPlugins = plugins;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::refreshFilterToolboxes()
+{
+  m_Ui->filterLibraryWidget->refreshFilterGroups();
+  m_Ui->filterListWidget->loadFilterList();
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -900,6 +997,17 @@ void SIMPLView_UI::populateMenus(QObject* plugin)
 // -----------------------------------------------------------------------------
 void SIMPLView_UI::processPipelineMessage(const PipelineMessage& msg)
 {
+  bool started = !m_Profiler.isRunning();
+  m_Profiler.processPipelineMessage(msg);
+  if(started && m_Profiler.isRunning())
+  {
+    startHistoryRun();
+  }
+  if(msg.getType() == PipelineMessage::MessageType::Error)
+  {
+    m_RunHasErrors = true;
+  }
+
   if(msg.getType() == PipelineMessage::MessageType::ProgressValue)
   {
     float progValue = static_cast<float>(msg.getProgressValue()) / 100;
@@ -972,6 +1080,107 @@ void SIMPLView_UI::pipelineDidFinish()
   }
 
   m_Ui->pipelineListWidget->pipelineFinished();
+
+  m_Profiler.finish();
+  QVector<FilterProfiler::Record> records = m_Profiler.getRecords();
+  m_ProfileOverlay->setRecords(records);
+  m_ActionExportProfileTrace->setEnabled(!records.isEmpty());
+  m_ActionExportProfileCsv->setEnabled(!records.isEmpty());
+  finishHistoryRun(records);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::startHistoryRun()
+{
+  m_RunHasErrors = false;
+  m_RunCanceled = false;
+  m_HistoryRun = PerformanceHistory::DescribeRun(m_PreflightPipeline, windowFilePath());
+  m_HistoryEstimates = PerformanceHistory::Instance()->estimateFilters(m_HistoryRun);
+  m_EtaTimer->start();
+  updateEta();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::updateEta()
+{
+  int current = m_Profiler.getCurrentIndex();
+  if(current < 0 || current >= m_HistoryEstimates.size())
+  {
+    m_EtaLabel->hide();
+    return;
+  }
+
+  // Without a history for every filter that is left there is no estimate worth showing
+  qint64 remainingUs = 0;
+  for(int i = current; i < m_HistoryEstimates.size(); i++)
+  {
+    if(m_HistoryEstimates[i] < 0)
+    {
+      m_EtaLabel->hide();
+      return;
+    }
+    remainingUs += (i == current) ? qMax<qint64>(0, m_HistoryEstimates[i] - m_Profiler.getCurrentElapsedUs()) : m_HistoryEstimates[i];
+  }
+
+  qint64 seconds = remainingUs / 1000000 + 1;
+  QString text = (seconds < 60) ? QString("%1 s").arg(seconds) : QString("%1 min %2 s").arg(seconds / 60).arg(seconds % 60);
+  m_EtaLabel->setText(tr("About %1 left").arg(text));
+  m_EtaLabel->show();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::finishHistoryRun(const QVector<FilterProfiler::Record>& records)
+{
+  m_EtaTimer->stop();
+  m_EtaLabel->hide();
+
+  // A canceled run says nothing about how long the filters take
+  if(records.isEmpty() || m_HistoryRun.filters.isEmpty() || m_RunCanceled)
+  {
+    m_HistoryRun = PerformanceHistory::Run();
+    return;
+  }
+
+  PerformanceHistory* history = PerformanceHistory::Instance();
+  PerformanceHistory::AddProfile(m_HistoryRun, records);
+  m_HistoryRun.elapsedMs = (records.last().startUs + records.last().wallUs) / 1000;
+  m_HistoryRun.errorCode = m_RunHasErrors ? -1 : 0;
+
+  foreach(QString warning, history->findSlowFilters(m_HistoryRun, m_HistoryEstimates))
+  {
+    m_Ui->stdOutWidget->appendText("<span style=\" color:#c86400;\" >" + warning.toHtmlEscaped() + "</span>");
+    statusBar()->showMessage(warning);
+  }
+  history->append(m_HistoryRun);
+  m_HistoryRun = PerformanceHistory::Run();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::exportFilterProfile(bool chromeTrace)
+{
+  QString pipelineName = windowFilePath().isEmpty() ? QString("Untitled") : QFileInfo(windowFilePath()).completeBaseName();
+  QString proposedFile = m_LastOpenedFilePath + QDir::separator() + pipelineName + (chromeTrace ? ".trace.json" : ".csv");
+  QString filter = chromeTrace ? tr("Chrome Trace (*.json);;All Files (*.*)") : tr("CSV File (*.csv);;All Files (*.*)");
+  QString filePath = QFileDialog::getSaveFileName(this, tr("Export Filter Profile"), proposedFile, filter);
+  if(filePath.isEmpty())
+  {
+    return;
+  }
+
+  QVector<FilterProfiler::Record> records = m_Profiler.getRecords();
+  bool written = chromeTrace ? FilterProfiler::WriteChromeTrace(filePath, records, pipelineName) : FilterProfiler::WriteCsv(filePath, records);
+  if(!written)
+  {
+    QMessageBox::warning(this, BrandedStrings::ApplicationName, tr("The filter profile could not be written to %1").arg(QDir::toNativeSeparators(filePath)));
+  }
 }
 
 // -----------------------------------------------------------------------------
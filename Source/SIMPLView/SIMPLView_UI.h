@@ -57,6 +57,9 @@
 #include "SVWidgetsLib/Widgets/FilterInputWidget.h"
 #include "SVWidgetsLib/QtSupport/QtSSettings.h"
 
+#include "SIMPLView/FilterProfiler.h"
+#include "SIMPLView/PerformanceHistory.h"
+
 //-- UIC generated Header
 #include "ui_SIMPLView_UI.h"
 
@@ -76,6 +79,10 @@ class PipelineModel;
 class PipelineListWidget;
 class SVPipelineViewWidget;
 class SIMPLViewMenuItems;
+class SIMPLViewSettings;
+class FilterProfileOverlay;
+class QLabel;
+class QTimer;
 
 /**
 * @class SIMPLView_UI SIMPLView_UI Applications/SIMPLView/SIMPLView_UI.h
@@ -101,6 +108,32 @@ class SIMPLView_UI : public QMainWindow
      */
     void setLoadedPlugins(QVector<ISIMPLibPlugin*> plugins);
 
+    /**
+     * @brief refreshFilterToolboxes Reloads the Filter List and Filter Library from the
+     * FilterManager. This is called when plugins finish registering after the window was built.
+     */
+    void refreshFilterToolboxes();
+
+    /**
+     * @brief readBookmarksSettings Reads the bookmarks from the prefs file. The first window
+     * does this after it has been painted.
+     * @param prefs
+     */
+    void readBookmarksSettings(QtSSettings* prefs);
+
+    /**
+     * @brief setPooled Marks this window as a hidden, pre-built window that is waiting to be
+     * handed out. A pooled window does not write its settings.
+     * @param pooled
+     */
+    void setPooled(bool pooled);
+
+    /**
+     * @brief isPooled
+     * @return
+     */
+    bool isPooled() const;
+
     /**
      * @brief getDataStructureWidget
      * @return
@@ -203,11 +236,11 @@ class SIMPLView_UI : public QMainWindow
      *
      * @param prefs
      */
-    void writeWindowSettings(QtSSettings* prefs);
-    void writeVersionCheckSettings(QtSSettings* prefs);
+    void writeWindowSettings(SIMPLViewSettings* prefs);
+    void writeVersionCheckSettings(SIMPLViewSettings* prefs);
 
-    void readWindowSettings(QtSSettings* prefs);
-    void readVersionSettings(QtSSettings* prefs);
+    void readWindowSettings(SIMPLViewSettings* prefs);
+    void readVersionSettings(SIMPLViewSettings* prefs);
 
     /**
      * @brief Initializes some of the GUI elements with selections or other GUI related items
@@ -219,14 +252,14 @@ class SIMPLView_UI : public QMainWindow
      * @param prefs
      * @param dw
      */
-    void readDockWidgetSettings(QtSSettings* prefs, QDockWidget* dw);
+    void readDockWidgetSettings(SIMPLViewSettings* prefs, QDockWidget* dw);
 
     /**
      * @brief writeDockWidgetSettings
      * @param prefs
      * @param dw
      */
-    void writeDockWidgetSettings(QtSSettings* prefs, QDockWidget* dw);
+    void writeDockWidgetSettings(SIMPLViewSettings* prefs, QDockWidget* dw);
 
     /**
      * @brief Checks the currently open file for changes that need to be saved
@@ -309,6 +342,7 @@ class SIMPLView_UI : public QMainWindow
 //    StatusBarWidget*                        m_StatusBar = nullptr;
 
     QString                                 m_LastOpenedFilePath;
+    bool                                    m_Pooled = false;
 
     FilterInputWidget*                      m_FilterInputWidget = nullptr;
 
@@ -340,11 +374,47 @@ class SIMPLView_UI : public QMainWindow
 
     QActionGroup*                           m_ThemeActionGroup = nullptr;
 
+    FilterProfiler                          m_Profiler;
+    FilterProfileOverlay*                   m_ProfileOverlay = nullptr;
+    QAction*                                m_ActionShowFilterProfile = nullptr;
+    QAction*                                m_ActionExportProfileTrace = nullptr;
+    QAction*                                m_ActionExportProfileCsv = nullptr;
+    FilterPipeline::Pointer                 m_PreflightPipeline;
+    PerformanceHistory::Run                 m_HistoryRun;
+    QVector<qint64>                         m_HistoryEstimates;
+    bool                                    m_RunHasErrors = false;
+    bool                                    m_RunCanceled = false;
+    QLabel*                                 m_EtaLabel = nullptr;
+    QTimer*                                 m_EtaTimer = nullptr;
+
     /**
      * @brief createSIMPLViewMenu
      */
     void createSIMPLViewMenuSystem();
 
+    /**
+     * @brief exportFilterProfile Asks for a file and writes the filter profile of the last run
+     * @param chromeTrace Writes a Chrome trace if true and a CSV file otherwise
+     */
+    void exportFilterProfile(bool chromeTrace);
+
+    /**
+     * @brief startHistoryRun Looks up the expected filter timings of the run that just started
+     */
+    void startHistoryRun();
+
+    /**
+     * @brief updateEta Shows how much longer the running pipeline is expected to take
+     */
+    void updateEta();
+
+    /**
+     * @brief finishHistoryRun Reports the filters that ran much slower than usual and adds the
+     * timings of the run to the PerformanceHistory, unless the run was canceled
+     * @param records
+     */
+    void finishHistoryRun(const QVector<FilterProfiler::Record>& records);
+
     /**
      * @brief savePipeline
      * @return
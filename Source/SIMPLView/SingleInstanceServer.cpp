@@ -0,0 +1,158 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "SingleInstanceServer.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <QtNetwork/QLocalSocket>
+
+#include "BrandedStrings.h"
+
+namespace
+{
+const int k_ForwardTimeout = 1000;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SingleInstanceServer::SingleInstanceServer(QObject* parent)
+: QObject(parent)
+{
+  m_Server.setSocketOptions(QLocalServer::UserAccessOption);
+  connect(&m_Server, &QLocalServer::newConnection, this, &SingleInstanceServer::acceptConnections);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SingleInstanceServer::~SingleInstanceServer()
+{
+  m_Server.close();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString SingleInstanceServer::GetServerName()
+{
+  QString userName = QString::fromLocal8Bit(qgetenv("USER"));
+  if(userName.isEmpty())
+  {
+    userName = QString::fromLocal8Bit(qgetenv("USERNAME"));
+  }
+  return BrandedStrings::ApplicationName + "-Instance-" + userName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SingleInstanceServer::ForwardToRunningInstance(const QStringList& filePaths)
+{
+  // Connecting fails right away when nothing is listening, so a normal launch
+  // pays next to nothing for the check
+  QLocalSocket socket;
+  socket.connectToServer(GetServerName());
+  if(!socket.waitForConnected(k_ForwardTimeout))
+  {
+    return false;
+  }
+
+  QJsonObject request;
+  request["files"] = QJsonArray::fromStringList(filePaths);
+  socket.write(QJsonDocument(request).toJson(QJsonDocument::Compact) + "\n");
+  socket.flush();
+
+  // An instance that hangs must not swallow the files
+  while(!socket.canReadLine())
+  {
+    if(!socket.waitForReadyRead(k_ForwardTimeout))
+    {
+      return false;
+    }
+  }
+  return socket.readLine().trimmed() == "ok";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SingleInstanceServer::listen()
+{
+  // Nothing answered ForwardToRunningInstance(), so a socket that is still there was
+  // left behind by an instance that crashed
+  QLocalServer::removeServer(GetServerName());
+  if(!m_Server.listen(GetServerName()))
+  {
+    qDebug() << "Could not listen for forwarded files:" << m_Server.errorString();
+    return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SingleInstanceServer::acceptConnections()
+{
+  while(m_Server.hasPendingConnections())
+  {
+    QLocalSocket* socket = m_Server.nextPendingConnection();
+    connect(socket, &QLocalSocket::disconnected, socket, &QLocalSocket::deleteLater);
+    connect(socket, &QLocalSocket::readyRead, this, [this, socket] {
+      if(!socket->canReadLine())
+      {
+        return;
+      }
+
+      QJsonObject request = QJsonDocument::fromJson(socket->readLine()).object();
+      QStringList filePaths;
+      foreach(QJsonValue value, request["files"].toArray())
+      {
+        filePaths.push_back(value.toString());
+      }
+
+      socket->write("ok\n");
+      socket->flush();
+      socket->disconnectFromServer();
+
+      emit filesReceived(filePaths);
+    });
+  }
+}
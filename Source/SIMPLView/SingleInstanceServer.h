@@ -0,0 +1,93 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include <QtNetwork/QLocalServer>
+
+/**
+ * @brief The SingleInstanceServer class lets a new launch hand its files to the SIMPLView that
+ * is already running for the same user, instead of starting a second process that has to load
+ * every plugin again. The running instance listens with a SingleInstanceServer; a launch calls
+ * ForwardToRunningInstance() before it builds anything and exits if that succeeds.
+ */
+class SingleInstanceServer : public QObject
+{
+  Q_OBJECT
+
+public:
+  SingleInstanceServer(QObject* parent = nullptr);
+  ~SingleInstanceServer() override;
+
+  /**
+   * @brief GetServerName Returns the socket name, which is unique per user
+   * @return
+   */
+  static QString GetServerName();
+
+  /**
+   * @brief ForwardToRunningInstance Sends the files to the running instance. A QCoreApplication
+   * must exist.
+   * @param filePaths Absolute paths, may be empty to ask for a new window
+   * @return True if a running instance accepted the files
+   */
+  static bool ForwardToRunningInstance(const QStringList& filePaths);
+
+  /**
+   * @brief listen Starts accepting forwarded files
+   * @return
+   */
+  bool listen();
+
+signals:
+  /**
+   * @brief filesReceived Emitted when another launch forwarded its files
+   * @param filePaths
+   */
+  void filesReceived(const QStringList& filePaths);
+
+private slots:
+  void acceptConnections();
+
+private:
+  QLocalServer m_Server;
+
+  SingleInstanceServer(const SingleInstanceServer&) = delete; // Copy Constructor Not Implemented
+  void operator=(const SingleInstanceServer&) = delete;       // Move assignment Not Implemented
+};
@@ -0,0 +1,204 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "StartupTrace.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThread>
+
+std::atomic<bool> StartupTrace::s_Enabled(false);
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+StartupTrace::StartupTrace() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+StartupTrace::~StartupTrace() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+StartupTrace* StartupTrace::Instance()
+{
+  static StartupTrace self;
+  return &self;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString StartupTrace::GetEnvironmentVariableName()
+{
+  return QString("SIMPLVIEW_TRACE_STARTUP");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void StartupTrace::start(const QString& filePath)
+{
+  QMutexLocker locker(&m_Mutex);
+  m_FilePath = filePath;
+  m_Events.clear();
+  m_Events.reserve(1024);
+  m_Timer.start();
+  s_Enabled.store(true, std::memory_order_release);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 StartupTrace::getElapsedMicroseconds() const
+{
+  return m_Timer.nsecsElapsed() / 1000;
+}
+
+// -----------------------------------------------------------------------------
+// Chrome trace viewers want small thread ids, so map the native ids to 1, 2, 3...
+// with the main thread being the first one to record anything.
+// -----------------------------------------------------------------------------
+int StartupTrace::currentThreadIndex()
+{
+  quintptr threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+  QMap<quintptr, int>::iterator iter = m_ThreadIds.find(threadId);
+  if(iter == m_ThreadIds.end())
+  {
+    iter = m_ThreadIds.insert(threadId, m_ThreadIds.size() + 1);
+  }
+  return iter.value();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void StartupTrace::addSpan(const char* name, const QString& detail, qint64 startUs, qint64 durationUs)
+{
+  if(!IsEnabled())
+  {
+    return;
+  }
+
+  QMutexLocker locker(&m_Mutex);
+  Event event;
+  event.name = name;
+  event.detail = detail;
+  event.phase = 'X';
+  event.start = startUs;
+  event.duration = durationUs;
+  event.thread = currentThreadIndex();
+  m_Events.push_back(event);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void StartupTrace::addInstant(const char* name)
+{
+  if(!IsEnabled())
+  {
+    return;
+  }
+
+  qint64 now = getElapsedMicroseconds();
+  QMutexLocker locker(&m_Mutex);
+  Event event;
+  event.name = name;
+  event.phase = 'i';
+  event.start = now;
+  event.thread = currentThreadIndex();
+  m_Events.push_back(event);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool StartupTrace::write()
+{
+  if(!IsEnabled())
+  {
+    return false;
+  }
+
+  QJsonArray traceEvents;
+  qint64 pid = QCoreApplication::applicationPid();
+  {
+    QMutexLocker locker(&m_Mutex);
+    for(const Event& event : m_Events)
+    {
+      QJsonObject obj;
+      obj["name"] = QString::fromLatin1(event.name);
+      obj["cat"] = QString("startup");
+      obj["ph"] = QString(QChar::fromLatin1(event.phase));
+      obj["ts"] = static_cast<double>(event.start);
+      obj["pid"] = static_cast<double>(pid);
+      obj["tid"] = event.thread;
+      if(event.phase == 'X')
+      {
+        obj["dur"] = static_cast<double>(event.duration);
+      }
+      else
+      {
+        obj["s"] = QString("p");
+      }
+      if(!event.detail.isEmpty())
+      {
+        QJsonObject args;
+        args["detail"] = event.detail;
+        obj["args"] = args;
+      }
+      traceEvents.push_back(obj);
+    }
+  }
+
+  QJsonObject root;
+  root["traceEvents"] = traceEvents;
+  root["displayTimeUnit"] = QString("ms");
+
+  QSaveFile file(m_FilePath);
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+  file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+  return file.commit();
+}
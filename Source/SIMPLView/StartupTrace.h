@@ -0,0 +1,194 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <atomic>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+/**
+ * @brief The StartupTrace class records wall clock spans during startup and writes them in
+ * the Chrome trace event format (load the file in chrome://tracing or Perfetto). Tracing is
+ * off unless start() is called, in which case a span costs a single atomic load.
+ *
+ * Use the STARTUP_TRACE_SCOPE macro to time the enclosing block:
+ * @code
+ *   STARTUP_TRACE_SCOPE("Read Settings");
+ * @endcode
+ */
+class StartupTrace
+{
+public:
+  virtual ~StartupTrace();
+
+  /**
+   * @brief Instance Returns the process wide trace
+   * @return
+   */
+  static StartupTrace* Instance();
+
+  /**
+   * @brief IsEnabled Returns true if spans are being recorded
+   * @return
+   */
+  static bool IsEnabled()
+  {
+    return s_Enabled.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief GetEnvironmentVariableName Returns the environment variable that can hold the
+   * trace file path instead of the --trace-startup=<file> option
+   * @return
+   */
+  static QString GetEnvironmentVariableName();
+
+  /**
+   * @brief start Starts recording. Time stamps are relative to this call.
+   * @param filePath The file that write() writes to
+   */
+  void start(const QString& filePath);
+
+  /**
+   * @brief getElapsedMicroseconds Returns the time since start()
+   * @return
+   */
+  qint64 getElapsedMicroseconds() const;
+
+  /**
+   * @brief addSpan Records a complete span on the calling thread
+   * @param name
+   * @param detail Shown as an argument of the span, may be empty
+   * @param startUs
+   * @param durationUs
+   */
+  void addSpan(const char* name, const QString& detail, qint64 startUs, qint64 durationUs);
+
+  /**
+   * @brief addInstant Records a point in time on the calling thread
+   * @param name
+   */
+  void addInstant(const char* name);
+
+  /**
+   * @brief write Writes everything recorded so far to the trace file
+   * @return
+   */
+  bool write();
+
+protected:
+  StartupTrace();
+
+private:
+  struct Event
+  {
+    const char* name = nullptr;
+    QString detail;
+    char phase = 'X';
+    qint64 start = 0;
+    qint64 duration = 0;
+    int thread = 0;
+  };
+
+  static std::atomic<bool> s_Enabled;
+
+  QString m_FilePath;
+  QElapsedTimer m_Timer;
+  QMutex m_Mutex;
+  QVector<Event> m_Events;
+  QMap<quintptr, int> m_ThreadIds;
+
+  int currentThreadIndex();
+
+  StartupTrace(const StartupTrace&) = delete;    // Copy Constructor Not Implemented
+  void operator=(const StartupTrace&) = delete; // Move assignment Not Implemented
+};
+
+/**
+ * @brief The StartupTraceSpan class records a span from its construction to its destruction
+ */
+class StartupTraceSpan
+{
+public:
+  explicit StartupTraceSpan(const char* name)
+  {
+    if(StartupTrace::IsEnabled())
+    {
+      m_Name = name;
+      m_Start = StartupTrace::Instance()->getElapsedMicroseconds();
+    }
+  }
+
+  StartupTraceSpan(const char* name, const QString& detail)
+  {
+    if(StartupTrace::IsEnabled())
+    {
+      m_Name = name;
+      m_Detail = detail;
+      m_Start = StartupTrace::Instance()->getElapsedMicroseconds();
+    }
+  }
+
+  ~StartupTraceSpan()
+  {
+    if(m_Name != nullptr)
+    {
+      StartupTrace* trace = StartupTrace::Instance();
+      trace->addSpan(m_Name, m_Detail, m_Start, trace->getElapsedMicroseconds() - m_Start);
+    }
+  }
+
+private:
+  const char* m_Name = nullptr;
+  QString m_Detail;
+  qint64 m_Start = 0;
+
+  StartupTraceSpan(const StartupTraceSpan&) = delete; // Copy Constructor Not Implemented
+  void operator=(const StartupTraceSpan&) = delete;   // Move assignment Not Implemented
+};
+
+#define STARTUP_TRACE_CONCAT_IMPL(a, b) a##b
+#define STARTUP_TRACE_CONCAT(a, b) STARTUP_TRACE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Times the rest of the enclosing block. An optional second argument is a QString
+ * that is recorded with the span, e.g. the plugin file name.
+ */
+#define STARTUP_TRACE_SCOPE(...) StartupTraceSpan STARTUP_TRACE_CONCAT(startupTraceSpan_, __LINE__)(__VA_ARGS__)
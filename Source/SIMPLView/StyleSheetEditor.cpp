@@ -56,6 +56,8 @@
 
 #include "SVWidgetsLib/QtSupport/QtSStyles.h"
 
+#include "SIMPLView/ThemeCache.h"
+
 #include "ui_StyleSheetEditor.h"
 
 StyleSheetEditor::StyleSheetEditor(QWidget* parent)
@@ -132,8 +134,7 @@ void StyleSheetEditor::updateCurrentStyleSheet(const QString &jsonFilePath)
 // -----------------------------------------------------------------------------
 void StyleSheetEditor::qssFileChanged(const QString& filePath)
 {
-  SVStyle* style = SVStyle::Instance();
-  style->loadStyleSheet(filePath);
+  ThemeCache::Instance()->loadTheme(filePath);
 }
 
 // -----------------------------------------------------------------------------
@@ -142,6 +143,5 @@ void StyleSheetEditor::qssFileChanged(const QString& filePath)
 // -----------------------------------------------------------------------------
 void StyleSheetEditor::on_qssFilePath_returnPressed()
 {
-  SVStyle* style = SVStyle::Instance();
-  style->loadStyleSheet(m_Ui->qssFilePath->text());
+  ThemeCache::Instance()->loadTheme(m_Ui->qssFilePath->text());
 }
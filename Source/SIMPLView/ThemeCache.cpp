@@ -0,0 +1,300 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ThemeCache.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFile>
+#include <QtCore/QMetaProperty>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <QtWidgets/QApplication>
+
+#include "SIMPLib/SIMPLibVersion.h"
+
+#include "SVWidgetsLib/Widgets/SVStyle.h"
+
+#include "SIMPLView/SIMPLViewVersion.h"
+#include "SIMPLView/StartupTrace.h"
+
+namespace
+{
+const quint32 k_CompiledThemeMagic = 0x53565448; // "SVTH"
+const quint32 k_CompiledThemeVersion = 1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThemeCache::ThemeCache() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThemeCache::~ThemeCache() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThemeCache* ThemeCache::Instance()
+{
+  static ThemeCache self;
+  return &self;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ThemeCache::GetCacheDirectory()
+{
+  return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/Themes";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ThemeCache::getCurrentThemeFilePath() const
+{
+  return m_CurrentThemeFilePath;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QByteArray ThemeCache::computeKey(const QString& themeFilePath)
+{
+  QFile file(themeFilePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return QByteArray();
+  }
+
+  if(m_TemplatesHash.isEmpty())
+  {
+    m_TemplatesHash = HashStyleSheetTemplates();
+  }
+
+  // SVWidgetsLib is built and versioned together with SIMPLib
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  hash.addData(file.readAll());
+  hash.addData(m_TemplatesHash);
+  hash.addData(SIMPLView::Version::Complete().toUtf8());
+  hash.addData(SIMPLib::Version::Complete().toUtf8());
+  return hash.result().toHex();
+}
+
+// -----------------------------------------------------------------------------
+// The templates that SVStyle fills in with the colors of a theme are compiled into the
+// libraries as resources, so a development build can change them without a new version
+// -----------------------------------------------------------------------------
+QByteArray ThemeCache::HashStyleSheetTemplates()
+{
+  QStringList templatePaths;
+  QDirIterator iter(":/", QStringList() << "*.qss"
+                                        << "*.css",
+                    QDir::Files, QDirIterator::Subdirectories);
+  while(iter.hasNext())
+  {
+    templatePaths.push_back(iter.next());
+  }
+  templatePaths.sort();
+
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  foreach(QString templatePath, templatePaths)
+  {
+    QFile file(templatePath);
+    if(file.open(QIODevice::ReadOnly))
+    {
+      hash.addData(templatePath.toUtf8());
+      hash.addData(file.readAll());
+    }
+  }
+  return hash.result();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ThemeCache::loadTheme(const QString& themeFilePath)
+{
+  STARTUP_TRACE_SCOPE("ThemeCache::loadTheme", themeFilePath);
+
+  QByteArray key = computeKey(themeFilePath);
+  if(key.isEmpty())
+  {
+    return false;
+  }
+
+  if(!m_Themes.contains(key))
+  {
+    CompiledTheme theme;
+    if(readCompiledTheme(key, theme))
+    {
+      m_Themes.insert(key, theme);
+    }
+  }
+
+  if(m_Themes.contains(key))
+  {
+    applyTheme(m_Themes.value(key), themeFilePath);
+    m_CurrentThemeFilePath = themeFilePath;
+    return true;
+  }
+
+  // Not compiled yet
+  {
+    STARTUP_TRACE_SCOPE("SVStyle::loadStyleSheet", themeFilePath);
+    if(!SVStyle::Instance()->loadStyleSheet(themeFilePath))
+    {
+      return false;
+    }
+  }
+  m_CurrentThemeFilePath = themeFilePath;
+
+  CompiledTheme theme = captureTheme();
+  m_Themes.insert(key, theme);
+  if(!writeCompiledTheme(key, theme))
+  {
+    qDebug() << "Could not write the compiled theme for" << themeFilePath << "to" << GetCacheDirectory();
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// Everything loadStyleSheet() produces: the application style sheet and palette
+// plus the colors and fonts that it stored as properties of SVStyle for widgets
+// that paint themselves.
+// -----------------------------------------------------------------------------
+ThemeCache::CompiledTheme ThemeCache::captureTheme() const
+{
+  SVStyle* style = SVStyle::Instance();
+
+  CompiledTheme theme;
+  theme.styleSheet = qApp->styleSheet();
+  theme.palette = qApp->palette();
+
+  const QMetaObject* metaObject = style->metaObject();
+  for(int i = QObject::staticMetaObject.propertyCount(); i < metaObject->propertyCount(); i++)
+  {
+    QMetaProperty property = metaObject->property(i);
+    if(property.isReadable() && property.isWritable())
+    {
+      theme.properties.insert(QString::fromLatin1(property.name()), property.read(style));
+    }
+  }
+  foreach(QByteArray name, style->dynamicPropertyNames())
+  {
+    theme.properties.insert(QString::fromLatin1(name), style->property(name.constData()));
+  }
+
+  return theme;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThemeCache::applyTheme(const CompiledTheme& theme, const QString& themeFilePath) const
+{
+  SVStyle* style = SVStyle::Instance();
+  for(QVariantMap::const_iterator iter = theme.properties.begin(); iter != theme.properties.end(); ++iter)
+  {
+    style->setProperty(iter.key().toLatin1().constData(), iter.value());
+  }
+  style->setCurrentThemeFilePath(themeFilePath);
+
+  qApp->setPalette(theme.palette);
+  qApp->setStyleSheet(theme.styleSheet);
+
+  emit style->styleSheetLoaded(themeFilePath);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ThemeCache::readCompiledTheme(const QByteArray& key, CompiledTheme& theme) const
+{
+  QFile file(GetCacheDirectory() + "/" + QString::fromLatin1(key) + ".theme");
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return false;
+  }
+
+  QDataStream in(&file);
+  in.setVersion(QDataStream::Qt_5_6);
+
+  quint32 magic = 0;
+  quint32 version = 0;
+  in >> magic >> version;
+  if(magic != k_CompiledThemeMagic || version != k_CompiledThemeVersion)
+  {
+    return false;
+  }
+
+  in >> theme.styleSheet >> theme.palette >> theme.properties;
+  return in.status() == QDataStream::Ok;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ThemeCache::writeCompiledTheme(const QByteArray& key, const CompiledTheme& theme) const
+{
+  QDir cacheDir(GetCacheDirectory());
+  if(!cacheDir.exists() && !cacheDir.mkpath("."))
+  {
+    return false;
+  }
+
+  QSaveFile file(cacheDir.absoluteFilePath(QString::fromLatin1(key) + ".theme"));
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+
+  QDataStream out(&file);
+  out.setVersion(QDataStream::Qt_5_6);
+  out << k_CompiledThemeMagic << k_CompiledThemeVersion;
+  out << theme.styleSheet << theme.palette << theme.properties;
+  if(out.status() != QDataStream::Ok)
+  {
+    file.cancelWriting();
+    return false;
+  }
+  return file.commit();
+}
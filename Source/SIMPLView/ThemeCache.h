@@ -0,0 +1,120 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMap>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtGui/QPalette>
+
+/**
+ * @brief The ThemeCache class keeps the output of SVStyle::loadStyleSheet for each theme so
+ * that a theme is only compiled once. The compiled style sheet, palette and SVStyle properties
+ * are stored on disk keyed by a hash of the theme file, the style sheet templates and the
+ * versions of SIMPLView and SIMPLib, and kept
+ * in memory for the rest of the session so that switching themes does not compile them again.
+ */
+class ThemeCache
+{
+public:
+  virtual ~ThemeCache();
+
+  /**
+   * @brief Instance
+   * @return
+   */
+  static ThemeCache* Instance();
+
+  /**
+   * @brief GetCacheDirectory Returns the directory that holds the compiled themes
+   * @return
+   */
+  static QString GetCacheDirectory();
+
+  /**
+   * @brief loadTheme Applies the theme from the cache, compiling it with SVStyle first if
+   * it is not cached yet
+   * @param themeFilePath
+   * @return
+   */
+  bool loadTheme(const QString& themeFilePath);
+
+  /**
+   * @brief getCurrentThemeFilePath Returns the theme that was applied last. Themes applied
+   * from the cache are set as the current theme of SVStyle as well.
+   * @return
+   */
+  QString getCurrentThemeFilePath() const;
+
+protected:
+  ThemeCache();
+
+private:
+  struct CompiledTheme
+  {
+    QString styleSheet;
+    QPalette palette;
+    QVariantMap properties;
+  };
+
+  QMap<QByteArray, CompiledTheme> m_Themes;
+  QString m_CurrentThemeFilePath;
+  QByteArray m_TemplatesHash;
+
+  /**
+   * @brief computeKey Hashes the theme file together with everything else that goes into
+   * the compiled style sheet
+   * @param themeFilePath
+   * @return An empty array if the theme file could not be read
+   */
+  QByteArray computeKey(const QString& themeFilePath);
+
+  /**
+   * @brief HashStyleSheetTemplates Hashes the style sheet templates in the resources
+   * @return
+   */
+  static QByteArray HashStyleSheetTemplates();
+
+  bool readCompiledTheme(const QByteArray& key, CompiledTheme& theme) const;
+  bool writeCompiledTheme(const QByteArray& key, const CompiledTheme& theme) const;
+
+  CompiledTheme captureTheme() const;
+  void applyTheme(const CompiledTheme& theme, const QString& themeFilePath) const;
+
+  ThemeCache(const ThemeCache&) = delete;      // Copy Constructor Not Implemented
+  void operator=(const ThemeCache&) = delete; // Move assignment Not Implemented
+};
@@ -0,0 +1,388 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "WatchFolderIngestor.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTextStream>
+
+#include "SIMPLView/HeadlessPipelineRunner.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+WatchFolderIngestor::WatchFolderIngestor(QObject* parent)
+: QObject(parent)
+, m_LedgerFile(GetDefaultLedgerFile())
+{
+  m_Pool.setMaxThreadCount(1);
+  m_CheckTimer.setInterval(1000);
+
+  connect(&m_Watcher, &QFileSystemWatcher::directoryChanged, this, &WatchFolderIngestor::scanDirectory);
+  connect(&m_CheckTimer, &QTimer::timeout, this, &WatchFolderIngestor::checkCandidates);
+  connect(this, &WatchFolderIngestor::jobFinished, this, &WatchFolderIngestor::recordResult, Qt::QueuedConnection);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+WatchFolderIngestor::~WatchFolderIngestor()
+{
+  m_Pool.waitForDone();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WatchFolderIngestor::setPipelineFile(const QString& filePath)
+{
+  // The ledger tells the pipelines apart by their absolute path
+  m_PipelineFile = QFileInfo(filePath).absoluteFilePath();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WatchFolderIngestor::setInputParameter(const QString& filterIndex, const QString& parameter)
+{
+  m_InputFilter = filterIndex;
+  m_InputParameter = parameter;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WatchFolderIngestor::setOutputParameter(const QString& filterIndex, const QString& parameter, const QString& directory, const QString& suffix)
+{
+  m_OutputFilter = filterIndex;
+  m_OutputParameter = parameter;
+  m_OutputDirectory = QDir(directory).absolutePath();
+  m_OutputSuffix = suffix;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WatchFolderIngestor::setNameFilters(const QStringList& nameFilters)
+{
+  m_NameFilters = nameFilters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WatchFolderIngestor::setSettleTime(int settleMs)
+{
+  m_SettleTime = qMax(0, settleMs);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int WatchFolderIngestor::getSettleTime() const
+{
+  return m_SettleTime;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WatchFolderIngestor::setMaxJobs(int maxJobs)
+{
+  m_Pool.setMaxThreadCount(qMax(1, maxJobs));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int WatchFolderIngestor::getMaxJobs() const
+{
+  return m_Pool.maxThreadCount();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WatchFolderIngestor::setMaxQueueLength(int maxLength)
+{
+  m_MaxQueueLength = qMax(1, maxLength);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int WatchFolderIngestor::getMaxQueueLength() const
+{
+  return m_MaxQueueLength;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WatchFolderIngestor::setLedgerFile(const QString& filePath)
+{
+  m_LedgerFile = filePath;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString WatchFolderIngestor::GetDefaultLedgerFile()
+{
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/IngestLedger.jsonl";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString WatchFolderIngestor::LedgerKey(const QString& pipelineFile, const QString& filePath, qint64 size, const QDateTime& modified)
+{
+  return QString("%1|%2|%3|%4").arg(pipelineFile).arg(filePath).arg(size).arg(modified.toMSecsSinceEpoch());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool WatchFolderIngestor::start(const QStringList& directories)
+{
+  readLedger();
+
+  foreach(QString directory, directories)
+  {
+    QString path = QDir(directory).absolutePath();
+    if(!m_Watcher.addPath(path))
+    {
+      qDebug().noquote() << "Could not watch" << QDir::toNativeSeparators(path);
+      return false;
+    }
+  }
+
+  foreach(QString directory, m_Watcher.directories())
+  {
+    scanDirectory(directory);
+  }
+  m_CheckTimer.start();
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WatchFolderIngestor::readLedger()
+{
+  QFile file(m_LedgerFile);
+  if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    return;
+  }
+
+  int count = 0;
+  while(!file.atEnd())
+  {
+    // Another pipeline that shares the ledger has not processed the file for this one,
+    // and a failure may have been caused by something that a restart fixed
+    QJsonObject entry = QJsonDocument::fromJson(file.readLine()).object();
+    if(entry.contains("errorCode") && entry["errorCode"].toInt() >= 0 && entry["pipeline"].toString() == m_PipelineFile)
+    {
+      QDateTime modified = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(entry["modified"].toDouble()));
+      m_HandledKeys.insert(LedgerKey(m_PipelineFile, entry["path"].toString(), static_cast<qint64>(entry["size"].toDouble()), modified));
+      count++;
+    }
+  }
+  qDebug().noquote() << count << "file(s) already processed according to" << QDir::toNativeSeparators(m_LedgerFile);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WatchFolderIngestor::scanDirectory(const QString& directory)
+{
+  QFileInfoList entries = QDir(directory).entryInfoList(m_NameFilters, QDir::Files | QDir::NoDotAndDotDot, QDir::Name);
+  foreach(QFileInfo fi, entries)
+  {
+    QString filePath = fi.absoluteFilePath();
+    if(m_Candidates.contains(filePath) || m_ActiveFiles.contains(filePath))
+    {
+      continue;
+    }
+    if(m_HandledKeys.contains(LedgerKey(m_PipelineFile, filePath, fi.size(), fi.lastModified())))
+    {
+      continue;
+    }
+
+    FileState state;
+    state.size = fi.size();
+    state.modified = fi.lastModified();
+    state.unchangedFor.start();
+    m_Candidates.insert(filePath, state);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WatchFolderIngestor::checkCandidates()
+{
+  // An acquisition system may still be writing a file long after it appeared. Only the
+  // directory is watched, so the file itself is polled until it stops changing.
+  QStringList settled;
+  for(QMap<QString, FileState>::iterator iter = m_Candidates.begin(); iter != m_Candidates.end();)
+  {
+    QFileInfo fi(iter.key());
+    if(!fi.exists())
+    {
+      iter = m_Candidates.erase(iter);
+      continue;
+    }
+    if(fi.size() != iter.value().size || fi.lastModified() != iter.value().modified)
+    {
+      iter.value().size = fi.size();
+      iter.value().modified = fi.lastModified();
+      iter.value().unchangedFor.restart();
+    }
+    else if(iter.value().unchangedFor.hasExpired(m_SettleTime))
+    {
+      settled.push_back(iter.key());
+    }
+    ++iter;
+  }
+
+  foreach(QString filePath, settled)
+  {
+    if(m_Queue.size() >= m_MaxQueueLength)
+    {
+      // The file stays a candidate and is queued on a later check
+      if(!m_QueueFull)
+      {
+        qDebug().noquote() << "The queue is full, new files wait to be queued";
+        m_QueueFull = true;
+      }
+      break;
+    }
+
+    FileState state = m_Candidates.take(filePath);
+    if(m_HandledKeys.contains(LedgerKey(m_PipelineFile, filePath, state.size, state.modified)))
+    {
+      continue;
+    }
+    m_ActiveFiles.insert(filePath, state);
+    m_Queue.push_back(filePath);
+  }
+  if(m_Queue.size() < m_MaxQueueLength)
+  {
+    m_QueueFull = false;
+  }
+
+  dispatchJobs();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WatchFolderIngestor::dispatchJobs()
+{
+  while(m_RunningJobs < getMaxJobs() && !m_Queue.isEmpty())
+  {
+    QString filePath = m_Queue.takeFirst();
+    m_RunningJobs++;
+
+    QJsonObject overrides;
+    QJsonObject inputFilter;
+    inputFilter[m_InputParameter] = filePath;
+    overrides[m_InputFilter] = inputFilter;
+    if(!m_OutputFilter.isEmpty())
+    {
+      QJsonObject outputFilter = overrides[m_OutputFilter].toObject();
+      outputFilter[m_OutputParameter] = QDir(m_OutputDirectory).filePath(QFileInfo(filePath).completeBaseName() + m_OutputSuffix);
+      overrides[m_OutputFilter] = outputFilter;
+    }
+
+    qDebug().noquote() << "Processing" << QDir::toNativeSeparators(filePath);
+    QString pipelineFile = m_PipelineFile;
+    QtConcurrent::run(&m_Pool, [this, pipelineFile, filePath, overrides] {
+      HeadlessPipelineRunner::Result result = HeadlessPipelineRunner::RunPipeline(pipelineFile, overrides);
+      foreach(QString error, result.errors)
+      {
+        qDebug().noquote() << "    " << error;
+      }
+      emit jobFinished(filePath, result.errorCode, result.elapsedMs);
+    });
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void WatchFolderIngestor::recordResult(const QString& filePath, int errorCode, qint64 elapsedMs)
+{
+  m_RunningJobs--;
+  // A failed file is not tried again in this session until it changes
+  FileState state = m_ActiveFiles.take(filePath);
+  m_HandledKeys.insert(LedgerKey(m_PipelineFile, filePath, state.size, state.modified));
+
+  QString status = (errorCode < 0) ? QString("FAILED (%1)").arg(errorCode) : QString("OK");
+  qDebug().noquote() << QString("%1: %2 in %3 ms").arg(QDir::toNativeSeparators(filePath)).arg(status).arg(elapsedMs);
+
+  // The ledger is appended to rather than rewritten, so a crash can at most lose the line
+  // that was being written
+  QFileInfo ledgerInfo(m_LedgerFile);
+  QDir().mkpath(ledgerInfo.absolutePath());
+  QFile ledger(m_LedgerFile);
+  if(ledger.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+  {
+    QJsonObject entry;
+    entry["path"] = filePath;
+    entry["size"] = static_cast<double>(state.size);
+    entry["modified"] = static_cast<double>(state.modified.toMSecsSinceEpoch());
+    entry["pipeline"] = m_PipelineFile;
+    entry["errorCode"] = errorCode;
+    entry["elapsedMs"] = static_cast<double>(elapsedMs);
+    entry["finished"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    ledger.write(QJsonDocument(entry).toJson(QJsonDocument::Compact) + "\n");
+  }
+  else
+  {
+    qDebug().noquote() << "Could not write to" << QDir::toNativeSeparators(m_LedgerFile);
+  }
+
+  dispatchJobs();
+}
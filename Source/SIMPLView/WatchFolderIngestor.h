@@ -0,0 +1,228 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileSystemWatcher>
+#include <QtCore/QJsonObject>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+
+/**
+ * @brief The WatchFolderIngestor class watches directories for new data files and runs a
+ * pipeline on each of them once its size and modification time have stopped changing for
+ * getSettleTime() ms. The file is handed to the pipeline through one filter parameter, and
+ * optionally an output file named after it through another.
+ *
+ * At most getMaxJobs() pipelines run at the same time and at most getMaxQueueLength() files
+ * wait for a free slot. Files beyond that stay where they are and are queued once there is
+ * room again, so a burst of acquisitions never grows the queue without limit. The pipelines
+ * run on threads, so they execute one at a time unless HeadlessPipelineRunner::IsHdf5ThreadSafe().
+ *
+ * Every finished run is appended to a ledger file. A file is run once per pipeline for every
+ * version of it, told apart by its size and modification time. A version that failed is not
+ * retried in the same session, but is tried again after a restart. Touching the file queues
+ * it again in either case.
+ *
+ * The plugins must have been loaded already.
+ */
+class WatchFolderIngestor : public QObject
+{
+  Q_OBJECT
+
+public:
+  WatchFolderIngestor(QObject* parent = nullptr);
+  ~WatchFolderIngestor() override;
+
+  /**
+   * @brief setPipelineFile Sets the .json pipeline that is run for every file
+   * @param filePath
+   */
+  void setPipelineFile(const QString& filePath);
+
+  /**
+   * @brief setInputParameter Sets the filter parameter that receives the path of the file
+   * @param filterIndex
+   * @param parameter
+   */
+  void setInputParameter(const QString& filterIndex, const QString& parameter);
+
+  /**
+   * @brief setOutputParameter Sets a filter parameter that receives
+   * "<directory>/<base name of the file><suffix>"
+   * @param filterIndex
+   * @param parameter
+   * @param directory
+   * @param suffix
+   */
+  void setOutputParameter(const QString& filterIndex, const QString& parameter, const QString& directory, const QString& suffix);
+
+  /**
+   * @brief setNameFilters Sets the wildcards of the files to process, every file if empty
+   * @param nameFilters
+   */
+  void setNameFilters(const QStringList& nameFilters);
+
+  /**
+   * @brief setSettleTime Sets how long a file must stay unchanged before it is processed
+   * @param settleMs
+   */
+  void setSettleTime(int settleMs);
+
+  /**
+   * @brief getSettleTime
+   * @return
+   */
+  int getSettleTime() const;
+
+  /**
+   * @brief setMaxJobs Sets how many pipelines may run at the same time
+   * @param maxJobs
+   */
+  void setMaxJobs(int maxJobs);
+
+  /**
+   * @brief getMaxJobs
+   * @return
+   */
+  int getMaxJobs() const;
+
+  /**
+   * @brief setMaxQueueLength Sets how many stable files may wait for a free slot
+   * @param maxLength
+   */
+  void setMaxQueueLength(int maxLength);
+
+  /**
+   * @brief getMaxQueueLength
+   * @return
+   */
+  int getMaxQueueLength() const;
+
+  /**
+   * @brief setLedgerFile Sets where the finished runs are recorded
+   * @param filePath
+   */
+  void setLedgerFile(const QString& filePath);
+
+  /**
+   * @brief start Reads the ledger, watches the directories and picks up the files that are
+   * already in them
+   * @param directories
+   * @return False if a directory could not be watched
+   */
+  bool start(const QStringList& directories);
+
+  /**
+   * @brief GetDefaultLedgerFile
+   * @return
+   */
+  static QString GetDefaultLedgerFile();
+
+signals:
+  /**
+   * @brief jobFinished Emitted from the pool's threads when a pipeline is done
+   * @param filePath
+   * @param errorCode
+   * @param elapsedMs
+   */
+  void jobFinished(const QString& filePath, int errorCode, qint64 elapsedMs);
+
+private slots:
+  void scanDirectory(const QString& directory);
+  void checkCandidates();
+  void recordResult(const QString& filePath, int errorCode, qint64 elapsedMs);
+
+private:
+  struct FileState
+  {
+    qint64 size = -1;
+    QDateTime modified;
+    QElapsedTimer unchangedFor;
+  };
+
+  QString m_PipelineFile;
+  QString m_InputFilter;
+  QString m_InputParameter;
+  QString m_OutputFilter;
+  QString m_OutputParameter;
+  QString m_OutputDirectory;
+  QString m_OutputSuffix;
+  QStringList m_NameFilters;
+  QString m_LedgerFile;
+  int m_SettleTime = 5000;
+  int m_MaxQueueLength = 100;
+
+  QFileSystemWatcher m_Watcher;
+  QTimer m_CheckTimer;
+  QThreadPool m_Pool;
+  QMap<QString, FileState> m_Candidates;
+  QList<QString> m_Queue;
+  QMap<QString, FileState> m_ActiveFiles;
+  QSet<QString> m_HandledKeys;
+  int m_RunningJobs = 0;
+  bool m_QueueFull = false;
+
+  /**
+   * @brief LedgerKey Identifies one version of a file processed by one pipeline
+   * @param pipelineFile
+   * @param filePath
+   * @param size
+   * @param modified
+   * @return
+   */
+  static QString LedgerKey(const QString& pipelineFile, const QString& filePath, qint64 size, const QDateTime& modified);
+
+  /**
+   * @brief readLedger Remembers the files that the pipeline processed successfully before
+   */
+  void readLedger();
+
+  /**
+   * @brief dispatchJobs Starts queued files while there are free slots
+   */
+  void dispatchJobs();
+
+  WatchFolderIngestor(const WatchFolderIngestor&) = delete; // Copy Constructor Not Implemented
+  void operator=(const WatchFolderIngestor&) = delete;      // Move assignment Not Implemented
+};
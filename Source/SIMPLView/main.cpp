@@ -33,20 +33,45 @@
  *
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+#include <QtCore/QDateTime>
+#include <QtCore/QCommandLineParser>
 #include <QtCore/QDebug>
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QSettings>
 #include <QtCore/QString>
 #include <QtCore/QDirIterator>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QUuid>
 
 #include <QtGui/QFontDatabase>
 
+#include "SIMPLib/Filtering/QMetaObjectUtilities.h"
+#include "SIMPLib/Utilities/SIMPLDataPathValidator.h"
+
+#include "BatchCoordinator.h"
+#include "BatchWorker.h"
 #include "BrandedStrings.h"
+#include "FilterResultCache.h"
+#include "FilterResultStore.h"
+#include "HeadlessPipelineRunner.h"
+#include "MetricsServer.h"
+#include "ParameterSweep.h"
+#include "PerformanceHistory.h"
+#include "PipelineCheckpoints.h"
+#include "PipelineDaemon.h"
+#include "PipelineMetrics.h"
+#include "PipelineProcessPool.h"
+#include "RunManifest.h"
 #include "SIMPLView.h"
 #include "SIMPLViewApplication.h"
+#include "SIMPLViewPluginLoader.h"
+#include "SIMPLViewSettings.h"
+#include "SingleInstanceServer.h"
+#include "StartupTrace.h"
 #include "SIMPLView_UI.h"
 #include "StyleSheetEditor.h"
+#include "WatchFolderIngestor.h"
 
 #include "SVWidgetsLib/QtSupport/QtSStyles.h"
 #include "SVWidgetsLib/QtSupport/QtSRecentFileList.h"
@@ -59,15 +84,13 @@
 
 #include <clocale>
 
-#ifdef SIMPL_USE_MKDOCS
-#include "SVWidgetsLib/QtSupport/QtSDocServer.h"
-#endif
-
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
 void InitFonts(const QStringList& fontList)
 {
+  STARTUP_TRACE_SCOPE("InitFonts");
+
   int fontID(-1);
 
   for(QStringList::const_iterator constIterator = fontList.constBegin(); constIterator != fontList.constEnd(); ++constIterator)
@@ -105,11 +128,1101 @@ void InitStyleSheetEditor()
   QObject::connect(style, &SVStyle::styleSheetLoaded, styleSheetEditor, &StyleSheetEditor::updateCurrentStyleSheet);
 }
 
+// -----------------------------------------------------------------------------
+// Loads every plugin, including the disabled ones, and writes what was found to
+// the manifest file. This is run by the install rules so that a new installation
+// ships with a manifest that matches its plugins.
+// -----------------------------------------------------------------------------
+int BuildPluginManifest(int argc, char* argv[], const QString& manifestFilePath)
+{
+  QCoreApplication app(argc, argv);
+  QMetaObjectUtilities::RegisterMetaTypes();
+
+  SIMPLViewPluginLoader loader;
+  loader.setRegisterFilterWidgets(false);
+  loader.setUseLoadingPreferences(false);
+  loader.setUseUserManifest(false);
+
+  int err = 0;
+  QObject::connect(&loader, &SIMPLViewPluginLoader::pluginFailedToLoad, [&err](const QString& filePath, const QString& errorString) {
+    qDebug() << "The plugin " << filePath << " did not load with the following error: " << errorString;
+    err = 1;
+  });
+  loader.loadPlugins();
+
+  // There is nobody to show the failures to, so they go to the console and the log
+  PluginLoadReport report = loader.getLoadReport();
+  if(!report.isEmpty())
+  {
+    qDebug().noquote() << report.toText();
+    report.appendToLog(PluginLoadReport::GetLogFilePath());
+  }
+
+  if(!loader.writeManifest(manifestFilePath))
+  {
+    qDebug() << "Could not write the plugin manifest to " << manifestFilePath;
+    return 1;
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+// Prepares a QCoreApplication to execute pipelines without any widgets
+// -----------------------------------------------------------------------------
+void LoadHeadlessPlugins(SIMPLViewPluginLoader& loader)
+{
+  QMetaObjectUtilities::RegisterMetaTypes();
+
+#if defined SIMPL_RELATIVE_PATH_CHECK
+  // Pipelines with relative paths resolve them against the data directory chosen in the GUI
+  SIMPLViewSettings* prefs = SIMPLViewSettings::Instance();
+  prefs->beginGroup("Application Settings");
+  QString dataDir = prefs->value("Data Directory", QString()).toString();
+  prefs->endGroup();
+  if(!dataDir.isEmpty())
+  {
+    SIMPLDataPathValidator::Instance()->setSIMPLDataDirectory(dataDir);
+  }
+#endif
+
+  // Pipelines run on worker threads, so every plugin is opened up front instead of on
+  // first use
+  loader.setRegisterFilterWidgets(false);
+  loader.setLazyActivation(false);
+  QElapsedTimer loadTimer;
+  loadTimer.start();
+  loader.loadPlugins();
+
+  PluginLoadReport report = loader.getLoadReport();
+  PipelineMetrics::Instance()->setPluginLoadTime(loadTimer.elapsed(), report.getFailures().size());
+  if(!report.isEmpty())
+  {
+    qDebug().noquote() << report.toText();
+    report.appendToLog(PluginLoadReport::GetLogFilePath());
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Prints the usage of a mode such as --headless. The usage starts with the mode.
+// -----------------------------------------------------------------------------
+void PrintUsage(const QStringList& arguments, const QString& usage)
+{
+  qDebug().noquote() << "Usage: " << QFileInfo(arguments[0]).fileName() << usage;
+}
+
+// -----------------------------------------------------------------------------
+// Parses the arguments of a mode such as --headless, which is arguments[1], with the
+// options that were added to the parser. Prints the error and the usage and returns
+// false for an unknown option or an option without its value.
+// -----------------------------------------------------------------------------
+bool ParseModeArguments(QCommandLineParser& parser, const QStringList& arguments, const QString& usage)
+{
+  QStringList modeArguments = arguments;
+  modeArguments.removeAt(1);
+  if(!parser.parse(modeArguments))
+  {
+    qDebug().noquote() << parser.errorText();
+    PrintUsage(arguments, usage);
+    return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// Adds the resource options that --headless and --daemon share:
+//   --memory-limit MB --timeout S --cpus LIST --pin-numa --nice N --io-priority N
+// -----------------------------------------------------------------------------
+void AddResourceOptions(QCommandLineParser& parser)
+{
+  parser.addOptions({{"memory-limit", "Address space of a job", "MB"},
+                     {"timeout", "Time after which a job is killed", "S"},
+                     {"cpus", "CPUs the workers are spread over, such as 0-3,8", "LIST"},
+                     {"pin-numa", "Keeps every worker on one NUMA node"},
+                     {"nice", "Scheduling niceness of the workers", "N"},
+                     {"io-priority", "I/O priority of the workers from 0 to 7", "N"}});
+}
+
+// -----------------------------------------------------------------------------
+// Prints the error and the usage for an option whose value cannot be used
+// -----------------------------------------------------------------------------
+void PrintInvalidOption(const QCommandLineParser& parser, const QString& option, const QStringList& arguments, const QString& usage)
+{
+  qDebug().noquote() << QString("Invalid value for --%1: %2").arg(option).arg(parser.value(option));
+  PrintUsage(arguments, usage);
+}
+
+// -----------------------------------------------------------------------------
+// Reads the options of AddResourceOptions(). Sets whether any of them was given,
+// which implies --isolate. Prints the error and the usage and returns false for a
+// value that cannot be used, rather than running without the limit.
+// -----------------------------------------------------------------------------
+bool ReadResourceOptions(const QCommandLineParser& parser, const QStringList& arguments, const QString& usage, PipelineProcessPool::JobLimits& limits, PipelineProcessPool::Placement& placement,
+                         bool& given)
+{
+  given = false;
+  bool ok = false;
+  if(parser.isSet("memory-limit"))
+  {
+    limits.memoryMB = parser.value("memory-limit").toLongLong(&ok);
+    if(!ok || limits.memoryMB < 0)
+    {
+      PrintInvalidOption(parser, "memory-limit", arguments, usage);
+      return false;
+    }
+    given = true;
+  }
+  if(parser.isSet("timeout"))
+  {
+    limits.timeoutSec = parser.value("timeout").toInt(&ok);
+    if(!ok || limits.timeoutSec < 0)
+    {
+      PrintInvalidOption(parser, "timeout", arguments, usage);
+      return false;
+    }
+    given = true;
+  }
+  if(parser.isSet("cpus"))
+  {
+    placement.cpus = PipelineProcessPool::ParseCpuList(parser.value("cpus"));
+    if(placement.cpus.isEmpty())
+    {
+      PrintInvalidOption(parser, "cpus", arguments, usage);
+      return false;
+    }
+    given = true;
+  }
+  if(parser.isSet("pin-numa"))
+  {
+    placement.pinToNumaNodes = true;
+    given = true;
+  }
+  if(parser.isSet("nice"))
+  {
+    // Only a lower priority can be set without privileges
+    placement.niceness = parser.value("nice").toInt(&ok);
+    if(!ok || placement.niceness < 0 || placement.niceness > 19)
+    {
+      PrintInvalidOption(parser, "nice", arguments, usage);
+      return false;
+    }
+    given = true;
+  }
+  if(parser.isSet("io-priority"))
+  {
+    placement.ioPriority = parser.value("io-priority").toInt(&ok);
+    if(!ok || placement.ioPriority < 0 || placement.ioPriority > 7)
+    {
+      PrintInvalidOption(parser, "io-priority", arguments, usage);
+      return false;
+    }
+    given = true;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// Adds the metrics options that --headless and --daemon share:
+//   --metrics-port N --metrics-file PATH --metrics-interval S
+// -----------------------------------------------------------------------------
+void AddMetricsOptions(QCommandLineParser& parser)
+{
+  parser.addOptions({{"metrics-port", "Port of http://localhost:N/metrics", "N"},
+                     {"metrics-file", "File the metrics are written to", "PATH"},
+                     {"metrics-interval", "Time between two writes of the metrics file", "S"}});
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ReadMetricsOptions(const QCommandLineParser& parser, MetricsServer& metrics)
+{
+  if(parser.isSet("metrics-port"))
+  {
+    metrics.setPort(static_cast<quint16>(parser.value("metrics-port").toUInt()));
+  }
+  if(parser.isSet("metrics-file"))
+  {
+    metrics.setFilePath(QFileInfo(parser.value("metrics-file")).absoluteFilePath());
+  }
+  if(parser.isSet("metrics-interval"))
+  {
+    metrics.setInterval(parser.value("metrics-interval").toInt());
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Adds the FilterResultStore options that --headless, --daemon and --results share:
+//   --result-store --result-store-dir DIR --result-store-size MB
+// -----------------------------------------------------------------------------
+void AddResultStoreOptions(QCommandLineParser& parser)
+{
+  parser.addOptions({{"result-store", "Keeps the states after slow pipeline prefixes on disk"},
+                     {"result-store-dir", "Directory of the stored states", "DIR"},
+                     {"result-store-size", "Size the stored states are pruned to", "MB"}});
+}
+
+// -----------------------------------------------------------------------------
+// Reads the options of AddResultStoreOptions(). Giving the directory or the size also
+// turns the store on.
+// -----------------------------------------------------------------------------
+void ReadResultStoreOptions(const QCommandLineParser& parser)
+{
+  FilterResultStore* store = FilterResultStore::Instance();
+  if(parser.isSet("result-store-dir"))
+  {
+    store->setDirectory(QFileInfo(parser.value("result-store-dir")).absoluteFilePath());
+  }
+  if(parser.isSet("result-store-size"))
+  {
+    store->setMaxSize(parser.value("result-store-size").toLongLong());
+  }
+  if(parser.isSet("result-store") || parser.isSet("result-store-dir") || parser.isSet("result-store-size"))
+  {
+    store->setEnabled(true);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool HasResourceLimits(const PipelineProcessPool::JobLimits& limits, const PipelineProcessPool::Placement& placement)
+{
+  return limits.memoryMB > 0 || limits.timeoutSec > 0 || !placement.cpus.isEmpty() || placement.pinToNumaNodes || placement.niceness > 0 || placement.ioPriority >= 0;
+}
+
+// -----------------------------------------------------------------------------
+// Starts the worker processes for --isolate. Must be called after the plugins have
+// been loaded so that every worker has them. Returns false if the pipelines have to
+// run on threads instead.
+// -----------------------------------------------------------------------------
+bool StartProcessPool(PipelineProcessPool& pool, int workerCount, int maxJobsPerWorker, qint64 maxWorkerMemory, const PipelineProcessPool::JobLimits& limits,
+                      const PipelineProcessPool::Placement& placement)
+{
+  if(!PipelineProcessPool::IsSupported())
+  {
+    qDebug().noquote() << "Worker processes are not supported on this platform. The pipelines run on threads"
+                       << (HasResourceLimits(limits, placement) ? "without resource limits." : ".");
+    return false;
+  }
+
+  pool.setMaxJobsPerWorker(maxJobsPerWorker);
+  pool.setMaxWorkerMemory(maxWorkerMemory);
+  pool.setJobLimits(limits);
+  pool.setPlacement(placement);
+  if(!pool.start(workerCount))
+  {
+    pool.stop();
+    qDebug().noquote() << "The worker processes could not be started. The pipelines run on threads.";
+    return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// Runs pipeline files without any widgets or display server:
+//   SIMPLView --headless [--jobs N] [--isolate [--max-jobs-per-worker N] [--max-worker-memory MB]]
+//             [--memory-limit MB] [--timeout S] [--cpus LIST] [--pin-numa] [--nice N] [--io-priority N]
+//             [--force] [--dry-run] [--manifest-dir DIR] [--profile DIR] [--no-history]
+//             [--metrics-port N] [--metrics-file PATH [--metrics-interval S]]
+//             [--result-store] [--result-store-dir DIR] [--result-store-size MB]
+//             [--checkpoint LIST] [--checkpoint-dir DIR] [--resume] pipeline.json [pipeline.dream3d ...]
+// The exit code is non-zero if any of the pipelines failed. With --isolate every
+// pipeline runs in a worker process, so a crashing filter only fails its own file.
+// A pipeline whose inputs, parameters, plugins and outputs are unchanged since its last
+// successful run is skipped unless --force is given; --dry-run lists what would run.
+// --profile writes a Chrome trace and a CSV file with the cost of every filter. The filter
+// timings are added to the PerformanceHistory unless --no-history is given.
+// --jobs above 1 needs --isolate unless the HDF5 library was built thread safe.
+// The resource limits apply per job and imply --isolate. The metrics of the run are served
+// on http://localhost:N/metrics and written to the metrics file while it lasts.
+// With --result-store the states after slow pipeline prefixes are kept on disk and later
+// runs that share a prefix with the same inputs resume after it; see --results.
+// --checkpoint writes the state after the listed filters ("3,7-8"), and --resume starts a
+// pipeline after its deepest checkpoint whose upstream filters and inputs are unchanged.
+// -----------------------------------------------------------------------------
+int RunHeadless(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  const QString usage = " --headless [--jobs N] [--isolate [--max-jobs-per-worker N] [--max-worker-memory MB]]"
+                        " [--memory-limit MB] [--timeout S] [--cpus LIST] [--pin-numa] [--nice N] [--io-priority N]"
+                        " [--force] [--dry-run] [--manifest-dir DIR] [--profile DIR] [--no-history]"
+                        " [--metrics-port N] [--metrics-file PATH [--metrics-interval S]]"
+                        " [--result-store] [--result-store-dir DIR] [--result-store-size MB]"
+                        " [--checkpoint LIST] [--checkpoint-dir DIR] [--resume]"
+                        " <pipeline file> [<pipeline file> ...]";
+  QCommandLineParser parser;
+  parser.addOptions({{"jobs", "Pipelines that run at the same time", "N", "1"},
+                     {"isolate", "Runs every pipeline in a worker process"},
+                     {"max-jobs-per-worker", "Jobs after which a worker process is replaced", "N", "50"},
+                     {"max-worker-memory", "Memory above which a worker process is replaced", "MB", "0"},
+                     {"force", "Runs the pipelines that are up to date as well"},
+                     {"dry-run", "Lists the pipelines that would run"},
+                     {"manifest-dir", "Directory of the run manifests", "DIR"},
+                     {"profile", "Directory of the filter profiles", "DIR"},
+                     {"no-history", "Does not add the filter timings to the PerformanceHistory"},
+                     {"checkpoint", "Filters after which the state is written, such as 3,7-8", "LIST"},
+                     {"checkpoint-dir", "Directory of the checkpoints", "DIR"},
+                     {"resume", "Starts after the deepest checkpoint that is still valid"}});
+  AddResourceOptions(parser);
+  AddMetricsOptions(parser);
+  AddResultStoreOptions(parser);
+  QStringList arguments = app.arguments();
+  if(!ParseModeArguments(parser, arguments, usage))
+  {
+    return 1;
+  }
+
+  int jobs = parser.value("jobs").toInt();
+  PipelineProcessPool::JobLimits limits;
+  PipelineProcessPool::Placement placement;
+  bool resourceOptionsGiven = false;
+  if(!ReadResourceOptions(parser, arguments, usage, limits, placement, resourceOptionsGiven))
+  {
+    return 1;
+  }
+  bool isolate = resourceOptionsGiven || parser.isSet("isolate");
+  int maxJobsPerWorker = parser.value("max-jobs-per-worker").toInt();
+  qint64 maxWorkerMemory = parser.value("max-worker-memory").toLongLong();
+  bool force = parser.isSet("force");
+  bool dryRun = parser.isSet("dry-run");
+  QString manifestDir = parser.isSet("manifest-dir") ? QFileInfo(parser.value("manifest-dir")).absoluteFilePath() : RunManifest::GetDefaultDirectory();
+  QString profileDir = parser.isSet("profile") ? QFileInfo(parser.value("profile")).absoluteFilePath() : QString();
+  // Checked once the pipelines can be read
+  QString checkpointList = parser.value("checkpoint");
+  if(parser.isSet("checkpoint-dir"))
+  {
+    PipelineCheckpoints::Instance()->setDirectory(QFileInfo(parser.value("checkpoint-dir")).absoluteFilePath());
+  }
+  if(parser.isSet("resume"))
+  {
+    PipelineCheckpoints::Instance()->setResume(true);
+  }
+  if(parser.isSet("no-history"))
+  {
+    PerformanceHistory::Instance()->setEnabled(false);
+  }
+  MetricsServer metrics;
+  ReadMetricsOptions(parser, metrics);
+  ReadResultStoreOptions(parser);
+  QStringList filePaths = parser.positionalArguments();
+
+  if(filePaths.isEmpty() || jobs < 1)
+  {
+    PrintUsage(arguments, usage);
+    return 1;
+  }
+  if(jobs > 1 && !isolate && !HeadlessPipelineRunner::IsHdf5ThreadSafe())
+  {
+    qDebug().noquote() << "--jobs above 1 needs --isolate because the HDF5 library is not thread safe";
+    PrintUsage(arguments, usage);
+    return 1;
+  }
+
+  SIMPLViewPluginLoader loader;
+  LoadHeadlessPlugins(loader);
+
+  // Every checkpoint must be at a filter of every pipeline. A file that cannot be read
+  // fails on its own when it is run.
+  if(!checkpointList.isEmpty())
+  {
+    int filterCount = -1;
+    foreach(QString filePath, filePaths)
+    {
+      FilterPipeline::Pointer pipeline = HeadlessPipelineRunner::ReadPipeline(filePath);
+      if(pipeline.get() != nullptr)
+      {
+        int count = pipeline->getFilterContainer().size();
+        filterCount = (filterCount < 0) ? count : qMin(filterCount, count);
+      }
+    }
+    QVector<int> indices;
+    if(filterCount >= 0 && !PipelineCheckpoints::ParseFilterIndices(checkpointList, filterCount, indices))
+    {
+      qDebug().noquote() << "--checkpoint needs filter indices such as 3,7-8 that are below" << filterCount;
+      PrintUsage(arguments, usage);
+      return 1;
+    }
+    PipelineCheckpoints::Instance()->setFilterIndices(indices);
+  }
+
+  HeadlessPipelineRunner runner;
+  runner.setJobs(jobs);
+  runner.setPipelineFiles(filePaths);
+  runner.setManifestDirectory(manifestDir);
+  runner.setForce(force);
+  runner.setDryRun(dryRun);
+  runner.setProfileDirectory(profileDir);
+
+  PipelineProcessPool pool;
+  if(isolate && !dryRun && StartProcessPool(pool, qMin(jobs, filePaths.size()), maxJobsPerWorker, maxWorkerMemory, limits, placement))
+  {
+    runner.setProcessPool(&pool);
+  }
+
+  // The workers are forked before the metrics thread starts
+  if(!metrics.startServing())
+  {
+    qDebug().noquote() << "Could not serve the metrics:" << metrics.getErrorString();
+    return 1;
+  }
+  int err = runner.run();
+  metrics.stopServing();
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+// Runs one pipeline with every combination of a parameter grid, or every row of a CSV
+// file, and executes the filters that the variants share only once:
+//   SIMPLView --sweep pipeline.json --grid grid.json|overrides.csv [--output-dir DIR]
+// -----------------------------------------------------------------------------
+int RunSweep(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  const QString usage = " --sweep <pipeline file> --grid <grid .json or .csv file> [--output-dir DIR]";
+  QCommandLineParser parser;
+  parser.addOptions({{"grid", "JSON grid or CSV file of the parameter values", "FILE"}, {"output-dir", "Directory the variants write to", "DIR"}});
+  QStringList arguments = app.arguments();
+  if(!ParseModeArguments(parser, arguments, usage))
+  {
+    return 1;
+  }
+
+  QString gridFile = parser.value("grid");
+  QString outputDir = parser.isSet("output-dir") ? parser.value("output-dir") : QDir::currentPath();
+  QStringList positionalArguments = parser.positionalArguments();
+  if(positionalArguments.size() != 1 || gridFile.isEmpty())
+  {
+    PrintUsage(arguments, usage);
+    return 1;
+  }
+  QString pipelineFile = positionalArguments[0];
+
+  QString errorMessage;
+  QVector<QJsonObject> overrides = ParameterSweep::ReadOverridesFile(gridFile, errorMessage);
+  if(overrides.isEmpty())
+  {
+    qDebug().noquote() << (errorMessage.isEmpty() ? QString("The grid does not hold any variant") : errorMessage);
+    return 1;
+  }
+
+  SIMPLViewPluginLoader loader;
+  LoadHeadlessPlugins(loader);
+
+  ParameterSweep sweep;
+  sweep.setPipelineFile(pipelineFile);
+  sweep.setOutputDirectory(outputDir);
+  sweep.setOverrides(overrides);
+  return sweep.run();
+}
+
+// -----------------------------------------------------------------------------
+// Keeps the plugins loaded and executes the pipelines that clients submit:
+//   SIMPLView --daemon [--jobs N] [--socket NAME]
+//             [--isolate [--max-jobs-per-worker N] [--max-worker-memory MB]]
+//             [--memory-limit MB] [--timeout S] [--cpus LIST] [--pin-numa] [--nice N] [--io-priority N]
+//             [--metrics-port N] [--metrics-file PATH [--metrics-interval S]] [--memoize MB]
+//             [--result-store] [--result-store-dir DIR] [--result-store-size MB]
+// With --memoize the jobs keep up to MB of intermediate results in memory, so that a job
+// that only changed the later filters of a pipeline does not execute the earlier ones again.
+// It has no effect with --isolate, where the jobs do not share the memory of the daemon.
+// --jobs above 1 needs --isolate unless the HDF5 library was built thread safe.
+// -----------------------------------------------------------------------------
+int RunDaemon(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  const QString usage = " --daemon [--jobs N] [--socket NAME] [--isolate [--max-jobs-per-worker N] [--max-worker-memory MB]]"
+                        " [--memory-limit MB] [--timeout S] [--cpus LIST] [--pin-numa] [--nice N] [--io-priority N]"
+                        " [--metrics-port N] [--metrics-file PATH [--metrics-interval S]] [--memoize MB]"
+                        " [--result-store] [--result-store-dir DIR] [--result-store-size MB]";
+  QCommandLineParser parser;
+  parser.addOptions({{"jobs", "Jobs that run at the same time", "N", "1"},
+                     {"socket", "Name of the local socket", "NAME", PipelineDaemon::GetDefaultServerName()},
+                     {"isolate", "Runs every job in a worker process"},
+                     {"max-jobs-per-worker", "Jobs after which a worker process is replaced", "N", "50"},
+                     {"max-worker-memory", "Memory above which a worker process is replaced", "MB", "0"},
+                     {"memoize", "Memory for the intermediate results the jobs share", "MB", "0"}});
+  AddResourceOptions(parser);
+  AddMetricsOptions(parser);
+  AddResultStoreOptions(parser);
+  QStringList arguments = app.arguments();
+  if(!ParseModeArguments(parser, arguments, usage))
+  {
+    return 1;
+  }
+  if(!parser.positionalArguments().isEmpty())
+  {
+    qDebug().noquote() << "Unexpected argument" << parser.positionalArguments().first();
+    PrintUsage(arguments, usage);
+    return 1;
+  }
+
+  int jobs = parser.value("jobs").toInt();
+  PipelineProcessPool::JobLimits limits;
+  PipelineProcessPool::Placement placement;
+  bool resourceOptionsGiven = false;
+  if(!ReadResourceOptions(parser, arguments, usage, limits, placement, resourceOptionsGiven))
+  {
+    return 1;
+  }
+  bool isolate = resourceOptionsGiven || parser.isSet("isolate");
+  int maxJobsPerWorker = parser.value("max-jobs-per-worker").toInt();
+  qint64 maxWorkerMemory = parser.value("max-worker-memory").toLongLong();
+  qint64 memoizeMB = parser.value("memoize").toLongLong();
+  QString serverName = parser.value("socket");
+  MetricsServer metrics;
+  ReadMetricsOptions(parser, metrics);
+  ReadResultStoreOptions(parser);
+
+  if(jobs > 1 && !isolate && !HeadlessPipelineRunner::IsHdf5ThreadSafe())
+  {
+    qDebug().noquote() << "--jobs above 1 needs --isolate because the HDF5 library is not thread safe";
+    PrintUsage(arguments, usage);
+    return 1;
+  }
+
+  SIMPLViewPluginLoader loader;
+  LoadHeadlessPlugins(loader);
+
+  // The pool and the cache have to outlive the jobs that the daemon still runs when it is destroyed
+  PipelineProcessPool pool;
+  FilterResultCache cache;
+  PipelineDaemon daemon;
+  daemon.setMaxJobs(jobs);
+
+  // The workers are forked before the daemon listens, so they do not hold on to the socket
+  bool isolated = isolate && StartProcessPool(pool, daemon.getMaxJobs(), maxJobsPerWorker, maxWorkerMemory, limits, placement);
+  if(isolated)
+  {
+    daemon.setProcessPool(&pool);
+  }
+  if(memoizeMB > 0)
+  {
+    if(isolated)
+    {
+      qDebug().noquote() << "--memoize is ignored because the jobs run in worker processes.";
+    }
+    else
+    {
+      cache.setMemoryBudget(memoizeMB);
+      daemon.setResultCache(&cache);
+    }
+  }
+  if(!metrics.startServing())
+  {
+    qDebug().noquote() << "Could not serve the metrics:" << metrics.getErrorString();
+    return 1;
+  }
+  if(!daemon.listen(serverName))
+  {
+    qDebug().noquote() << "Could not listen on" << serverName << ":" << daemon.getErrorString();
+    return 1;
+  }
+  qDebug().noquote() << "Pipeline daemon listening on" << serverName << "with" << daemon.getMaxJobs() << "job(s)";
+
+  return app.exec();
+}
+
+// -----------------------------------------------------------------------------
+// Runs a pipeline on every data file that appears in the watched directories:
+//   SIMPLView --watch --pipeline pipeline.json --input 0/InputFile
+//             [--output 12/OutputFile --output-dir DIR [--output-suffix .dream3d]]
+//             [--pattern *.ang ...] [--jobs N] [--max-queue N] [--settle S]
+//             [--ledger FILE] DIR [DIR ...]
+// The jobs run on threads of this process, so they execute one at a time unless the HDF5
+// library was built thread safe.
+// -----------------------------------------------------------------------------
+int RunWatch(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  const QString usage = " --watch --pipeline <pipeline file> --input <filter index>/<parameter>"
+                        " [--output <filter index>/<parameter> --output-dir DIR [--output-suffix SUFFIX]]"
+                        " [--pattern WILDCARD ...] [--jobs N] [--max-queue N] [--settle SECONDS] [--ledger FILE] <directory> [...]";
+  QCommandLineParser parser;
+  parser.addOptions({{"pipeline", "Pipeline that runs on every file", "FILE"},
+                     {"input", "Parameter that is set to the data file", "INDEX/PARAMETER"},
+                     {"output", "Parameter that is set to the output file", "INDEX/PARAMETER"},
+                     {"output-dir", "Directory of the output files", "DIR"},
+                     {"output-suffix", "Suffix of the output files", "SUFFIX", ".dream3d"},
+                     {"pattern", "Wildcard the data files match; may be repeated", "WILDCARD"},
+                     {"jobs", "Pipelines that run at the same time", "N"},
+                     {"max-queue", "Files that wait for a free job at most", "N"},
+                     {"settle", "Time a file has to stay unchanged", "SECONDS"},
+                     {"ledger", "File the finished runs are appended to", "FILE"}});
+  QStringList arguments = app.arguments();
+  if(!ParseModeArguments(parser, arguments, usage))
+  {
+    return 1;
+  }
+
+  WatchFolderIngestor ingestor;
+  QString pipelineFile = parser.isSet("pipeline") ? QFileInfo(parser.value("pipeline")).absoluteFilePath() : QString();
+  QString input = parser.value("input");
+  QString output = parser.value("output");
+  QString outputDir = parser.isSet("output-dir") ? parser.value("output-dir") : QDir::currentPath();
+  QString outputSuffix = parser.value("output-suffix");
+  QStringList nameFilters = parser.values("pattern");
+  QStringList directories = parser.positionalArguments();
+  if(parser.isSet("jobs"))
+  {
+    ingestor.setMaxJobs(parser.value("jobs").toInt());
+  }
+  if(parser.isSet("max-queue"))
+  {
+    ingestor.setMaxQueueLength(parser.value("max-queue").toInt());
+  }
+  if(parser.isSet("settle"))
+  {
+    ingestor.setSettleTime(static_cast<int>(parser.value("settle").toDouble() * 1000));
+  }
+  if(parser.isSet("ledger"))
+  {
+    ingestor.setLedgerFile(QFileInfo(parser.value("ledger")).absoluteFilePath());
+  }
+
+  // Parameters are named like the columns of a sweep's CSV file: <filter index>/<parameter>
+  if(pipelineFile.isEmpty() || input.indexOf('/') < 1 || (!output.isEmpty() && output.indexOf('/') < 1) || directories.isEmpty())
+  {
+    PrintUsage(arguments, usage);
+    return 1;
+  }
+
+  SIMPLViewPluginLoader loader;
+  LoadHeadlessPlugins(loader);
+
+  ingestor.setPipelineFile(pipelineFile);
+  ingestor.setInputParameter(input.section('/', 0, 0), input.section('/', 1));
+  if(!output.isEmpty())
+  {
+    QDir().mkpath(outputDir);
+    ingestor.setOutputParameter(output.section('/', 0, 0), output.section('/', 1), outputDir, outputSuffix);
+  }
+  ingestor.setNameFilters(nameFilters);
+  if(!ingestor.start(directories))
+  {
+    return 1;
+  }
+  qDebug().noquote() << "Watching" << directories.join(", ") << "with" << ingestor.getMaxJobs() << "job(s)";
+  if(ingestor.getMaxJobs() > 1 && !HeadlessPipelineRunner::IsHdf5ThreadSafe())
+  {
+    qDebug().noquote() << "The HDF5 library is not thread safe, so the pipelines run one at a time.";
+  }
+
+  return app.exec();
+}
+
+// -----------------------------------------------------------------------------
+// The secret a coordinator and its workers share when it is not given with --token
+// -----------------------------------------------------------------------------
+QString GetBatchTokenFromEnvironment()
+{
+  return QString::fromLocal8Bit(qgetenv("SIMPLVIEW_BATCH_TOKEN"));
+}
+
+// -----------------------------------------------------------------------------
+// Hands a batch of pipeline files to the workers that connect over TCP. The files
+// must be on storage that every worker sees under the same path. Only this host can
+// connect unless --listen says otherwise; workers must send the token either way.
+//   SIMPLView --coordinator [--listen ADDRESS] [--port N] [--heartbeat-timeout S]
+//             [--token SECRET] pipeline.json [...]
+// -----------------------------------------------------------------------------
+int RunCoordinator(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  const QString usage = " --coordinator [--listen ADDRESS] [--port N] [--heartbeat-timeout S] [--token SECRET] <pipeline file> [...]";
+  QCommandLineParser parser;
+  parser.addOptions({{"listen", "Address the workers connect to", "ADDRESS"},
+                     {"port", "Port the workers connect to", "N", "0"},
+                     {"heartbeat-timeout", "Time after which a silent worker is dropped", "S", "30"},
+                     {"token", "Secret the workers have to send", "SECRET", GetBatchTokenFromEnvironment()}});
+  QStringList arguments = app.arguments();
+  if(!ParseModeArguments(parser, arguments, usage))
+  {
+    return 1;
+  }
+
+  QHostAddress address = parser.isSet("listen") ? QHostAddress(parser.value("listen")) : QHostAddress(QHostAddress::LocalHost);
+  quint16 port = static_cast<quint16>(parser.value("port").toUInt());
+  int heartbeatTimeout = parser.value("heartbeat-timeout").toInt();
+  QString token = parser.value("token");
+  QVector<QJsonObject> jobs;
+  foreach(QString filePath, parser.positionalArguments())
+  {
+    QJsonObject job;
+    job["path"] = QFileInfo(filePath).absoluteFilePath();
+    jobs.push_back(job);
+  }
+
+  if(jobs.isEmpty())
+  {
+    PrintUsage(arguments, usage);
+    return 1;
+  }
+
+  // Without a token of its own the batch gets a random one, which the workers are given by hand
+  bool generatedToken = token.isEmpty();
+  if(generatedToken)
+  {
+    token = QString::fromLatin1(QUuid::createUuid().toRfc4122().toHex());
+  }
+
+  // The coordinator never executes a filter, so it does not load the plugins
+  BatchCoordinator coordinator;
+  coordinator.setJobs(jobs);
+  coordinator.setHeartbeatTimeout(heartbeatTimeout * 1000);
+  coordinator.setToken(token);
+  QObject::connect(&coordinator, &BatchCoordinator::finished, &app, &QCoreApplication::exit, Qt::QueuedConnection);
+  if(!coordinator.listen(address, port))
+  {
+    qDebug().noquote() << "Could not listen:" << coordinator.getErrorString();
+    return 2;
+  }
+  qDebug().noquote() << "Coordinator listening on port" << coordinator.getPort() << "with" << jobs.size() << "job(s)";
+  if(generatedToken)
+  {
+    qDebug().noquote() << "Workers must connect with --token" << token;
+  }
+
+  return app.exec();
+}
+
+// -----------------------------------------------------------------------------
+// Executes jobs of a coordinator until its batch is done. The token may also be set
+// with the SIMPLVIEW_BATCH_TOKEN environment variable.
+//   SIMPLView --worker --connect HOST:PORT --token SECRET [--jobs N]
+// The jobs run on threads of this process, so they execute one at a time unless the HDF5
+// library was built thread safe.
+// -----------------------------------------------------------------------------
+int RunWorker(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  const QString usage = " --worker --connect HOST:PORT --token SECRET [--jobs N]";
+  QCommandLineParser parser;
+  parser.addOptions({{"connect", "Address of the coordinator", "HOST:PORT"},
+                     {"token", "Secret of the batch", "SECRET", GetBatchTokenFromEnvironment()},
+                     {"jobs", "Jobs that run at the same time", "N", "1"}});
+  QStringList arguments = app.arguments();
+  if(!ParseModeArguments(parser, arguments, usage))
+  {
+    return 1;
+  }
+
+  QString target = parser.value("connect");
+  QString host = target.section(':', 0, -2);
+  quint16 port = static_cast<quint16>(target.section(':', -1).toUInt());
+  QString token = parser.value("token");
+  int jobs = parser.value("jobs").toInt();
+  if(host.isEmpty() || port == 0 || token.isEmpty() || jobs < 1 || !parser.positionalArguments().isEmpty())
+  {
+    PrintUsage(arguments, usage);
+    return 1;
+  }
+
+  SIMPLViewPluginLoader loader;
+  LoadHeadlessPlugins(loader);
+
+  // The coordinator hands out as many jobs as the worker has slots, so a worker that
+  // could only run them one after another must not ask for more
+  if(jobs > 1 && !HeadlessPipelineRunner::IsHdf5ThreadSafe())
+  {
+    qDebug().noquote() << "The HDF5 library is not thread safe, so the pipelines run one at a time.";
+    jobs = 1;
+  }
+
+  BatchWorker worker;
+  worker.setSlots(jobs);
+  worker.setToken(token);
+  QObject::connect(&worker, &BatchWorker::finished, &app, &QCoreApplication::exit, Qt::QueuedConnection);
+  if(!worker.connectToCoordinator(host, port))
+  {
+    qDebug().noquote() << "Could not connect to" << host << port << ":" << worker.getErrorString();
+    return 2;
+  }
+
+  return app.exec();
+}
+
+// -----------------------------------------------------------------------------
+// Sends pipeline files to a running daemon and waits for them:
+//   SIMPLView --submit [--socket NAME] [--overrides JSON] [--memory-limit MB] [--timeout S] <pipeline file> [...]
+// -----------------------------------------------------------------------------
+int SubmitToDaemon(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  const QString usage = " --submit [--socket NAME] [--overrides JSON] [--memory-limit MB] [--timeout S] <pipeline file> [...]";
+  QCommandLineParser parser;
+  parser.addOptions({{"socket", "Name of the daemon's local socket", "NAME", PipelineDaemon::GetDefaultServerName()},
+                     {"overrides", "Parameter values of every job", "JSON"},
+                     {"memory-limit", "Address space of every job", "MB"},
+                     {"timeout", "Time after which a job is killed", "S"}});
+  QStringList arguments = app.arguments();
+  if(!ParseModeArguments(parser, arguments, usage))
+  {
+    return 1;
+  }
+
+  QString serverName = parser.value("socket");
+  QJsonObject overrides;
+  if(parser.isSet("overrides"))
+  {
+    QJsonDocument document = QJsonDocument::fromJson(parser.value("overrides").toUtf8());
+    if(!document.isObject())
+    {
+      qDebug().noquote() << "--overrides needs a JSON object";
+      PrintUsage(arguments, usage);
+      return 1;
+    }
+    overrides = document.object();
+  }
+  QJsonObject limits;
+  if(parser.isSet("memory-limit"))
+  {
+    limits["memoryMB"] = parser.value("memory-limit").toDouble();
+  }
+  if(parser.isSet("timeout"))
+  {
+    limits["timeoutSec"] = parser.value("timeout").toInt();
+  }
+
+  QVector<QJsonObject> jobs;
+  foreach(QString filePath, parser.positionalArguments())
+  {
+    // The daemon does not share our working directory
+    QJsonObject job;
+    job["path"] = QFileInfo(filePath).absoluteFilePath();
+    job["overrides"] = overrides;
+    if(!limits.isEmpty())
+    {
+      job["limits"] = limits;
+    }
+    jobs.push_back(job);
+  }
+
+  if(jobs.isEmpty())
+  {
+    PrintUsage(arguments, usage);
+    return 1;
+  }
+
+  return PipelineDaemon::SubmitJobs(serverName, jobs);
+}
+
+// -----------------------------------------------------------------------------
+// Compares the recorded filter timings of two runs of a pipeline:
+//   SIMPLView --perf-report [--factor F] <pipeline file> [<run> <run>]
+// Lists the recorded runs and compares the two given ones, or the last two.
+// -----------------------------------------------------------------------------
+int RunPerformanceReport(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  const QString usage = " --perf-report [--factor F] <pipeline file> [<run> <run>]";
+  QCommandLineParser parser;
+  parser.addOption({"factor", "Slowdown above which a filter is reported", "F", QString::number(PerformanceHistory::Instance()->getSlowdownFactor())});
+  QStringList arguments = app.arguments();
+  if(!ParseModeArguments(parser, arguments, usage))
+  {
+    return 1;
+  }
+
+  double factor = parser.value("factor").toDouble();
+  QStringList positionalArguments = parser.positionalArguments();
+  QString pipelineFile = positionalArguments.value(0);
+  QVector<int> runNumbers;
+  for(int i = 1; i < positionalArguments.size(); i++)
+  {
+    runNumbers.push_back(positionalArguments[i].toInt());
+  }
+
+  if(pipelineFile.isEmpty() || (!runNumbers.isEmpty() && runNumbers.size() != 2) || factor < 1.0)
+  {
+    PrintUsage(arguments, usage);
+    return 1;
+  }
+
+  QVector<PerformanceHistory::Run> runs = PerformanceHistory::Instance()->readRuns(pipelineFile);
+  for(int i = 0; i < runs.size(); i++)
+  {
+    const PerformanceHistory::Run& run = runs[i];
+    QString status = (run.errorCode < 0) ? QString("FAILED (%1)").arg(run.errorCode) : QString("OK");
+    qDebug().noquote() << QString("%1: %2 on %3, %4 in %5 ms, plugins %6")
+                              .arg(i + 1, 4)
+                              .arg(QDateTime::fromMSecsSinceEpoch(run.time).toString(Qt::ISODate))
+                              .arg(run.host)
+                              .arg(status)
+                              .arg(run.elapsedMs)
+                              .arg(QString::fromLatin1(run.pluginsHash.left(8)));
+  }
+  if(runs.size() < 2)
+  {
+    qDebug().noquote() << "At least two runs of" << QDir::toNativeSeparators(pipelineFile) << "have to be recorded for a comparison";
+    return 1;
+  }
+
+  if(runNumbers.isEmpty())
+  {
+    runNumbers = {runs.size() - 1, runs.size()};
+  }
+  for(int number : runNumbers)
+  {
+    if(number < 1 || number > runs.size())
+    {
+      qDebug().noquote() << "There is no run" << number;
+      return 1;
+    }
+  }
+
+  qDebug().noquote() << "";
+  qDebug().noquote() << PerformanceHistory::CompareRuns(runs[runNumbers[0] - 1], runs[runNumbers[1] - 1], factor);
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Inspects and prunes the filter results that --result-store keeps on disk:
+//   SIMPLView --results [--result-store-dir DIR] [--result-store-size MB] [list | prune | clear]
+// list shows the stored states, the least recently used first. prune removes the least
+// recently used ones until the store fits its size, clear removes all of them.
+// -----------------------------------------------------------------------------
+int RunResults(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  const QString usage = " --results [--result-store-dir DIR] [--result-store-size MB] [list | prune | clear]";
+  QCommandLineParser parser;
+  AddResultStoreOptions(parser);
+  QStringList arguments = app.arguments();
+  if(!ParseModeArguments(parser, arguments, usage))
+  {
+    return 1;
+  }
+
+  QStringList positionalArguments = parser.positionalArguments();
+  QString command = positionalArguments.value(0, "list");
+  if(positionalArguments.size() > 1 || (command != "list" && command != "prune" && command != "clear"))
+  {
+    PrintUsage(arguments, usage);
+    return 1;
+  }
+  ReadResultStoreOptions(parser);
+
+  FilterResultStore* store = FilterResultStore::Instance();
+  QString directory = QDir::toNativeSeparators(store->getDirectory());
+  if(command == "prune")
+  {
+    qDebug().noquote() << "Removed" << store->collectGarbage() << "states from" << directory;
+  }
+  else if(command == "clear")
+  {
+    qDebug().noquote() << "Removed" << store->clear() << "states from" << directory;
+  }
+
+  QVector<FilterResultStore::Entry> entries = store->getEntries();
+  qint64 totalBytes = 0;
+  for(const FilterResultStore::Entry& entry : entries)
+  {
+    totalBytes += entry.bytes;
+    if(command == "list")
+    {
+      qDebug().noquote() << QString("%1  %2 MB  last used %3  after filter %4 (%5) of %6")
+                                .arg(QString::fromLatin1(entry.key.left(12)))
+                                .arg(entry.bytes / (1024.0 * 1024.0), 0, 'f', 1)
+                                .arg(QDateTime::fromMSecsSinceEpoch(entry.lastUsed).toString(Qt::ISODate))
+                                .arg(entry.filterIndex)
+                                .arg(entry.filterLabel)
+                                .arg(QDir::toNativeSeparators(entry.pipelinePath));
+    }
+  }
+  qDebug().noquote() << QString("%1 states, %2 of %3 MB in %4").arg(entries.size()).arg(totalBytes / (1024.0 * 1024.0), 0, 'f', 1).arg(store->getMaxSize()).arg(directory);
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Removes the option from the arguments and returns whether it was there
+// -----------------------------------------------------------------------------
+bool TakeOption(int& argc, char* argv[], const QString& option)
+{
+  for(int i = 1; i < argc; i++)
+  {
+    if(QString::fromLocal8Bit(argv[i]) == option)
+    {
+      for(int j = i; j < argc - 1; j++)
+      {
+        argv[j] = argv[j + 1];
+      }
+      argc--;
+      argv[argc] = nullptr;
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+// Hands the files on the command line to a SIMPLView that is already running, which
+// opens them in new windows. This launch can then exit without loading anything.
+// -----------------------------------------------------------------------------
+bool ForwardToRunningInstance(int argc, char* argv[])
+{
+  QCoreApplication probe(argc, argv);
+
+  QStringList filePaths;
+  QStringList arguments = probe.arguments();
+  for(int i = 1; i < arguments.size(); i++)
+  {
+    if(!arguments[i].startsWith("-"))
+    {
+      filePaths.push_back(QFileInfo(arguments[i]).absoluteFilePath());
+    }
+  }
+
+  return SingleInstanceServer::ForwardToRunningInstance(filePaths);
+}
+
+// -----------------------------------------------------------------------------
+// Starts the startup trace if --trace-startup=<file> was given or the environment
+// variable is set. The option is removed from the arguments so that the rest of
+// main() sees the same arguments as before.
+// -----------------------------------------------------------------------------
+void InitStartupTrace(int& argc, char* argv[])
+{
+  const QString option("--trace-startup=");
+  QString traceFilePath = QString::fromLocal8Bit(qgetenv(StartupTrace::GetEnvironmentVariableName().toLatin1().constData()));
+
+  for(int i = 1; i < argc; i++)
+  {
+    QString arg = QString::fromLocal8Bit(argv[i]);
+    if(arg.startsWith(option))
+    {
+      traceFilePath = arg.mid(option.size());
+      for(int j = i; j < argc - 1; j++)
+      {
+        argv[j] = argv[j + 1];
+      }
+      argc--;
+      argv[argc] = nullptr;
+      break;
+    }
+  }
+
+  if(!traceFilePath.isEmpty())
+  {
+    StartupTrace::Instance()->start(traceFilePath);
+  }
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
 int main(int argc, char* argv[])
 {
+  InitStartupTrace(argc, argv);
+
 #ifdef Q_OS_X11
   // Using motif style gives us test failures (and its ugly).
   // Using cleanlooks style gives us errors when using valgrind (Trolltech's bug #179200)
@@ -147,8 +1260,64 @@ int main(int argc, char* argv[])
   QCoreApplication::setOrganizationName(BrandedStrings::OrganizationName);
   QCoreApplication::setApplicationName(BrandedStrings::ApplicationName);
 
+  if(argc == 3 && QString::fromLatin1(argv[1]) == "--build-plugin-manifest")
+  {
+    return BuildPluginManifest(argc, argv, QString::fromLocal8Bit(argv[2]));
+  }
+
+  if(argc >= 2 && QString::fromLatin1(argv[1]) == "--headless")
+  {
+    return RunHeadless(argc, argv);
+  }
+  if(argc >= 2 && QString::fromLatin1(argv[1]) == "--sweep")
+  {
+    return RunSweep(argc, argv);
+  }
+  if(argc >= 2 && QString::fromLatin1(argv[1]) == "--daemon")
+  {
+    return RunDaemon(argc, argv);
+  }
+  if(argc >= 2 && QString::fromLatin1(argv[1]) == "--watch")
+  {
+    return RunWatch(argc, argv);
+  }
+  if(argc >= 2 && QString::fromLatin1(argv[1]) == "--coordinator")
+  {
+    return RunCoordinator(argc, argv);
+  }
+  if(argc >= 2 && QString::fromLatin1(argv[1]) == "--worker")
+  {
+    return RunWorker(argc, argv);
+  }
+  if(argc >= 2 && QString::fromLatin1(argv[1]) == "--submit")
+  {
+    return SubmitToDaemon(argc, argv);
+  }
+  if(argc >= 2 && QString::fromLatin1(argv[1]) == "--perf-report")
+  {
+    return RunPerformanceReport(argc, argv);
+  }
+  if(argc >= 2 && QString::fromLatin1(argv[1]) == "--results")
+  {
+    return RunResults(argc, argv);
+  }
+
+#if !defined(Q_OS_MAC)
+  // --new-instance starts a separate process even if SIMPLView is already running
+  if(!TakeOption(argc, argv, "--new-instance") && ForwardToRunningInstance(argc, argv))
+  {
+    return 0;
+  }
+#endif
+
   SIMPLViewApplication qtapp(argc, argv);
 
+  // Rewrite the trace on exit so that it also holds the spans recorded after the first paint
+  if(StartupTrace::IsEnabled())
+  {
+    QObject::connect(&qtapp, &QCoreApplication::aboutToQuit, [] { StartupTrace::Instance()->write(); });
+  }
+
   if(!qtapp.initialize(argc, argv))
   {
     return 1;
@@ -195,25 +1364,15 @@ int main(int argc, char* argv[])
   InitStyleSheetEditor();
 #endif
 
-  // Open pipeline if SIMPLView was opened from a compatible file
+  // Build the first window while the plugins load. It is shown, and the pipeline
+  // opened if SIMPLView was opened from a compatible file, once the plugins are ready.
+  QString filePath;
   if(argc == 2)
   {
     char* two = argv[1];
-    QString filePath = QString::fromLatin1(two);
-    if(!filePath.isEmpty())
-    {
-      qtapp.newInstanceFromFile(filePath);
-    }
+    filePath = QString::fromLatin1(two);
   }
-  else
-  {
-    SIMPLView_UI* ui = qtapp.getNewSIMPLViewInstance();
-    ui->show();
-  }
-
-#ifdef SIMPL_USE_MKDOCS
-  QtSDocServer::Instance();
-#endif
+  qtapp.startFirstInstance(filePath);
 
   int err = qtapp.exec();
   return err;
@@ -0,0 +1,243 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QStringList>
+
+#include "SIMPLib/FilterParameters/JsonFilterParametersReader.h"
+#include "SIMPLib/Utilities/QMetaObjectUtilities.h"
+#include "SIMPLib/Utilities/UnitTestSupport.hpp"
+
+#include "SIMPLView/FilterResultCache.h"
+
+#include "SIMPLViewTestFileLocations.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject createDataContainerFilter(const QString& name, bool enabled = true)
+{
+  QJsonObject filter;
+  filter["Filter_Name"] = QString("CreateDataContainer");
+  filter["Filter_Enabled"] = enabled;
+  filter["CreatedDataContainer"] = name;
+  return filter;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject writerFilter(const QString& outputFile)
+{
+  QJsonObject filter;
+  filter["Filter_Name"] = QString("DataContainerWriter");
+  filter["Filter_Enabled"] = true;
+  filter["OutputFile"] = outputFile;
+  filter["WriteXdmfFile"] = 0;
+  filter["WriteTimeSeries"] = 0;
+  return filter;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterPipeline::Pointer readPipeline(const QVector<QJsonObject>& filters)
+{
+  QJsonObject root;
+  for(int i = 0; i < filters.size(); i++)
+  {
+    root[QString::number(i)] = filters[i];
+  }
+
+  QJsonObject builder;
+  builder["Name"] = QString("FilterResultCacheTest");
+  builder["Number_Filters"] = filters.size();
+  root["PipelineBuilder"] = builder;
+
+  JsonFilterParametersReader::Pointer reader = JsonFilterParametersReader::New();
+  return reader->readPipelineFromString(QString::fromUtf8(QJsonDocument(root).toJson()));
+}
+
+// -----------------------------------------------------------------------------
+// One filter per name that creates a data container with that name
+// -----------------------------------------------------------------------------
+FilterPipeline::FilterContainerType createFilters(const QStringList& names, int disabledIndex = -1)
+{
+  QVector<QJsonObject> filters;
+  for(int i = 0; i < names.size(); i++)
+  {
+    filters.push_back(createDataContainerFilter(names[i], i != disabledIndex));
+  }
+
+  FilterPipeline::Pointer pipeline = readPipeline(filters);
+  if(pipeline.get() == nullptr)
+  {
+    return FilterPipeline::FilterContainerType();
+  }
+  return pipeline->getFilterContainer();
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void RemoveTestFiles()
+{
+#if REMOVE_TEST_FILES
+  QDir(UnitTest::FilterResultCacheTest::TestDir).removeRecursively();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestComputeKeys()
+{
+  QVector<QByteArray> keys = FilterResultCache::ComputeKeys(createFilters({"A", "B"}));
+  DREAM3D_REQUIRE_EQUAL(keys.size(), 2)
+  DREAM3D_REQUIRE(keys[0] != keys[1])
+
+  // The same filters with the same parameters give the same keys
+  DREAM3D_REQUIRE(FilterResultCache::ComputeKeys(createFilters({"A", "B"})) == keys)
+
+  // A filter that changed changes its own key and every key after it
+  QVector<QByteArray> upstreamChanged = FilterResultCache::ComputeKeys(createFilters({"X", "B"}));
+  DREAM3D_REQUIRE_EQUAL(upstreamChanged.size(), 2)
+  DREAM3D_REQUIRE(upstreamChanged[0] != keys[0])
+  DREAM3D_REQUIRE(upstreamChanged[1] != keys[1])
+
+  // The filters before it keep their keys
+  QVector<QByteArray> downstreamChanged = FilterResultCache::ComputeKeys(createFilters({"A", "C"}));
+  DREAM3D_REQUIRE_EQUAL(downstreamChanged.size(), 2)
+  DREAM3D_REQUIRE(downstreamChanged[0] == keys[0])
+  DREAM3D_REQUIRE(downstreamChanged[1] != keys[1])
+
+  // Disabling a filter changes the state after it
+  QVector<QByteArray> disabled = FilterResultCache::ComputeKeys(createFilters({"A", "B"}, 0));
+  DREAM3D_REQUIRE_EQUAL(disabled.size(), 2)
+  DREAM3D_REQUIRE(disabled[0] != keys[0])
+  DREAM3D_REQUIRE(disabled[1] != keys[1])
+
+  DREAM3D_REQUIRE(FilterResultCache::ComputeKeys(FilterPipeline::FilterContainerType()).isEmpty())
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestCanSkip()
+{
+  FilterPipeline::Pointer pipeline = readPipeline({createDataContainerFilter("A"), writerFilter(UnitTest::FilterResultCacheTest::OutputFile)});
+  DREAM3D_REQUIRE_VALID_POINTER(pipeline.get())
+  FilterPipeline::FilterContainerType filters = pipeline->getFilterContainer();
+  DREAM3D_REQUIRE_EQUAL(filters.size(), 2)
+
+  DREAM3D_REQUIRE(FilterResultCache::CanSkip(filters[0]))
+
+  // Whether the file on disk is still the one this pipeline wrote cannot be told
+  DREAM3D_REQUIRE(!FilterResultCache::CanSkip(filters[1]))
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestExecute()
+{
+  RemoveTestFiles();
+  QDir().mkpath(UnitTest::FilterResultCacheTest::TestDir);
+
+  FilterResultCache cache;
+  cache.setMemoryBudget(64);
+  cache.setMinSnapshotWork(0);
+
+  // The first run has nothing to resume from
+  QVector<int> cachedFilters;
+  FilterPipeline::Pointer pipeline = readPipeline({createDataContainerFilter("A"), createDataContainerFilter("B")});
+  DREAM3D_REQUIRE_VALID_POINTER(pipeline.get())
+  DREAM3D_REQUIRE(cache.execute(pipeline, QString(), nullptr, cachedFilters) >= 0)
+  DREAM3D_REQUIRE(cachedFilters.isEmpty())
+
+  // The same pipeline resumes after its last filter
+  pipeline = readPipeline({createDataContainerFilter("A"), createDataContainerFilter("B")});
+  DREAM3D_REQUIRE(cache.execute(pipeline, QString(), nullptr, cachedFilters) >= 0)
+  DREAM3D_REQUIRE(cachedFilters == QVector<int>({0, 1}))
+
+  // A changed filter runs again
+  pipeline = readPipeline({createDataContainerFilter("A"), createDataContainerFilter("C")});
+  DREAM3D_REQUIRE(cache.execute(pipeline, QString(), nullptr, cachedFilters) >= 0)
+  DREAM3D_REQUIRE(!cachedFilters.contains(1))
+
+  // A writer runs again even though its output exists, and so does everything after it
+  QVector<QJsonObject> withWriter = {createDataContainerFilter("A"), writerFilter(UnitTest::FilterResultCacheTest::OutputFile), createDataContainerFilter("B")};
+  pipeline = readPipeline(withWriter);
+  DREAM3D_REQUIRE(cache.execute(pipeline, QString(), nullptr, cachedFilters) >= 0)
+  DREAM3D_REQUIRE(QFileInfo::exists(UnitTest::FilterResultCacheTest::OutputFile))
+
+  QFile::remove(UnitTest::FilterResultCacheTest::OutputFile);
+  pipeline = readPipeline(withWriter);
+  DREAM3D_REQUIRE(cache.execute(pipeline, QString(), nullptr, cachedFilters) >= 0)
+  DREAM3D_REQUIRE(!cachedFilters.contains(1))
+  DREAM3D_REQUIRE(!cachedFilters.contains(2))
+  DREAM3D_REQUIRE(QFileInfo::exists(UnitTest::FilterResultCacheTest::OutputFile))
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//  Use test framework
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+  QMetaObjectUtilities::RegisterMetaTypes();
+
+  int err = EXIT_SUCCESS;
+
+  DREAM3D_REGISTER_TEST(TestComputeKeys())
+  DREAM3D_REGISTER_TEST(TestCanSkip())
+  DREAM3D_REGISTER_TEST(TestExecute())
+
+  DREAM3D_REGISTER_TEST(RemoveTestFiles())
+
+  PRINT_TEST_SUMMARY();
+  return err;
+}
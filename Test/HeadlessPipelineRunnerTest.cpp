@@ -0,0 +1,164 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include "SIMPLib/Utilities/QMetaObjectUtilities.h"
+#include "SIMPLib/Utilities/UnitTestSupport.hpp"
+
+#include "SIMPLView/HeadlessPipelineRunner.h"
+
+#include "SIMPLViewTestFileLocations.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject createDataContainerFilter(const QString& name)
+{
+  QJsonObject filter;
+  filter["Filter_Name"] = QString("CreateDataContainer");
+  filter["CreatedDataContainer"] = name;
+  return filter;
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void RemoveTestFiles()
+{
+#if REMOVE_TEST_FILES
+  QDir(UnitTest::HeadlessPipelineRunnerTest::TestDir).removeRecursively();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestApplyOverrides()
+{
+  QJsonObject filter = createDataContainerFilter("DataContainer");
+  filter["Filter_Enabled"] = true;
+  QJsonObject root;
+  root["0"] = filter;
+
+  QJsonObject renamed;
+  renamed["CreatedDataContainer"] = QString("ImageDataContainer");
+  QJsonObject added;
+  added["CreatedDataContainer"] = QString("Other");
+  QJsonObject overrides;
+  overrides["0"] = renamed;
+  overrides["1"] = added;
+
+  HeadlessPipelineRunner::ApplyOverrides(root, overrides);
+
+  // Parameters that are not overridden are kept
+  QJsonObject first = root["0"].toObject();
+  DREAM3D_REQUIRE(first["CreatedDataContainer"].toString() == "ImageDataContainer")
+  DREAM3D_REQUIRE(first["Filter_Name"].toString() == "CreateDataContainer")
+  DREAM3D_REQUIRE(first["Filter_Enabled"].toBool())
+
+  QJsonObject second = root["1"].toObject();
+  DREAM3D_REQUIRE(second["CreatedDataContainer"].toString() == "Other")
+
+  // No overrides leave the pipeline as it is
+  QJsonObject unchanged = root;
+  HeadlessPipelineRunner::ApplyOverrides(root, QJsonObject());
+  DREAM3D_REQUIRE(root == unchanged)
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestReadPipeline()
+{
+  RemoveTestFiles();
+  DREAM3D_REQUIRE(QDir().mkpath(UnitTest::HeadlessPipelineRunnerTest::TestDir))
+
+  QJsonObject builder;
+  builder["Name"] = QString("HeadlessPipelineRunnerTest");
+  builder["Number_Filters"] = 1;
+  QJsonObject root;
+  root["0"] = createDataContainerFilter("DataContainer");
+  root["PipelineBuilder"] = builder;
+
+  QFile file(UnitTest::HeadlessPipelineRunnerTest::PipelineFile);
+  DREAM3D_REQUIRE(file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  file.write(QJsonDocument(root).toJson());
+  file.close();
+
+  FilterPipeline::Pointer pipeline = HeadlessPipelineRunner::ReadPipeline(UnitTest::HeadlessPipelineRunnerTest::PipelineFile);
+  DREAM3D_REQUIRE_VALID_POINTER(pipeline.get())
+  DREAM3D_REQUIRE_EQUAL(pipeline->size(), 1)
+  DREAM3D_REQUIRE(pipeline->getFilterContainer().front()->property("CreatedDataContainer").toString() == "DataContainer")
+
+  QJsonObject renamed;
+  renamed["CreatedDataContainer"] = QString("ImageDataContainer");
+  QJsonObject overrides;
+  overrides["0"] = renamed;
+  pipeline = HeadlessPipelineRunner::ReadPipeline(UnitTest::HeadlessPipelineRunnerTest::PipelineFile, overrides);
+  DREAM3D_REQUIRE_VALID_POINTER(pipeline.get())
+  DREAM3D_REQUIRE(pipeline->getFilterContainer().front()->property("CreatedDataContainer").toString() == "ImageDataContainer")
+
+  // A missing file gives no pipeline
+  pipeline = HeadlessPipelineRunner::ReadPipeline(UnitTest::HeadlessPipelineRunnerTest::TestDir + "/Missing.json");
+  DREAM3D_REQUIRE_NULL_POINTER(pipeline.get())
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//  Use test framework
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+  QMetaObjectUtilities::RegisterMetaTypes();
+
+  int err = EXIT_SUCCESS;
+
+  DREAM3D_REGISTER_TEST(TestApplyOverrides())
+  DREAM3D_REGISTER_TEST(TestReadPipeline())
+
+  DREAM3D_REGISTER_TEST(RemoveTestFiles())
+  PRINT_TEST_SUMMARY();
+  return err;
+}
@@ -0,0 +1,243 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include "SIMPLib/Utilities/QMetaObjectUtilities.h"
+#include "SIMPLib/Utilities/UnitTestSupport.hpp"
+
+#include "SIMPLView/ParameterSweep.h"
+
+#include "SIMPLViewTestFileLocations.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool writeTestFile(const QString& filePath, const QByteArray& contents)
+{
+  QFile file(filePath);
+  if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    return false;
+  }
+  return file.write(contents) == contents.size();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject overrideOf(const QString& filterKey, const QString& parameter, const QJsonValue& value)
+{
+  QJsonObject parameters;
+  parameters[parameter] = value;
+  QJsonObject overrides;
+  overrides[filterKey] = parameters;
+  return overrides;
+}
+
+// -----------------------------------------------------------------------------
+// Two filters that each create a data container with the given name
+// -----------------------------------------------------------------------------
+bool writePipeline(const QString& firstName, const QString& secondName)
+{
+  QJsonObject root;
+  QStringList names = {firstName, secondName};
+  for(int i = 0; i < names.size(); i++)
+  {
+    QJsonObject filter;
+    filter["Filter_Name"] = QString("CreateDataContainer");
+    filter["CreatedDataContainer"] = names[i];
+    root[QString::number(i)] = filter;
+  }
+
+  QJsonObject builder;
+  builder["Name"] = QString("ParameterSweepTest");
+  builder["Number_Filters"] = names.size();
+  root["PipelineBuilder"] = builder;
+  return writeTestFile(UnitTest::ParameterSweepTest::PipelineFile, QJsonDocument(root).toJson());
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void RemoveTestFiles()
+{
+#if REMOVE_TEST_FILES
+  QDir(UnitTest::ParameterSweepTest::TestDir).removeRecursively();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestExpandGrid()
+{
+  QJsonObject grid = overrideOf("5", "MinAllowedDefectSize", QJsonArray({10, 20, 40}));
+  grid["7"] = QJsonObject({{"Tolerance", QJsonArray({0.5, 1.0})}});
+
+  // The last parameter varies fastest
+  QVector<QJsonObject> variants = ParameterSweep::ExpandGrid(grid);
+  DREAM3D_REQUIRE_EQUAL(variants.size(), 6)
+  DREAM3D_REQUIRE_EQUAL(variants[0]["5"].toObject()["MinAllowedDefectSize"].toInt(), 10)
+  DREAM3D_REQUIRE_EQUAL(variants[0]["7"].toObject()["Tolerance"].toDouble(), 0.5)
+  DREAM3D_REQUIRE_EQUAL(variants[1]["5"].toObject()["MinAllowedDefectSize"].toInt(), 10)
+  DREAM3D_REQUIRE_EQUAL(variants[1]["7"].toObject()["Tolerance"].toDouble(), 1.0)
+  DREAM3D_REQUIRE_EQUAL(variants[5]["5"].toObject()["MinAllowedDefectSize"].toInt(), 40)
+  DREAM3D_REQUIRE_EQUAL(variants[5]["7"].toObject()["Tolerance"].toDouble(), 1.0)
+
+  // A single value is an axis with one entry
+  QJsonObject scalar = grid;
+  scalar["7"] = QJsonObject({{"Tolerance", 0.25}});
+  variants = ParameterSweep::ExpandGrid(scalar);
+  DREAM3D_REQUIRE_EQUAL(variants.size(), 3)
+  DREAM3D_REQUIRE_EQUAL(variants[2]["7"].toObject()["Tolerance"].toDouble(), 0.25)
+
+  // An empty axis has no combinations
+  QJsonObject empty = grid;
+  empty["7"] = QJsonObject({{"Tolerance", QJsonArray()}});
+  DREAM3D_REQUIRE(ParameterSweep::ExpandGrid(empty).isEmpty())
+
+  // No grid is a single run without overrides
+  variants = ParameterSweep::ExpandGrid(QJsonObject());
+  DREAM3D_REQUIRE_EQUAL(variants.size(), 1)
+  DREAM3D_REQUIRE(variants[0].isEmpty())
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestReadOverridesFile()
+{
+  RemoveTestFiles();
+  DREAM3D_REQUIRE(QDir().mkpath(UnitTest::ParameterSweepTest::TestDir))
+
+  QString errorMessage;
+  QJsonObject grid = overrideOf("1", "CreatedDataContainer", QJsonArray({"B", "C"}));
+  DREAM3D_REQUIRE(writeTestFile(UnitTest::ParameterSweepTest::GridFile, QJsonDocument(grid).toJson()))
+  QVector<QJsonObject> variants = ParameterSweep::ReadOverridesFile(UnitTest::ParameterSweepTest::GridFile, errorMessage);
+  DREAM3D_REQUIRE(errorMessage.isEmpty())
+  DREAM3D_REQUIRE_EQUAL(variants.size(), 2)
+  DREAM3D_REQUIRE(variants[1]["1"].toObject()["CreatedDataContainer"].toString() == "C")
+
+  // Cells that parse as JSON keep their type, everything else is a string
+  QByteArray csv = "5/MinAllowedDefectSize, 5/Name, 7/Spacing\n"
+                   "10, \"Grain, Small\", \"[1, 2, 3]\"\n"
+                   "\n"
+                   "20, Large, true\n";
+  DREAM3D_REQUIRE(writeTestFile(UnitTest::ParameterSweepTest::CsvFile, csv))
+  variants = ParameterSweep::ReadOverridesFile(UnitTest::ParameterSweepTest::CsvFile, errorMessage);
+  DREAM3D_REQUIRE(errorMessage.isEmpty())
+  DREAM3D_REQUIRE_EQUAL(variants.size(), 2)
+  DREAM3D_REQUIRE_EQUAL(variants[0]["5"].toObject()["MinAllowedDefectSize"].toInt(), 10)
+  DREAM3D_REQUIRE(variants[0]["5"].toObject()["Name"].toString() == "Grain, Small")
+  DREAM3D_REQUIRE(variants[0]["7"].toObject()["Spacing"].toArray() == QJsonArray({1, 2, 3}))
+  DREAM3D_REQUIRE(variants[1]["5"].toObject()["Name"].toString() == "Large")
+  DREAM3D_REQUIRE(variants[1]["7"].toObject()["Spacing"].toBool())
+
+  DREAM3D_REQUIRE(writeTestFile(UnitTest::ParameterSweepTest::CsvFile, "MinAllowedDefectSize\n10\n"))
+  variants = ParameterSweep::ReadOverridesFile(UnitTest::ParameterSweepTest::CsvFile, errorMessage);
+  DREAM3D_REQUIRE(variants.isEmpty())
+  DREAM3D_REQUIRE(!errorMessage.isEmpty())
+
+  errorMessage.clear();
+  DREAM3D_REQUIRE(writeTestFile(UnitTest::ParameterSweepTest::GridFile, "[1, 2]"))
+  variants = ParameterSweep::ReadOverridesFile(UnitTest::ParameterSweepTest::GridFile, errorMessage);
+  DREAM3D_REQUIRE(variants.isEmpty())
+  DREAM3D_REQUIRE(!errorMessage.isEmpty())
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestSharedFiltersRunOnce()
+{
+  RemoveTestFiles();
+  DREAM3D_REQUIRE(QDir().mkpath(UnitTest::ParameterSweepTest::TestDir))
+  DREAM3D_REQUIRE(writePipeline("A", "B"))
+
+  // The first filter is the same for every variant
+  ParameterSweep sweep;
+  sweep.setPipelineFile(UnitTest::ParameterSweepTest::PipelineFile);
+  sweep.setOutputDirectory(UnitTest::ParameterSweepTest::TestDir);
+  sweep.setOverrides(ParameterSweep::ExpandGrid(overrideOf("1", "CreatedDataContainer", QJsonArray({"B", "C", "D"}))));
+  DREAM3D_REQUIRE_EQUAL(sweep.run(), 0)
+  DREAM3D_REQUIRE_EQUAL(sweep.getFilterExecutionCount(), 4)
+  DREAM3D_REQUIRE(QFile::exists(UnitTest::ParameterSweepTest::TestDir + "/SweepSummary.csv"))
+
+  // Variants that only differ in their name do not share the filter with the placeholder
+  DREAM3D_REQUIRE(writePipeline("A", "@VARIANT@"))
+  sweep.setOverrides(QVector<QJsonObject>(2));
+  DREAM3D_REQUIRE_EQUAL(sweep.run(), 0)
+  DREAM3D_REQUIRE_EQUAL(sweep.getFilterExecutionCount(), 3)
+
+  // A variant that fails to preflight is reported and the others still run
+  DREAM3D_REQUIRE(writePipeline("A", "B"))
+  sweep.setOverrides(ParameterSweep::ExpandGrid(overrideOf("1", "CreatedDataContainer", QJsonArray({"B", "A"}))));
+  DREAM3D_REQUIRE_EQUAL(sweep.run(), 1)
+  DREAM3D_REQUIRE_EQUAL(sweep.getFilterExecutionCount(), 2)
+  QVector<ParameterSweep::Variant> variants = sweep.getVariants();
+  DREAM3D_REQUIRE_EQUAL(variants[0].errorCode, 0)
+  DREAM3D_REQUIRE(variants[1].errorCode < 0)
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//  Use test framework
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+  QMetaObjectUtilities::RegisterMetaTypes();
+
+  int err = EXIT_SUCCESS;
+
+  DREAM3D_REGISTER_TEST(TestExpandGrid())
+  DREAM3D_REGISTER_TEST(TestReadOverridesFile())
+  DREAM3D_REGISTER_TEST(TestSharedFiltersRunOnce())
+
+  DREAM3D_REGISTER_TEST(RemoveTestFiles())
+  PRINT_TEST_SUMMARY();
+  return err;
+}
@@ -0,0 +1,233 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+
+#include "SIMPLib/Utilities/UnitTestSupport.hpp"
+
+#include "SIMPLView/PerformanceHistory.h"
+
+#include "SIMPLViewTestFileLocations.h"
+
+namespace
+{
+const QString k_Host("TestHost");
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PerformanceHistory::FilterEntry filterEntry(int index, const QString& uuid, const QByteArray& parameterHash, qint64 wallUs)
+{
+  PerformanceHistory::FilterEntry filter;
+  filter.index = index;
+  filter.filterUuid = uuid;
+  filter.label = QString("Filter %1").arg(uuid);
+  filter.parameterHash = parameterHash;
+  filter.wallUs = wallUs;
+  filter.cpuUs = wallUs;
+  return filter;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PerformanceHistory::Run historyRun(qint64 inputBytes, const QVector<PerformanceHistory::FilterEntry>& filters)
+{
+  PerformanceHistory::Run run;
+  run.time = 1500000000000;
+  run.host = k_Host;
+  run.pipelinePath = UnitTest::PerformanceHistoryTest::TestDir + "/Pipeline.json";
+  run.pipelineHash = "pipeline";
+  run.pluginsHash = "plugins";
+  run.inputBytes = inputBytes;
+  run.filters = filters;
+  return run;
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void RemoveTestFiles()
+{
+#if REMOVE_TEST_FILES
+  QDir(UnitTest::PerformanceHistoryTest::TestDir).removeRecursively();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestEstimateFilters()
+{
+  RemoveTestFiles();
+  PerformanceHistory* history = PerformanceHistory::Instance();
+  history->setFilePath(UnitTest::PerformanceHistoryTest::HistoryFile);
+  history->setEnabled(true);
+
+  DREAM3D_REQUIRE(history->append(historyRun(1000, {filterEntry(0, "A", "p1", 1000000)})))
+  DREAM3D_REQUIRE(history->append(historyRun(1000, {filterEntry(0, "A", "p1", 9000000)})))
+  DREAM3D_REQUIRE(history->append(historyRun(1000, {filterEntry(0, "A", "p1", 2000000)})))
+
+  // Failed runs are not samples
+  PerformanceHistory::Run failed = historyRun(1000, {filterEntry(0, "A", "p1", 100)});
+  failed.errorCode = -1;
+  DREAM3D_REQUIRE(history->append(failed))
+
+  PerformanceHistory::FilterEntry disabled = filterEntry(3, "A", "p1", -1);
+  disabled.enabled = false;
+  PerformanceHistory::Run run = historyRun(2000, {filterEntry(0, "A", "p1", -1), filterEntry(1, "A", "p2", -1), filterEntry(2, "B", "p1", -1), disabled});
+
+  // The median of the samples, scaled to twice the input size. Other parameters of the same
+  // filter fall back to all of its samples.
+  QVector<qint64> estimates = history->estimateFilters(run);
+  DREAM3D_REQUIRE(estimates == QVector<qint64>({4000000, 4000000, -1, 0}))
+
+  // Samples from another host do not count
+  run.host = "OtherHost";
+  estimates = history->estimateFilters(run);
+  DREAM3D_REQUIRE(estimates == QVector<qint64>({-1, -1, -1, 0}))
+
+  // Runs appended later are read as well
+  DREAM3D_REQUIRE(history->append(historyRun(1000, {filterEntry(0, "B", "p1", 3000000)})))
+  run.host = k_Host;
+  estimates = history->estimateFilters(run);
+  DREAM3D_REQUIRE_EQUAL(estimates[2], 6000000)
+
+  DREAM3D_REQUIRE_EQUAL(history->readRuns(run.pipelinePath).size(), 5)
+  DREAM3D_REQUIRE(history->readRuns(UnitTest::PerformanceHistoryTest::TestDir + "/Other.json").isEmpty())
+
+  // Nothing is recorded while recording is off
+  history->setEnabled(false);
+  DREAM3D_REQUIRE(history->append(historyRun(1000, {filterEntry(0, "A", "p1", 1000000)})))
+  history->setEnabled(true);
+  DREAM3D_REQUIRE_EQUAL(history->readRuns(run.pipelinePath).size(), 5)
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestRotation()
+{
+  PerformanceHistory* history = PerformanceHistory::Instance();
+  history->setFilePath(UnitTest::PerformanceHistoryTest::RotatedHistoryFile);
+  history->setEnabled(true);
+
+  // Every append past the first one rotates the file
+  qint64 maxFileSize = history->getMaxFileSize();
+  history->setMaxFileSize(1);
+  DREAM3D_REQUIRE(history->append(historyRun(1000, {filterEntry(0, "A", "p1", 1000000)})))
+  DREAM3D_REQUIRE(history->append(historyRun(1000, {filterEntry(0, "A", "p1", 2000000)})))
+  DREAM3D_REQUIRE(QFileInfo::exists(history->getRotatedFilePath()))
+  DREAM3D_REQUIRE_EQUAL(history->readRuns(UnitTest::PerformanceHistoryTest::TestDir + "/Pipeline.json").size(), 2)
+
+  // Only two generations are kept
+  DREAM3D_REQUIRE(history->append(historyRun(1000, {filterEntry(0, "A", "p1", 1000000)})))
+  QVector<PerformanceHistory::Run> runs = history->readRuns(UnitTest::PerformanceHistoryTest::TestDir + "/Pipeline.json");
+  DREAM3D_REQUIRE_EQUAL(runs.size(), 2)
+  DREAM3D_REQUIRE_EQUAL(runs[0].filters[0].wallUs, 2000000)
+  DREAM3D_REQUIRE_EQUAL(runs[1].filters[0].wallUs, 1000000)
+
+  // The estimates include the samples of the rotated file
+  QVector<qint64> estimates = history->estimateFilters(historyRun(1000, {filterEntry(0, "A", "p1", -1)}));
+  DREAM3D_REQUIRE_EQUAL(estimates[0], 2000000)
+
+  history->setMaxFileSize(maxFileSize);
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestFindSlowFilters()
+{
+  PerformanceHistory* history = PerformanceHistory::Instance();
+  history->setSlowdownFactor(3.0);
+
+  PerformanceHistory::Run run = historyRun(1000, {filterEntry(0, "A", "p1", 12000000), filterEntry(1, "B", "p1", 5000000), filterEntry(2, "C", "p1", 900000),
+                                                  filterEntry(3, "D", "p1", 8000000)});
+  QVector<qint64> estimates = {4000000, 4000000, 100, -1};
+
+  // Filter 2 is too short to matter and nothing is known about filter 3
+  QStringList messages = history->findSlowFilters(run, estimates);
+  DREAM3D_REQUIRE_EQUAL(messages.size(), 1)
+  DREAM3D_REQUIRE(messages[0].startsWith("Filter 0 "))
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestCompareRuns()
+{
+  PerformanceHistory::Run before = historyRun(1000, {filterEntry(0, "A", "p1", 1000000), filterEntry(1, "B", "p1", 2000000), filterEntry(2, "C", "p1", 1000000)});
+  PerformanceHistory::Run after = historyRun(2000, {filterEntry(0, "A", "p1", 4000000), filterEntry(1, "B", "p2", 500000), filterEntry(2, "D", "p1", 1100000)});
+  after.pluginsHash = "upgraded";
+
+  QString text = PerformanceHistory::CompareRuns(before, after, 3.0);
+  DREAM3D_REQUIRE(text.contains("The plugins changed between the runs."))
+  DREAM3D_REQUIRE(!text.contains("The pipeline changed between the runs."))
+  DREAM3D_REQUIRE(text.contains("The inputs changed from 1000 to 2000 bytes."))
+
+  QStringList lines = text.split('\n');
+  QStringList filterLines = lines.filter("Filter ");
+  DREAM3D_REQUIRE_EQUAL(filterLines.size(), 3)
+  DREAM3D_REQUIRE(filterLines[0].endsWith("+300%  SLOWER"))
+  DREAM3D_REQUIRE(filterLines[1].endsWith("-75%  FASTER  (parameters changed)"))
+  DREAM3D_REQUIRE(filterLines[2].endsWith("+10%  (different filter)"))
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//  Use test framework
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+
+  int err = EXIT_SUCCESS;
+
+  DREAM3D_REGISTER_TEST(TestEstimateFilters())
+  DREAM3D_REGISTER_TEST(TestRotation())
+  DREAM3D_REGISTER_TEST(TestFindSlowFilters())
+  DREAM3D_REGISTER_TEST(TestCompareRuns())
+
+  DREAM3D_REGISTER_TEST(RemoveTestFiles())
+  PRINT_TEST_SUMMARY();
+  return err;
+}
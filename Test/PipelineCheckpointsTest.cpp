@@ -0,0 +1,78 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <QtCore/QVector>
+
+#include "SIMPLib/Utilities/UnitTestSupport.hpp"
+
+#include "SIMPLView/PipelineCheckpoints.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestParseFilterIndices()
+{
+  QVector<int> indices;
+  DREAM3D_REQUIRE(PipelineCheckpoints::ParseFilterIndices("3,7-8", 10, indices))
+  DREAM3D_REQUIRE(indices == QVector<int>({3, 7, 8}))
+
+  // The indices are sorted and each one is kept once
+  DREAM3D_REQUIRE(PipelineCheckpoints::ParseFilterIndices(" 7, 3,2-3 ", 10, indices))
+  DREAM3D_REQUIRE(indices == QVector<int>({2, 3, 7}))
+
+  DREAM3D_REQUIRE(PipelineCheckpoints::ParseFilterIndices("9", 10, indices))
+  DREAM3D_REQUIRE(indices == QVector<int>({9}))
+
+  DREAM3D_REQUIRE(!PipelineCheckpoints::ParseFilterIndices("10", 10, indices))
+  DREAM3D_REQUIRE(!PipelineCheckpoints::ParseFilterIndices("-1", 10, indices))
+  DREAM3D_REQUIRE(!PipelineCheckpoints::ParseFilterIndices("8-7", 10, indices))
+  DREAM3D_REQUIRE(!PipelineCheckpoints::ParseFilterIndices("1-2-3", 10, indices))
+  DREAM3D_REQUIRE(!PipelineCheckpoints::ParseFilterIndices("1,,2", 10, indices))
+  DREAM3D_REQUIRE(!PipelineCheckpoints::ParseFilterIndices("", 10, indices))
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//  Use test framework
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  int err = EXIT_SUCCESS;
+
+  DREAM3D_REGISTER_TEST(TestParseFilterIndices())
+
+  PRINT_TEST_SUMMARY();
+  return err;
+}
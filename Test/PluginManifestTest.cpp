@@ -0,0 +1,260 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include "SIMPLib/Utilities/UnitTestSupport.hpp"
+
+#include "SIMPLView/PluginManifest.h"
+
+#include "SIMPLViewTestFileLocations.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool writeTestFile(const QString& filePath, const QByteArray& contents)
+{
+  QFile file(filePath);
+  if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    return false;
+  }
+  return file.write(contents) == contents.size();
+}
+
+// -----------------------------------------------------------------------------
+// Moves the recorded modification time of every plugin, as if the files had been
+// copied or re-installed since the manifest was written
+// -----------------------------------------------------------------------------
+bool shiftRecordedTimes(const QString& manifestFile, qint64 offsetMs)
+{
+  QFile file(manifestFile);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return false;
+  }
+  QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+  file.close();
+
+  QJsonArray plugins = root["Plugins"].toArray();
+  for(int i = 0; i < plugins.size(); i++)
+  {
+    QJsonObject plugin = plugins[i].toObject();
+    plugin["LastModified"] = plugin["LastModified"].toDouble() - offsetMs;
+    plugins[i] = plugin;
+  }
+  root["Plugins"] = plugins;
+  return writeTestFile(manifestFile, QJsonDocument(root).toJson());
+}
+
+// -----------------------------------------------------------------------------
+// Makes the manifest look as if another build of SIMPLView had written it
+// -----------------------------------------------------------------------------
+bool setRecordedVersion(const QString& manifestFile, const QString& version)
+{
+  QFile file(manifestFile);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return false;
+  }
+  QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+  file.close();
+
+  root["ApplicationVersion"] = version;
+  return writeTestFile(manifestFile, QJsonDocument(root).toJson());
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void RemoveTestFiles()
+{
+#if REMOVE_TEST_FILES
+  QDir(UnitTest::PluginManifestTest::TestDir).removeRecursively();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int WriteManifest()
+{
+  RemoveTestFiles();
+  DREAM3D_REQUIRE(QDir().mkpath(UnitTest::PluginManifestTest::TestDir))
+  DREAM3D_REQUIRE(writeTestFile(UnitTest::PluginManifestTest::PluginFile, "plugin contents"))
+
+  PluginManifest::FilterEntry filter;
+  filter.className = "TestFilter";
+  filter.uuid = QUuid("{8ac1cd5c-8d32-5ab6-b9c4-ae4d7e4b9a2f}");
+  filter.humanLabel = "Test Filter";
+
+  PluginManifest manifest;
+  manifest.updateEntry(UnitTest::PluginManifestTest::PluginFile, "TestPlugin", {filter}, true);
+  DREAM3D_REQUIRE(manifest.contains(UnitTest::PluginManifestTest::PluginFile))
+  DREAM3D_REQUIRE(manifest.isCurrent(UnitTest::PluginManifestTest::PluginFile))
+  DREAM3D_REQUIRE(manifest.isDirty())
+  DREAM3D_REQUIRE(manifest.writeFile(UnitTest::PluginManifestTest::ManifestFile))
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestReadManifest()
+{
+  DREAM3D_REQUIRE_EQUAL(WriteManifest(), EXIT_SUCCESS)
+
+  PluginManifest manifest;
+  DREAM3D_REQUIRE(manifest.readFile(UnitTest::PluginManifestTest::ManifestFile))
+  DREAM3D_REQUIRE(manifest.isCurrent(UnitTest::PluginManifestTest::PluginFile))
+  DREAM3D_REQUIRE(!manifest.isDirty())
+
+  PluginManifest::PluginEntry entry = manifest.getEntry(UnitTest::PluginManifestTest::PluginFile);
+  DREAM3D_REQUIRE(entry.pluginName == "TestPlugin")
+  DREAM3D_REQUIRE(entry.filtersKnown)
+  DREAM3D_REQUIRE_EQUAL(entry.filters.size(), 1)
+  DREAM3D_REQUIRE(entry.filters[0].className == "TestFilter")
+  DREAM3D_REQUIRE(entry.filters[0].uuid == QUuid("{8ac1cd5c-8d32-5ab6-b9c4-ae4d7e4b9a2f}"))
+  DREAM3D_REQUIRE(entry.sha1 == PluginManifest::ComputeHash(UnitTest::PluginManifestTest::PluginFile))
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+// A new time stamp with the same contents keeps the entry and only updates the time
+// -----------------------------------------------------------------------------
+int TestTouchedPluginIsCurrent()
+{
+  DREAM3D_REQUIRE_EQUAL(WriteManifest(), EXIT_SUCCESS)
+  DREAM3D_REQUIRE(shiftRecordedTimes(UnitTest::PluginManifestTest::ManifestFile, 60000))
+
+  PluginManifest manifest;
+  DREAM3D_REQUIRE(manifest.readFile(UnitTest::PluginManifestTest::ManifestFile))
+  DREAM3D_REQUIRE(manifest.isCurrent(UnitTest::PluginManifestTest::PluginFile))
+  DREAM3D_REQUIRE(manifest.isDirty())
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestChangedPluginIsStale()
+{
+  // Same size, new contents and a new time stamp
+  DREAM3D_REQUIRE_EQUAL(WriteManifest(), EXIT_SUCCESS)
+  DREAM3D_REQUIRE(shiftRecordedTimes(UnitTest::PluginManifestTest::ManifestFile, 60000))
+  DREAM3D_REQUIRE(writeTestFile(UnitTest::PluginManifestTest::PluginFile, "PLUGIN CONTENTS"))
+  {
+    PluginManifest manifest;
+    DREAM3D_REQUIRE(manifest.readFile(UnitTest::PluginManifestTest::ManifestFile))
+    DREAM3D_REQUIRE(!manifest.isCurrent(UnitTest::PluginManifestTest::PluginFile))
+  }
+
+  // A new size is stale whatever the time stamp says
+  DREAM3D_REQUIRE_EQUAL(WriteManifest(), EXIT_SUCCESS)
+  DREAM3D_REQUIRE(writeTestFile(UnitTest::PluginManifestTest::PluginFile, "longer plugin contents"))
+  {
+    PluginManifest manifest;
+    DREAM3D_REQUIRE(manifest.readFile(UnitTest::PluginManifestTest::ManifestFile))
+    DREAM3D_REQUIRE(!manifest.isCurrent(UnitTest::PluginManifestTest::PluginFile))
+  }
+
+  // And so is a plugin that is gone
+  DREAM3D_REQUIRE_EQUAL(WriteManifest(), EXIT_SUCCESS)
+  DREAM3D_REQUIRE(QFile::remove(UnitTest::PluginManifestTest::PluginFile))
+  {
+    PluginManifest manifest;
+    DREAM3D_REQUIRE(manifest.readFile(UnitTest::PluginManifestTest::ManifestFile))
+    DREAM3D_REQUIRE(!manifest.isCurrent(UnitTest::PluginManifestTest::PluginFile))
+  }
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestOtherVersionIsIgnored()
+{
+  DREAM3D_REQUIRE_EQUAL(WriteManifest(), EXIT_SUCCESS)
+  DREAM3D_REQUIRE(setRecordedVersion(UnitTest::PluginManifestTest::ManifestFile, "0.0.0.0"))
+
+  PluginManifest manifest;
+  DREAM3D_REQUIRE(!manifest.readFile(UnitTest::PluginManifestTest::ManifestFile))
+  DREAM3D_REQUIRE(!manifest.contains(UnitTest::PluginManifestTest::PluginFile))
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestRemoveMissingEntries()
+{
+  DREAM3D_REQUIRE_EQUAL(WriteManifest(), EXIT_SUCCESS)
+
+  PluginManifest manifest;
+  DREAM3D_REQUIRE(manifest.readFile(UnitTest::PluginManifestTest::ManifestFile))
+  manifest.removeMissingEntries(QStringList() << UnitTest::PluginManifestTest::PluginFile);
+  DREAM3D_REQUIRE(manifest.contains(UnitTest::PluginManifestTest::PluginFile))
+  DREAM3D_REQUIRE(!manifest.isDirty())
+
+  manifest.removeMissingEntries(QStringList());
+  DREAM3D_REQUIRE(!manifest.contains(UnitTest::PluginManifestTest::PluginFile))
+  DREAM3D_REQUIRE(manifest.isDirty())
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//  Use test framework
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  int err = EXIT_SUCCESS;
+
+  DREAM3D_REGISTER_TEST(TestReadManifest())
+  DREAM3D_REGISTER_TEST(TestTouchedPluginIsCurrent())
+  DREAM3D_REGISTER_TEST(TestChangedPluginIsStale())
+  DREAM3D_REGISTER_TEST(TestOtherVersionIsIgnored())
+  DREAM3D_REGISTER_TEST(TestRemoveMissingEntries())
+
+  DREAM3D_REGISTER_TEST(RemoveTestFiles())
+  PRINT_TEST_SUMMARY();
+  return err;
+}
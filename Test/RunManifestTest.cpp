@@ -0,0 +1,253 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include "SIMPLib/Utilities/UnitTestSupport.hpp"
+
+#include "SIMPLView/RunManifest.h"
+
+#include "SIMPLViewTestFileLocations.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool writeTestFile(const QString& filePath, const QByteArray& contents)
+{
+  QFile file(filePath);
+  if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    return false;
+  }
+  return file.write(contents) == contents.size();
+}
+
+// -----------------------------------------------------------------------------
+// A reader of the input file followed by a writer of the output file
+// -----------------------------------------------------------------------------
+bool writePipeline(const QJsonObject& readerParameters)
+{
+  QJsonObject reader = readerParameters;
+  reader["Filter_Name"] = QString("ReadAngData");
+
+  QJsonObject writer;
+  writer["Filter_Name"] = QString("DataContainerWriter");
+  writer["OutputFile"] = UnitTest::RunManifestTest::OutputFile;
+  writer["WriteXdmfFile"] = 1;
+
+  QJsonObject builder;
+  builder["Name"] = QString("RunManifestTest");
+  builder["Number_Filters"] = 2;
+
+  QJsonObject root;
+  root["0"] = reader;
+  root["1"] = writer;
+  root["PipelineBuilder"] = builder;
+  return writeTestFile(UnitTest::RunManifestTest::PipelineFile, QJsonDocument(root).toJson());
+}
+
+// -----------------------------------------------------------------------------
+// Records a successful run of the test pipeline and reads the record back
+// -----------------------------------------------------------------------------
+bool recordRun(RunManifest& recorded)
+{
+  RunManifest manifest = RunManifest::Capture(UnitTest::RunManifestTest::PipelineFile, QJsonObject(), true);
+  return manifest.writeFile(UnitTest::RunManifestTest::ManifestFile) && recorded.readFile(UnitTest::RunManifestTest::ManifestFile);
+}
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void RemoveTestFiles()
+{
+#if REMOVE_TEST_FILES
+  QDir(UnitTest::RunManifestTest::TestDir).removeRecursively();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int CreateTestFiles()
+{
+  RemoveTestFiles();
+  DREAM3D_REQUIRE(QDir().mkpath(UnitTest::RunManifestTest::InputDir))
+  DREAM3D_REQUIRE(writeTestFile(UnitTest::RunManifestTest::InputFile, "# TEM_PIXperUM 1.0"))
+  DREAM3D_REQUIRE(writeTestFile(UnitTest::RunManifestTest::OutputFile, "HDF5"))
+
+  QJsonObject reader;
+  reader["InputFile"] = UnitTest::RunManifestTest::InputFile;
+  reader["DataContainerName"] = QString("ImageDataContainer");
+  DREAM3D_REQUIRE(writePipeline(reader))
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestCollectPaths()
+{
+  DREAM3D_REQUIRE_EQUAL(CreateTestFiles(), EXIT_SUCCESS)
+
+  // Names that are not paths are left alone, even with "File" in the parameter name
+  {
+    QJsonObject parameters;
+    parameters["InputFile"] = UnitTest::RunManifestTest::InputFile;
+    parameters["OutputFile"] = UnitTest::RunManifestTest::OutputFile;
+    parameters["DataContainerName"] = QString("ImageDataContainer");
+    parameters["FileExtension"] = QString(".ang");
+    QStringList inputs;
+    QStringList outputs;
+    DREAM3D_REQUIRE(RunManifest::CollectPaths(parameters, inputs, outputs))
+    DREAM3D_REQUIRE(inputs == QStringList() << UnitTest::RunManifestTest::InputFile)
+    DREAM3D_REQUIRE(outputs == QStringList() << UnitTest::RunManifestTest::OutputFile)
+  }
+
+  // File lists keep their directory one level down, and a directory stands for its files
+  {
+    QJsonObject fileList;
+    fileList["InputPath"] = UnitTest::RunManifestTest::InputDir;
+    QJsonObject parameters;
+    parameters["InputFileListInfo"] = fileList;
+    QStringList inputs;
+    QStringList outputs;
+    DREAM3D_REQUIRE(RunManifest::CollectPaths(parameters, inputs, outputs))
+    DREAM3D_REQUIRE(inputs == QStringList() << UnitTest::RunManifestTest::InputFile)
+    DREAM3D_REQUIRE(outputs.isEmpty())
+  }
+
+  // An existing file that is neither an input nor an output
+  {
+    QJsonObject parameters;
+    parameters["ReferenceFile"] = UnitTest::RunManifestTest::InputFile;
+    QStringList inputs;
+    QStringList outputs;
+    DREAM3D_REQUIRE(!RunManifest::CollectPaths(parameters, inputs, outputs))
+  }
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestUnchangedRunIsCurrent()
+{
+  DREAM3D_REQUIRE_EQUAL(CreateTestFiles(), EXIT_SUCCESS)
+
+  RunManifest recorded;
+  DREAM3D_REQUIRE(recordRun(recorded))
+  QString change = recorded.findChange(RunManifest::Capture(UnitTest::RunManifestTest::PipelineFile, QJsonObject(), false));
+  DREAM3D_REQUIRE(change.isEmpty())
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TestFindChange()
+{
+  // Other parameters
+  {
+    DREAM3D_REQUIRE_EQUAL(CreateTestFiles(), EXIT_SUCCESS)
+    RunManifest recorded;
+    DREAM3D_REQUIRE(recordRun(recorded))
+
+    QJsonObject writer;
+    writer["WriteXdmfFile"] = 0;
+    QJsonObject overrides;
+    overrides["1"] = writer;
+    QString change = recorded.findChange(RunManifest::Capture(UnitTest::RunManifestTest::PipelineFile, overrides, false));
+    DREAM3D_REQUIRE(change == "The pipeline changed")
+  }
+
+  // A different input
+  {
+    DREAM3D_REQUIRE_EQUAL(CreateTestFiles(), EXIT_SUCCESS)
+    RunManifest recorded;
+    DREAM3D_REQUIRE(recordRun(recorded))
+
+    DREAM3D_REQUIRE(writeTestFile(UnitTest::RunManifestTest::InputFile, "# TEM_PIXperUM 1.0\n# x-star 0.5"))
+    QString change = recorded.findChange(RunManifest::Capture(UnitTest::RunManifestTest::PipelineFile, QJsonObject(), false));
+    DREAM3D_REQUIRE(change.startsWith("The input") && change.endsWith("changed"))
+  }
+
+  // A deleted output
+  {
+    DREAM3D_REQUIRE_EQUAL(CreateTestFiles(), EXIT_SUCCESS)
+    RunManifest recorded;
+    DREAM3D_REQUIRE(recordRun(recorded))
+
+    DREAM3D_REQUIRE(QFile::remove(UnitTest::RunManifestTest::OutputFile))
+    QString change = recorded.findChange(RunManifest::Capture(UnitTest::RunManifestTest::PipelineFile, QJsonObject(), false));
+    DREAM3D_REQUIRE(change.startsWith("The output") && change.endsWith("is missing"))
+  }
+
+  // A pipeline whose paths cannot be told apart always runs
+  {
+    DREAM3D_REQUIRE_EQUAL(CreateTestFiles(), EXIT_SUCCESS)
+    QJsonObject reader;
+    reader["InputFile"] = UnitTest::RunManifestTest::InputFile;
+    reader["ReferenceFile"] = UnitTest::RunManifestTest::InputFile;
+    DREAM3D_REQUIRE(writePipeline(reader))
+    RunManifest recorded;
+    DREAM3D_REQUIRE(recordRun(recorded))
+
+    QString change = recorded.findChange(RunManifest::Capture(UnitTest::RunManifestTest::PipelineFile, QJsonObject(), false));
+    DREAM3D_REQUIRE(change == "The inputs of the pipeline are not known")
+  }
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//  Use test framework
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  int err = EXIT_SUCCESS;
+
+  DREAM3D_REGISTER_TEST(TestCollectPaths())
+  DREAM3D_REGISTER_TEST(TestUnchangedRunIsCurrent())
+  DREAM3D_REGISTER_TEST(TestFindChange())
+
+  DREAM3D_REGISTER_TEST(RemoveTestFiles())
+  PRINT_TEST_SUMMARY();
+  return err;
+}